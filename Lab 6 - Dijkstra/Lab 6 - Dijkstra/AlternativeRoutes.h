@@ -0,0 +1,458 @@
+/*************************************************************
+* Filename:		AlternativeRoutes.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Alternatives to the shortest route, for when a road closes.
+*
+*	KShortestRoutes() is Yen's algorithm for the k shortest
+*	loopless routes. Routes are told apart by their edges, so two
+*	parallel roads between the same places give two routes through
+*	the same stops. Three things keep it well under k full
+*	searches:
+*		- One full search from the end gives every vertex's exact
+*		  cost to the end. Spur searches use it as an A* potential,
+*		  so they walk almost straight to the end.
+*		- When the shortest way from a spur vertex to the end
+*		  (read off that same search) avoids the root path and the
+*		  blocked edges, it is used as is, no search at all.
+*		- Spurs only start at or after the vertex where the
+*		  previous route left its parent (Lawler), the earlier ones
+*		  were already tried.
+*
+*	AlternativesByPenalty() is the cheaper heuristic: search, make
+*	the edges of the route found more expensive, search again, and
+*	keep the routes that are new and not too much longer than the
+*	best. Every search is the same A* on the raised weights.
+*
+*	Both run in a SearchWorkspace and take costs from a per edge
+*	weight array (miles, or TravelTimeModel::EdgeSeconds()). The
+*	graph must be two way with equal weights both ways, as every
+*	graph built by Graph::AddEdge or CompactGraph::Build is, since
+*	the search from the end runs on the same edges.
+**************************************************************/
+#include <vector>
+#include <algorithm>
+#include "CompactGraph.h"
+#include "SearchWorkspace.h"
+#include "SearchStats.h"
+#include "Exception.h"
+using std::vector;
+
+#pragma once
+#ifndef ALTERNATIVEROUTES_H
+#define ALTERNATIVEROUTES_H
+
+struct AlternativeRoute
+{
+	int cost;				//Sum of the weights of edges
+	vector<int> vertices;	//Graph index of each stop, start to end
+	vector<int> edges;		//Edge id between each pair of stops
+	int deviation;			//Stop where it leaves the route it was spurred from
+};
+
+template <typename V, typename E>
+void KShortestRoutes(const CompactGraph<V, E> & graph, const int * weights, int source, int target, int k,
+	SearchWorkspace & workspace, vector<AlternativeRoute> & routes, SearchStats * stats = nullptr);	//Yen's k shortest loopless routes
+
+template <typename V, typename E>
+void AlternativesByPenalty(const CompactGraph<V, E> & graph, const int * weights, int source, int target, int count,
+	double penalty, double stretch, SearchWorkspace & workspace, vector<AlternativeRoute> & routes,
+	SearchStats * stats = nullptr);	//Routes found by raising the weights of used edges
+
+template <typename V, typename E>
+void CostsToTarget(const CompactGraph<V, E> & graph, const int * weights, int target, SearchWorkspace & workspace,
+	vector<int> & cost, SearchStats & counts);	//Cost from every vertex to target
+
+template <typename V, typename E>
+int SearchWithPotential(const CompactGraph<V, E> & graph, const int * weights, int source, int target,
+	const vector<int> & potential, const char * blockedVertex, const char * blockedEdge,
+	SearchWorkspace & workspace, AlternativeRoute & route, SearchStats & counts);	//A* that avoids blocked vertices and edges
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function finds the cost from every vertex to target with
+*		   a full search from target, which on a two way graph with
+*		   equal weights both ways is the same thing.
+*
+* Precondition:	target is a valid index of graph.
+*
+* Postcondition: cost holds one entry per vertex, INFINITE_DISTANCE for
+*				 vertices that can't reach target.
+************************************************************************/
+template<typename V, typename E>
+void CostsToTarget(const CompactGraph<V, E> & graph, const int * weights, int target, SearchWorkspace & workspace,
+	vector<int> & cost, SearchStats & counts)
+{
+	const int * targets = graph.GetTargets();
+	RadixHeap<int> & heap = workspace.GetQueue();
+
+	workspace.Prepare(graph.GetVertexCount());
+	cost.assign(graph.GetVertexCount(), INFINITE_DISTANCE);
+	cost[target] = 0;
+	heap.Push(0, target);
+	STATS_ADD(counts.pushes, 1);
+
+	while (!heap.IsEmpty())
+	{
+		int dist = heap.GetTopKey();
+		int current = heap.GetTopVertex();
+		heap.Pop();
+		STATS_ADD(counts.pops, 1);
+
+		if (dist == cost[current])
+		{
+			STATS_ADD(counts.settled, 1);
+			STATS_ADD(counts.relaxed, graph.GetEdgeEnd(current) - graph.GetEdgeBegin(current));
+			for (int edge = graph.GetEdgeBegin(current); edge != graph.GetEdgeEnd(current); ++edge)
+			{
+				int to = targets[edge];
+				if (dist + weights[edge] < cost[to])
+				{
+					cost[to] = dist + weights[edge];
+					heap.Push(cost[to], to);
+					STATS_ADD(counts.pushes, 1);
+				}
+			}
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function finds the cheapest route from source to target
+*		   that uses no blocked vertex or edge. It is A* with potential
+*		   as the estimate: with the exact costs to target on weights no
+*		   higher than these, it settles little more than the route.
+*		   Between two stops the cheapest unblocked edge is used.
+*
+* Precondition:	potential[v] is at most the cost from v to target on
+*				weights, and potential[u] <= weight(u, v) + potential[v]
+*				for every edge. Either blocked array may be nullptr.
+*
+* Postcondition: route holds the route and its cost, which is returned;
+*				 INFINITE_DISTANCE (and an empty route) if there is none.
+************************************************************************/
+template<typename V, typename E>
+int SearchWithPotential(const CompactGraph<V, E> & graph, const int * weights, int source, int target,
+	const vector<int> & potential, const char * blockedVertex, const char * blockedEdge,
+	SearchWorkspace & workspace, AlternativeRoute & route, SearchStats & counts)
+{
+	const int * targets = graph.GetTargets();
+	workspace.Prepare(graph.GetVertexCount());
+	int * distance = workspace.GetDistances();
+	int * pred = workspace.GetPreds();
+	char * done = workspace.GetDone();
+	RadixHeap<int> & heap = workspace.GetQueue();
+
+	route.cost = INFINITE_DISTANCE;
+	route.vertices.clear();
+	route.edges.clear();
+	if (potential[source] == INFINITE_DISTANCE)
+	{
+		return INFINITE_DISTANCE;
+	}
+
+	workspace.Touch(source);
+	distance[source] = 0;
+	heap.Push(potential[source], source);
+	STATS_ADD(counts.pushes, 1);
+
+	while (!heap.IsEmpty() && !done[target])
+	{
+		int current = heap.GetTopVertex();
+		heap.Pop();
+		STATS_ADD(counts.pops, 1);
+		if (done[current])
+		{
+			continue;	//Improved after it was pushed
+		}
+		done[current] = 1;
+		STATS_ADD(counts.settled, 1);
+		STATS_ADD(counts.relaxed, graph.GetEdgeEnd(current) - graph.GetEdgeBegin(current));
+
+		for (int edge = graph.GetEdgeBegin(current); edge != graph.GetEdgeEnd(current); ++edge)
+		{
+			int to = targets[edge];
+			int cost = distance[current] + weights[edge];
+			if ((blockedEdge == nullptr || !blockedEdge[edge]) && (blockedVertex == nullptr || !blockedVertex[to])
+				&& potential[to] != INFINITE_DISTANCE && cost < distance[to])
+			{
+				if (distance[to] == INFINITE_DISTANCE)
+				{
+					workspace.Touch(to);
+				}
+				distance[to] = cost;
+				pred[to] = current;
+				heap.Push(cost + potential[to], to);
+				STATS_ADD(counts.pushes, 1);
+			}
+		}
+	}
+	heap.Clear();
+
+	if (!done[target])
+	{
+		return INFINITE_DISTANCE;
+	}
+	for (int vertex = target; vertex != NO_VERTEX; vertex = pred[vertex])
+	{
+		route.vertices.push_back(vertex);
+	}
+	std::reverse(route.vertices.begin(), route.vertices.end());
+	for (size_t i = 0; i + 1 < route.vertices.size(); i++)
+	{
+		int best = NO_VERTEX;
+		for (int edge = graph.GetEdgeBegin(route.vertices[i]); edge != graph.GetEdgeEnd(route.vertices[i]); ++edge)
+		{
+			if (targets[edge] == route.vertices[i + 1] && (blockedEdge == nullptr || !blockedEdge[edge])
+				&& (best == NO_VERTEX || weights[edge] < weights[best]))
+			{
+				best = edge;
+			}
+		}
+		route.edges.push_back(best);
+	}
+	route.cost = distance[target];
+	route.deviation = 0;
+	return route.cost;
+}
+
+/**********************************************************************
+* Purpose: This function finds up to k shortest loopless routes from
+*		   source to target, cheapest first (Yen's algorithm, with the
+*		   speedups in the overview).
+*
+* Precondition:	weights holds one cost of 0 or more per edge id, the same
+*				both ways along every road.
+*
+* Postcondition: routes holds the routes found, fewer than k if there are
+*				 no more. Throws if source or target is not in the graph.
+************************************************************************/
+template<typename V, typename E>
+void KShortestRoutes(const CompactGraph<V, E> & graph, const int * weights, int source, int target, int k,
+	SearchWorkspace & workspace, vector<AlternativeRoute> & routes, SearchStats * stats)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (target < 0 || target >= graph.GetVertexCount())
+	{
+		throw Exception("Ending vertex is not in the graph!");
+	}
+
+	const int * targets = graph.GetTargets();
+	vector<int> toTarget;						//Cost from each vertex to target
+	vector<char> blockedVertex(graph.GetVertexCount(), 0);
+	vector<char> blockedEdge(graph.GetEdgeCount(), 0);
+	vector<AlternativeRoute> candidates;		//Found but not yet accepted
+	AlternativeRoute spur;
+	SearchStats counts;
+	counts.searchSeconds -= StatsClock();
+
+	routes.clear();
+	CostsToTarget(graph, weights, target, workspace, toTarget, counts);
+	if (k > 0 && toTarget[source] != INFINITE_DISTANCE)
+	{
+		AlternativeRoute first;
+		SearchWithPotential(graph, weights, source, target, toTarget, nullptr, nullptr, workspace, first, counts);
+		routes.push_back(first);
+	}
+
+	while (static_cast<int>(routes.size()) < k && !routes.empty())
+	{
+		const AlternativeRoute & last = routes.back();
+		int rootCost = 0;
+
+		for (int i = 0; i < last.deviation; i++)
+		{
+			rootCost += weights[last.edges[i]];
+		}
+		for (int i = last.deviation; i + 1 < static_cast<int>(last.vertices.size()); i++)
+		{
+			int from = last.vertices[i];
+			bool direct = true;
+
+			//Block the next edge of every accepted route with this root, and the root itself
+			for (size_t r = 0; r < routes.size(); r++)
+			{
+				if (static_cast<int>(routes[r].edges.size()) > i
+					&& std::equal(last.edges.begin(), last.edges.begin() + i, routes[r].edges.begin()))
+				{
+					blockedEdge[routes[r].edges[i]] = 1;
+				}
+			}
+			for (int j = 0; j < i; j++)
+			{
+				blockedVertex[last.vertices[j]] = 1;
+			}
+
+			//Follow the cheapest way to target while it steers clear of everything blocked
+			spur.vertices.assign(1, from);
+			spur.edges.clear();
+			for (int vertex = from; direct && vertex != target; )
+			{
+				int next = NO_VERTEX;
+				for (int edge = graph.GetEdgeBegin(vertex); next == NO_VERTEX && edge != graph.GetEdgeEnd(vertex); ++edge)
+				{
+					if (toTarget[targets[edge]] != INFINITE_DISTANCE && weights[edge] + toTarget[targets[edge]] == toTarget[vertex]
+						&& (weights[edge] > 0 || targets[edge] == target))	//Zero weight steps could circle
+					{
+						next = edge;
+					}
+				}
+				direct = next != NO_VERTEX && !blockedEdge[next] && !blockedVertex[targets[next]];
+				if (direct)
+				{
+					spur.edges.push_back(next);
+					vertex = targets[next];
+					spur.vertices.push_back(vertex);
+				}
+			}
+			if (direct)
+			{
+				spur.cost = toTarget[from];
+			}
+			else
+			{
+				SearchWithPotential(graph, weights, from, target, toTarget, blockedVertex.data(), blockedEdge.data(), workspace, spur, counts);
+			}
+
+			if (spur.cost != INFINITE_DISTANCE)
+			{
+				AlternativeRoute found;
+				found.cost = rootCost + spur.cost;
+				found.deviation = i;
+				found.vertices.insert(found.vertices.end(), last.vertices.begin(), last.vertices.begin() + i);
+				found.vertices.insert(found.vertices.end(), spur.vertices.begin(), spur.vertices.end());
+				found.edges.insert(found.edges.end(), last.edges.begin(), last.edges.begin() + i);
+				found.edges.insert(found.edges.end(), spur.edges.begin(), spur.edges.end());
+
+				bool seen = false;
+				for (size_t c = 0; !seen && c < candidates.size(); c++)
+				{
+					seen = candidates[c].edges == found.edges;
+				}
+				if (!seen)
+				{
+					candidates.push_back(found);
+				}
+			}
+
+			for (size_t r = 0; r < routes.size(); r++)	//Unblock for the next spur
+			{
+				if (static_cast<int>(routes[r].edges.size()) > i)
+				{
+					blockedEdge[routes[r].edges[i]] = 0;
+				}
+			}
+			for (int j = 0; j < i; j++)
+			{
+				blockedVertex[last.vertices[j]] = 0;
+			}
+			rootCost += weights[last.edges[i]];
+		}
+
+		if (candidates.empty())
+		{
+			break;
+		}
+		size_t best = 0;
+		for (size_t c = 1; c < candidates.size(); c++)
+		{
+			if (candidates[c].cost < candidates[best].cost
+				|| (candidates[c].cost == candidates[best].cost && candidates[c].vertices.size() < candidates[best].vertices.size()))
+			{
+				best = c;
+			}
+		}
+		routes.push_back(candidates[best]);
+		candidates.erase(candidates.begin() + best);
+	}
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.searchSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+}
+
+/**********************************************************************
+* Purpose: This function finds up to count different routes from source
+*		   to target by the penalty method: after each search the edges
+*		   of the route found cost weight * penalty more (at least 1
+*		   more, so zero weight edges are raised too), and the search
+*		   is run again. A route is kept when it is new and its real cost
+*		   is at most stretch times the shortest. It gives up after
+*		   3 * count searches.
+*
+* Precondition:	weights holds one cost of 0 or more per edge id, the same
+*				both ways along every road. penalty > 0, stretch >= 1.
+*
+* Postcondition: routes holds the routes found, the shortest first, with
+*				 their costs on the real weights. Throws if source or
+*				 target is not in the graph.
+************************************************************************/
+template<typename V, typename E>
+void AlternativesByPenalty(const CompactGraph<V, E> & graph, const int * weights, int source, int target, int count,
+	double penalty, double stretch, SearchWorkspace & workspace, vector<AlternativeRoute> & routes, SearchStats * stats)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (target < 0 || target >= graph.GetVertexCount())
+	{
+		throw Exception("Ending vertex is not in the graph!");
+	}
+
+	vector<int> toTarget;	//Exact on weights, and never too high on the raised weights
+	vector<int> raised(weights, weights + graph.GetEdgeCount());
+	AlternativeRoute found;
+	SearchStats counts;
+	counts.searchSeconds -= StatsClock();
+
+	routes.clear();
+	CostsToTarget(graph, weights, target, workspace, toTarget, counts);
+
+	for (int tries = 0; tries < 3 * count && static_cast<int>(routes.size()) < count; tries++)
+	{
+		if (SearchWithPotential(graph, raised.data(), source, target, toTarget, nullptr, nullptr, workspace, found, counts) == INFINITE_DISTANCE)
+		{
+			break;
+		}
+
+		found.cost = 0;
+		for (size_t i = 0; i < found.edges.size(); i++)
+		{
+			found.cost += weights[found.edges[i]];
+			int raise = static_cast<int>(weights[found.edges[i]] * penalty + 0.5);
+			raised[found.edges[i]] += raise > 1 ? raise : 1;	//Zero weight edges would never stop repeating the route
+		}
+
+		bool seen = false;
+		for (size_t r = 0; !seen && r < routes.size(); r++)
+		{
+			seen = routes[r].edges == found.edges;
+		}
+		if (!seen && (routes.empty() || found.cost <= routes[0].cost * stretch))
+		{
+			routes.push_back(found);
+		}
+	}
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.searchSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+}
+#endif
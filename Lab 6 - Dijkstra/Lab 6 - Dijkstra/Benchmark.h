@@ -0,0 +1,325 @@
+/************************************************************************
+* Class: BenchmarkSuite
+*
+* Purpose: This class times named pieces of work, counts the heap
+*		   allocations they make, and reports the results as a table or
+*		   as JSON so runs from different commits can be compared.
+*		   Allocations are only counted when the program replaces
+*		   operator new to call CountAllocation() (bench.cpp does).
+*
+* Manager functions
+*	BenchmarkSuite(double min_seconds)
+*		Sets how long each benchmark is repeated for at least.
+*	~BenchmarkSuite()
+*		Clears the results.
+*
+* Methods:
+*	Run(const string & name, long long ops, Func func)
+*		Calls func repeatedly; each call does ops operations.
+*	Run(const string & name, long long ops, Setup setup, Func func)
+*		Same, but setup runs before every call and is not timed.
+*	Compare(const string & name, const string & baseline)
+*		Records how many times faster name ran than baseline.
+*	Print(ostream & out)
+*		Writes the results as a table.
+*	WriteJson(ostream & out, const string & label, unsigned seed)
+*		Writes the results as one JSON object.
+*	PeakRssKb()
+*		Returns the peak resident set size of the process.
+*************************************************************************/
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#undef GetMessage	//windows.h renames it, which breaks Exception::GetMessage
+#else
+#include <sys/resource.h>
+#endif
+using std::string;
+using std::vector;
+using std::atomic;
+using std::ostream;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+#pragma once
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+struct BenchmarkResult
+{
+	string name;
+	long long iterations;		//Operations timed in total
+	double ns_per_op;
+	double ops_per_sec;
+	double allocations_per_op;
+	double bytes_per_op;
+	double speedup;				//Baseline ns/op over this one's, 0 if not compared
+};
+
+void CountAllocation(size_t bytes);	//Called by a replaced operator new
+long long GetAllocationCount();
+long long GetAllocatedBytes();
+
+class BenchmarkSuite
+{
+public:
+	BenchmarkSuite(double min_seconds);
+	~BenchmarkSuite();
+
+	template <typename Func>
+	void Run(const string & name, long long ops, Func func);
+	template <typename Setup, typename Func>
+	void Run(const string & name, long long ops, Setup setup, Func func);
+	void Compare(const string & name, const string & baseline);
+	void Print(ostream & out) const;
+	void WriteJson(ostream & out, const string & label, unsigned seed) const;
+	static long long PeakRssKb();
+
+private:
+	double m_minSeconds;				//Each benchmark repeats until this much time has passed
+	vector<BenchmarkResult> m_results;
+};
+#endif
+
+/**********************************************************************
+* Purpose: These functions hold the allocation counters. They live in
+*		   functions so they are ready before any static constructor
+*		   allocates.
+*
+* Precondition:	N/A
+*
+* Postcondition: The counters are updated / returned.
+************************************************************************/
+inline atomic<long long> & AllocationCounter()
+{
+	static atomic<long long> count(0);
+	return count;
+}
+
+inline atomic<long long> & AllocationBytes()
+{
+	static atomic<long long> bytes(0);
+	return bytes;
+}
+
+inline void CountAllocation(size_t bytes)
+{
+	AllocationCounter().fetch_add(1, std::memory_order_relaxed);
+	AllocationBytes().fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed);
+}
+
+inline long long GetAllocationCount()
+{
+	return AllocationCounter().load(std::memory_order_relaxed);
+}
+
+inline long long GetAllocatedBytes()
+{
+	return AllocationBytes().load(std::memory_order_relaxed);
+}
+
+/**********************************************************************
+* Purpose: This function sets how long each benchmark is repeated for.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The suite is empty.
+************************************************************************/
+inline BenchmarkSuite::BenchmarkSuite(double min_seconds) : m_minSeconds(min_seconds)
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the results.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: The results are cleared.
+************************************************************************/
+inline BenchmarkSuite::~BenchmarkSuite()
+{
+	m_results.clear();
+}
+
+/**********************************************************************
+* Purpose: This function calls func until at least m_minSeconds have
+*		   passed (and at least once). Each call is counted as ops
+*		   operations, so ns/op is the time per single operation.
+*
+* Precondition:	ops >= 1
+*
+* Postcondition: A result is recorded under name.
+************************************************************************/
+template<typename Func>
+void BenchmarkSuite::Run(const string & name, long long ops, Func func)
+{
+	Run(name, ops, []() {}, func);
+}
+
+/**********************************************************************
+* Purpose: This function calls setup then func until func has taken at
+*		   least m_minSeconds in total. Only func is timed, and only its
+*		   allocations are counted.
+*
+* Precondition:	ops >= 1
+*
+* Postcondition: A result is recorded under name.
+************************************************************************/
+template<typename Setup, typename Func>
+void BenchmarkSuite::Run(const string & name, long long ops, Setup setup, Func func)
+{
+	long long rounds = 0;
+	long long allocations = 0;
+	long long bytes = 0;
+	double seconds = 0;
+
+	do
+	{
+		setup();
+		long long allocations_before = GetAllocationCount();
+		long long bytes_before = GetAllocatedBytes();
+		steady_clock::time_point start = steady_clock::now();
+
+		func();
+
+		seconds += duration<double>(steady_clock::now() - start).count();
+		allocations += GetAllocationCount() - allocations_before;
+		bytes += GetAllocatedBytes() - bytes_before;
+		rounds++;
+	} while (seconds < m_minSeconds);
+
+	BenchmarkResult result;
+	result.name = name;
+	result.iterations = rounds * ops;
+	result.ns_per_op = seconds * 1e9 / result.iterations;
+	result.ops_per_sec = result.iterations / seconds;
+	result.allocations_per_op = static_cast<double>(allocations) / result.iterations;
+	result.bytes_per_op = static_cast<double>(bytes) / result.iterations;
+	result.speedup = 0;
+	m_results.push_back(result);
+}
+
+/**********************************************************************
+* Purpose: This function records the speedup of one benchmark over
+*		   another that does the same work, such as a parallel engine
+*		   over the best sequential one.
+*
+* Precondition:	Both have been run.
+*
+* Postcondition: name's speedup is baseline's ns/op over its own.
+************************************************************************/
+inline void BenchmarkSuite::Compare(const string & name, const string & baseline)
+{
+	double baseline_ns = 0;
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		if (m_results[i].name == baseline)
+		{
+			baseline_ns = m_results[i].ns_per_op;
+		}
+	}
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		if (m_results[i].name == name && m_results[i].ns_per_op > 0)
+		{
+			m_results[i].speedup = baseline_ns / m_results[i].ns_per_op;
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function writes the results as a table. The speedup
+*		   column is only filled in for compared benchmarks.
+*
+* Precondition:	N/A
+*
+* Postcondition: The table is written to out.
+************************************************************************/
+inline void BenchmarkSuite::Print(ostream & out) const
+{
+	out << std::left << std::setw(36) << "benchmark" << std::right << std::setw(14) << "ns/op"
+		<< std::setw(16) << "ops/s" << std::setw(12) << "allocs/op" << std::setw(14) << "bytes/op" << std::setw(10) << "speedup" << '\n';
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		out << std::left << std::setw(36) << m_results[i].name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(14) << m_results[i].ns_per_op << std::setw(16) << m_results[i].ops_per_sec
+			<< std::setprecision(2) << std::setw(12) << m_results[i].allocations_per_op
+			<< std::setprecision(1) << std::setw(14) << m_results[i].bytes_per_op;
+		if (m_results[i].speedup > 0)
+		{
+			out << std::setprecision(2) << std::setw(9) << m_results[i].speedup << 'x';
+		}
+		out << '\n';
+	}
+	out << "peak RSS: " << PeakRssKb() << " KB\n";
+	out.flush();
+}
+
+/**********************************************************************
+* Purpose: This function writes the results as a single JSON object, with
+*		   label (for example a commit id) and the seed the graphs were
+*		   generated from, so two runs can be diffed by a script.
+*		   Compared benchmarks also carry their speedup.
+*
+* Precondition:	Benchmark names contain no quotes or backslashes.
+*
+* Postcondition: The JSON is written to out.
+************************************************************************/
+inline void BenchmarkSuite::WriteJson(ostream & out, const string & label, unsigned seed) const
+{
+	out << "{\"label\":\"" << label << "\",\"seed\":" << seed << ",\"peak_rss_kb\":" << PeakRssKb() << ",\"results\":[";
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		out << (i > 0 ? "," : "") << "{\"name\":\"" << m_results[i].name << "\""
+			<< ",\"iterations\":" << m_results[i].iterations
+			<< ",\"ns_per_op\":" << m_results[i].ns_per_op
+			<< ",\"ops_per_sec\":" << m_results[i].ops_per_sec
+			<< ",\"allocations_per_op\":" << m_results[i].allocations_per_op
+			<< ",\"bytes_per_op\":" << m_results[i].bytes_per_op;
+		if (m_results[i].speedup > 0)
+		{
+			out << ",\"speedup\":" << m_results[i].speedup;
+		}
+		out << "}";
+	}
+	out << "]}\n";
+	out.flush();
+}
+
+/**********************************************************************
+* Purpose: This function returns the peak resident set size.
+*
+* Precondition:	N/A
+*
+* Postcondition: The peak in kilobytes is returned, 0 if unknown.
+************************************************************************/
+inline long long BenchmarkSuite::PeakRssKb()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return static_cast<long long>(counters.PeakWorkingSetSize / 1024);
+	}
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;	//Bytes on macOS
+#else
+	return usage.ru_maxrss;			//Kilobytes on Linux
+#endif
+#endif
+}
@@ -0,0 +1,215 @@
+/************************************************************************
+* Class: BinaryHeap
+*
+* Purpose: This class is a min priority queue of (key, vertex) pairs built
+*		   on a binary heap. It works for any key type that can be
+*		   compared, and is what the search engines use for non integer
+*		   weights.
+*
+* Manager functions
+*	BinaryHeap()
+*		Creates an empty heap.
+*	~BinaryHeap()
+*		Clears the heap.
+*	BinaryHeap(const BinaryHeap<K> & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const BinaryHeap<K> & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Push(K key, int vertex)
+*		Adds vertex with priority key.
+*	Pop()
+*		Removes the smallest entry.
+*	GetTopKey() / GetTopVertex()
+*		Returns the smallest entry.
+*	IsEmpty()
+*		Returns whether or not the heap is empty.
+*	Clear()
+*		Removes every entry.
+*************************************************************************/
+#include <vector>
+#include <queue>
+#include <functional>
+#include <utility>
+#include "Exception.h"
+using std::vector;
+using std::priority_queue;
+using std::greater;
+using std::pair;
+using std::make_pair;
+
+#pragma once
+#ifndef BINARYHEAP_H
+#define BINARYHEAP_H
+
+template <typename K>
+class BinaryHeap
+{
+public:
+	BinaryHeap();
+	~BinaryHeap();
+	BinaryHeap(const BinaryHeap<K> & copy);
+	const BinaryHeap<K> & operator=(const BinaryHeap<K> & rhs);
+
+	void Push(K key, int vertex);
+	void Pop();
+	K GetTopKey() const;
+	int GetTopVertex() const;
+	bool IsEmpty() const;
+	void Clear();
+
+private:
+	priority_queue<pair<K, int>, vector<pair<K, int>>, greater<pair<K, int>>> m_heap;	//Smallest key on top
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty heap.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The heap is empty.
+************************************************************************/
+template<typename K>
+inline BinaryHeap<K>::BinaryHeap()
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the heap.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: The heap is empty.
+************************************************************************/
+template<typename K>
+inline BinaryHeap<K>::~BinaryHeap()
+{
+	Clear();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+template<typename K>
+inline BinaryHeap<K>::BinaryHeap(const BinaryHeap<K> & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+template<typename K>
+inline const BinaryHeap<K> & BinaryHeap<K>::operator=(const BinaryHeap<K> & rhs)
+{
+	if (this != &rhs)
+	{
+		m_heap = rhs.m_heap;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function adds vertex with priority key.
+*
+* Precondition:	N/A
+*
+* Postcondition: The entry is in the heap.
+************************************************************************/
+template<typename K>
+inline void BinaryHeap<K>::Push(K key, int vertex)
+{
+	m_heap.push(make_pair(key, vertex));
+}
+
+/**********************************************************************
+* Purpose: This function removes the smallest entry.
+*
+* Precondition:	N/A
+*
+* Postcondition: The smallest entry is removed; throws if the heap is
+*				 empty.
+************************************************************************/
+template<typename K>
+inline void BinaryHeap<K>::Pop()
+{
+	if (m_heap.empty())
+	{
+		throw Exception("Heap is empty");
+	}
+	m_heap.pop();
+}
+
+/**********************************************************************
+* Purpose: This function returns the smallest key.
+*
+* Precondition:	N/A
+*
+* Postcondition: The smallest key is returned; throws if the heap is
+*				 empty.
+************************************************************************/
+template<typename K>
+inline K BinaryHeap<K>::GetTopKey() const
+{
+	if (m_heap.empty())
+	{
+		throw Exception("Heap is empty");
+	}
+	return m_heap.top().first;
+}
+
+/**********************************************************************
+* Purpose: This function returns the vertex with the smallest key.
+*
+* Precondition:	N/A
+*
+* Postcondition: The vertex is returned; throws if the heap is empty.
+************************************************************************/
+template<typename K>
+inline int BinaryHeap<K>::GetTopVertex() const
+{
+	if (m_heap.empty())
+	{
+		throw Exception("Heap is empty");
+	}
+	return m_heap.top().second;
+}
+
+/**********************************************************************
+* Purpose: This function returns whether or not the heap is empty.
+*
+* Precondition:	N/A
+*
+* Postcondition: The empty status is returned.
+************************************************************************/
+template<typename K>
+inline bool BinaryHeap<K>::IsEmpty() const
+{
+	return m_heap.empty();
+}
+
+/**********************************************************************
+* Purpose: This function removes every entry.
+*
+* Precondition:	N/A
+*
+* Postcondition: The heap is empty.
+************************************************************************/
+template<typename K>
+inline void BinaryHeap<K>::Clear()
+{
+	while (!m_heap.empty())
+	{
+		m_heap.pop();
+	}
+}
@@ -0,0 +1,254 @@
+/************************************************************************
+* Class: Bitmap
+*
+* Purpose: This class is a fixed size array of bits, one per vertex, 64 to
+*		   a word. It is the visited set and frontier of the traversals:
+*		   eight times smaller than a vector<char> and, unlike the
+*		   m_processed flag on Graph's vertices, kept beside the graph
+*		   instead of in it, so a traversal never changes the graph.
+*
+* Manager functions
+*	Bitmap()
+*		Creates an empty bitmap.
+*	Bitmap(int size)
+*		Creates a bitmap of size bits, all clear.
+*	~Bitmap()
+*		Clears the words.
+*	Bitmap(const Bitmap & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const Bitmap & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Resize(int size)
+*		Makes the bitmap size bits, all clear.
+*	ClearAll()
+*		Clears every bit.
+*	Swap(Bitmap & other)
+*		Trades bits with other without copying them.
+*	Set(int index) / Reset(int index) / Test(int index)
+*		Sets, clears or reads one bit.
+*	GetSize()
+*		Returns the number of bits.
+*	GetWordCount() / GetWords()
+*		Returns the 64 bit words, for loops that go a word at a time.
+*	Count()
+*		Returns the number of set bits.
+*************************************************************************/
+#include <vector>
+#include <cstdint>
+#include <utility>
+using std::vector;
+
+#pragma once
+#ifndef BITMAP_H
+#define BITMAP_H
+
+class Bitmap
+{
+public:
+	Bitmap();
+	Bitmap(int size);
+	~Bitmap();
+	Bitmap(const Bitmap & copy);
+	Bitmap & operator=(const Bitmap & rhs);
+
+	void Resize(int size);
+	void ClearAll();
+	void Swap(Bitmap & other);
+	void Set(int index);
+	void Reset(int index);
+	bool Test(int index) const;
+	int GetSize() const;
+	int GetWordCount() const;
+	uint64_t * GetWords();
+	const uint64_t * GetWords() const;
+	int Count() const;
+
+private:
+	vector<uint64_t> m_words;	//Bit i is bit i % 64 of word i / 64
+	int m_size;					//Number of bits
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty bitmap.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The bitmap has no bits.
+************************************************************************/
+inline Bitmap::Bitmap() : m_size(0)
+{
+}
+
+/**********************************************************************
+* Purpose: This function creates a bitmap of size bits.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: Every bit is clear.
+************************************************************************/
+inline Bitmap::Bitmap(int size) : m_size(0)
+{
+	Resize(size);
+}
+
+/**********************************************************************
+* Purpose: This function clears the words.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: The bitmap is empty.
+************************************************************************/
+inline Bitmap::~Bitmap()
+{
+	m_words.clear();
+	m_size = 0;
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to copy the bitmap.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: This is a copy of copy.
+************************************************************************/
+inline Bitmap::Bitmap(const Bitmap & copy) : m_size(0)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function copies the bits of rhs.
+*
+* Precondition:	N/A
+*
+* Postcondition: This is a copy of rhs.
+************************************************************************/
+inline Bitmap & Bitmap::operator=(const Bitmap & rhs)
+{
+	if (this != &rhs)
+	{
+		m_words = rhs.m_words;
+		m_size = rhs.m_size;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function makes the bitmap size bits.
+*
+* Precondition:	size is 0 or more.
+*
+* Postcondition: Every bit is clear.
+************************************************************************/
+inline void Bitmap::Resize(int size)
+{
+	m_words.assign((size + 63) / 64, 0);
+	m_size = size;
+}
+
+/**********************************************************************
+* Purpose: This function clears every bit.
+*
+* Precondition:	N/A
+*
+* Postcondition: Every bit is clear.
+************************************************************************/
+inline void Bitmap::ClearAll()
+{
+	m_words.assign(m_words.size(), 0);
+}
+
+/**********************************************************************
+* Purpose: This function trades bits with other, for double buffered
+*		   frontiers.
+*
+* Precondition:	N/A
+*
+* Postcondition: This has other's bits and other has this's.
+************************************************************************/
+inline void Bitmap::Swap(Bitmap & other)
+{
+	m_words.swap(other.m_words);
+	std::swap(m_size, other.m_size);
+}
+
+/**********************************************************************
+* Purpose: These functions set, clear and read one bit. They are not
+*		   safe for two threads writing the same word.
+*
+* Precondition:	index is below GetSize().
+*
+* Postcondition: The bit is set / cleared / returned.
+************************************************************************/
+inline void Bitmap::Set(int index)
+{
+	m_words[index >> 6] |= uint64_t(1) << (index & 63);
+}
+
+inline void Bitmap::Reset(int index)
+{
+	m_words[index >> 6] &= ~(uint64_t(1) << (index & 63));
+}
+
+inline bool Bitmap::Test(int index) const
+{
+	return (m_words[index >> 6] >> (index & 63)) & 1;
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of bits.
+*
+* Precondition:	N/A
+*
+* Postcondition: The size is returned.
+************************************************************************/
+inline int Bitmap::GetSize() const
+{
+	return m_size;
+}
+
+/**********************************************************************
+* Purpose: These functions return the words. Bits past GetSize() in the
+*		   last word are always clear.
+*
+* Precondition:	N/A
+*
+* Postcondition: The word count / words are returned.
+************************************************************************/
+inline int Bitmap::GetWordCount() const
+{
+	return static_cast<int>(m_words.size());
+}
+
+inline uint64_t * Bitmap::GetWords()
+{
+	return m_words.empty() ? nullptr : &m_words[0];
+}
+
+inline const uint64_t * Bitmap::GetWords() const
+{
+	return m_words.empty() ? nullptr : &m_words[0];
+}
+
+/**********************************************************************
+* Purpose: This function counts the set bits.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int Bitmap::Count() const
+{
+	int count = 0;
+	for (size_t i = 0; i < m_words.size(); i++)
+	{
+		for (uint64_t word = m_words[i]; word != 0; word &= word - 1)
+		{
+			count++;
+		}
+	}
+	return count;
+}
@@ -0,0 +1,693 @@
+/************************************************************************
+* Class: CellOverlay
+*
+* Purpose: This class is a customizable route planning (CRP) overlay on a
+*		   MultilevelPartition. A vertex with an edge into another cell
+*		   of a level is a boundary vertex of its cell on that level, and
+*		   every cell keeps the shortest distance inside it between each
+*		   pair of its boundary vertices (a clique). A query only walks
+*		   the plain graph in the smallest cells of its start and end;
+*		   further out it jumps across whole cells, higher levels the
+*		   farther it is from both.
+*
+*		   Work is split in three phases:
+*			Build - which vertices are boundary vertices, where each
+*				clique lives. Depends only on the partition, so it is
+*				done once.
+*			Customize - fills the cliques for one metric (miles,
+*				minutes, a truck's weights): the smallest cells by
+*				searching inside them, each higher level by searching
+*				the cliques of the level below. Cells of a level are
+*				independent, so they are filled in parallel. Changing
+*				metric is only this phase. A clique entry that a path
+*				through another boundary vertex of the cell already
+*				matches is dropped, which leaves queries and higher
+*				levels fewer edges to relax.
+*			Route - a bidirectional Dijkstra over that multilevel
+*				graph, then every clique edge on the route is unpacked
+*				back into plain edges.
+*
+*		   The graph must be two way, so a clique is symmetric and the
+*		   backward search uses the same edges as the forward one.
+*
+* Manager functions
+*	CellOverlay()
+*		Creates an empty overlay.
+*	~CellOverlay()
+*		Clears the overlay.
+*	CellOverlay(const CellOverlay & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const CellOverlay & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Build(const CompactGraph<V, E> & graph, const MultilevelPartition & partition)
+*		Finds the boundary vertices of every cell and sizes the cliques.
+*	Customize(const CompactGraph<V, E> & graph, const int * weights, int threads)
+*		Fills every clique for one metric.
+*	Route(const CompactGraph<V, E> & graph, const int * weights, int source, int target,
+*		  SearchWorkspace & forward, SearchWorkspace & backward, vector<int> & path, SearchStats * stats)
+*		Finds the shortest route with the metric last customized.
+*	GetPartition()
+*		Returns the partition.
+*	GetBoundaryCount(int level)
+*		Returns the number of boundary vertices on a level.
+*	GetCliqueSize()
+*		Returns the number of clique entries over every level.
+*************************************************************************/
+#include <vector>
+#include <algorithm>
+#include "CompactGraph.h"
+#include "MultilevelPartition.h"
+#include "SearchWorkspace.h"
+#include "SearchStats.h"
+#include "Parallel.h"
+#include "Exception.h"
+using std::vector;
+
+#pragma once
+#ifndef CELLOVERLAY_H
+#define CELLOVERLAY_H
+
+class CellOverlay
+{
+public:
+	CellOverlay();
+	~CellOverlay();
+	CellOverlay(const CellOverlay & copy);
+	CellOverlay & operator=(const CellOverlay & rhs);
+
+	template <typename V, typename E>
+	void Build(const CompactGraph<V, E> & graph, const MultilevelPartition & partition);
+	template <typename V, typename E>
+	void Customize(const CompactGraph<V, E> & graph, const int * weights, int threads);
+	template <typename V, typename E>
+	int Route(const CompactGraph<V, E> & graph, const int * weights, int source, int target, SearchWorkspace & forward,
+		SearchWorkspace & backward, vector<int> & path, SearchStats * stats = nullptr) const;
+	const MultilevelPartition & GetPartition() const;
+	int GetBoundaryCount(int level) const;
+	long long GetCliqueSize() const;
+
+private:
+	MultilevelPartition m_partition;
+	vector<vector<int>> m_boundaryBegin;		//Boundary vertices of cell c are m_boundary[level][begin[c] to begin[c + 1])
+	vector<vector<int>> m_boundary;				//Boundary vertices of each level, cell by cell
+	vector<vector<int>> m_position;				//Place of a vertex in its cell's boundary list, NO_VERTEX if inside
+	vector<vector<long long>> m_cliqueBegin;	//Clique of cell c starts at m_cliques[level][begin[c]], row by row
+	vector<vector<int>> m_cliques;				//Distances between boundary vertices, INFINITE_DISTANCE if none
+
+	int QueryLevel(int vertex, int source, int target) const;
+	static void PruneClique(int * clique, int count);
+	template <typename V, typename E, typename Visit>
+	void ForEachOverlayEdge(const CompactGraph<V, E> & graph, const int * weights, int level, int vertex, Visit visit) const;
+	template <typename V, typename E>
+	void SearchCell(const CompactGraph<V, E> & graph, const int * weights, int level, int source, int target,
+		SearchWorkspace & workspace) const;
+	template <typename V, typename E>
+	void Unpack(const CompactGraph<V, E> & graph, const int * weights, int level, int from, int to, SearchWorkspace & workspace,
+		vector<int> & path) const;
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty overlay.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: There are no levels.
+************************************************************************/
+inline CellOverlay::CellOverlay()
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the overlay.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are empty.
+************************************************************************/
+inline CellOverlay::~CellOverlay()
+{
+	m_boundaryBegin.clear();
+	m_boundary.clear();
+	m_position.clear();
+	m_cliqueBegin.clear();
+	m_cliques.clear();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+inline CellOverlay::CellOverlay(const CellOverlay & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+inline CellOverlay & CellOverlay::operator=(const CellOverlay & rhs)
+{
+	if (this != &rhs)
+	{
+		m_partition = rhs.m_partition;
+		m_boundaryBegin = rhs.m_boundaryBegin;
+		m_boundary = rhs.m_boundary;
+		m_position = rhs.m_position;
+		m_cliqueBegin = rhs.m_cliqueBegin;
+		m_cliques = rhs.m_cliques;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function finds the boundary vertices of every cell on
+*		   every level and lays out the cliques. The cliques are left
+*		   unreachable until Customize().
+*
+* Precondition:	partition was built for graph.
+*
+* Postcondition: The overlay matches the partition.
+************************************************************************/
+template<typename V, typename E>
+void CellOverlay::Build(const CompactGraph<V, E> & graph, const MultilevelPartition & partition)
+{
+	const int SIZE = graph.GetVertexCount();
+	const int LEVELS = partition.GetLevelCount();
+	const int * targets = graph.GetTargets();
+
+	if (partition.GetVertexCount() != SIZE)
+	{
+		throw Exception("Partition does not match the graph");
+	}
+
+	m_partition = partition;
+	m_boundaryBegin.assign(LEVELS, vector<int>());
+	m_boundary.assign(LEVELS, vector<int>());
+	m_position.assign(LEVELS, vector<int>(SIZE, NO_VERTEX));
+	m_cliqueBegin.assign(LEVELS, vector<long long>());
+	m_cliques.assign(LEVELS, vector<int>());
+
+	for (int level = 0; level < LEVELS; level++)
+	{
+		const int CELLS = partition.GetCellCount(level);
+		vector<int> & begin = m_boundaryBegin[level];
+		vector<int> & boundary = m_boundary[level];
+		vector<long long> & cliqueBegin = m_cliqueBegin[level];
+
+		begin.assign(CELLS + 1, 0);
+		for (int v = 0; v < SIZE; v++)	//Count the boundary vertices of each cell
+		{
+			int cell = partition.GetCell(level, v);
+			for (int edge = graph.GetEdgeBegin(v); edge != graph.GetEdgeEnd(v); ++edge)
+			{
+				if (partition.GetCell(level, targets[edge]) != cell)
+				{
+					m_position[level][v] = begin[cell + 1]++;
+					break;
+				}
+			}
+		}
+		for (int cell = 0; cell < CELLS; cell++)
+		{
+			begin[cell + 1] += begin[cell];
+		}
+		boundary.resize(begin[CELLS]);
+		for (int v = 0; v < SIZE; v++)
+		{
+			if (m_position[level][v] != NO_VERTEX)
+			{
+				boundary[begin[partition.GetCell(level, v)] + m_position[level][v]] = v;
+			}
+		}
+
+		cliqueBegin.assign(CELLS + 1, 0);
+		for (int cell = 0; cell < CELLS; cell++)
+		{
+			long long count = begin[cell + 1] - begin[cell];
+			cliqueBegin[cell + 1] = cliqueBegin[cell] + count * count;
+		}
+		m_cliques[level].assign(static_cast<size_t>(cliqueBegin[CELLS]), INFINITE_DISTANCE);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function fills the cliques for the metric weights, one
+*		   level at a time from the smallest cells up. Each boundary
+*		   vertex of a cell is searched from inside the cell (on level
+*		   0 over the plain edges, above that over the level below's
+*		   cliques), which gives one row of the cell's clique.
+*
+* Precondition:	Build() was called for graph; weights holds a weight of
+*				0 or more per edge id. threads < 1 uses every hardware
+*				thread.
+*
+* Postcondition: Every clique holds the distances for weights, less the
+*				 entries PruneClique() dropped.
+************************************************************************/
+template<typename V, typename E>
+void CellOverlay::Customize(const CompactGraph<V, E> & graph, const int * weights, int threads)
+{
+	if (threads < 1)
+	{
+		threads = DefaultThreadCount();
+	}
+	vector<SearchWorkspace> workspaces(threads);
+
+	for (int level = 0; level < m_partition.GetLevelCount(); level++)
+	{
+		const vector<int> & begin = m_boundaryBegin[level];
+		const vector<int> & boundary = m_boundary[level];
+		ParallelFor(0, m_partition.GetCellCount(level), threads, [&](int worker, int cell)
+		{
+			const int COUNT = begin[cell + 1] - begin[cell];
+			int * clique = m_cliques[level].empty() ? nullptr : &m_cliques[level][static_cast<size_t>(m_cliqueBegin[level][cell])];
+			for (int row = 0; row < COUNT; row++)
+			{
+				SearchCell(graph, weights, level, boundary[begin[cell] + row], NO_VERTEX, workspaces[worker]);
+				const int * distance = workspaces[worker].GetDistances();
+				for (int column = 0; column < COUNT; column++)
+				{
+					clique[row * COUNT + column] = distance[boundary[begin[cell] + column]];
+				}
+			}
+			PruneClique(clique, COUNT);
+		});
+	}
+}
+
+/**********************************************************************
+* Purpose: This function finds the shortest route from source to target.
+*		   Searches run from both ends at once, each vertex reading the
+*		   edges of its query level: plain edges in the smallest cells
+*		   of source and target, otherwise the clique of its cell on the
+*		   highest level where that cell holds neither, plus the plain
+*		   edges leaving that cell. They stop when the two smallest
+*		   queue keys add up to at least the best route seen. Clique
+*		   edges on the route are then unpacked with searches inside
+*		   their cells.
+*
+* Precondition:	Customize() was called with weights.
+*
+* Postcondition: path holds the indices from source to target (empty if
+*				 there is no route) and the distance is returned,
+*				 INFINITE_DISTANCE if there is no route.
+************************************************************************/
+template<typename V, typename E>
+int CellOverlay::Route(const CompactGraph<V, E> & graph, const int * weights, int source, int target,
+	SearchWorkspace & forward, SearchWorkspace & backward, vector<int> & path, SearchStats * stats) const
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (target < 0 || target >= graph.GetVertexCount())
+	{
+		throw Exception("Ending vertex is not in the graph!");
+	}
+	if (m_partition.GetVertexCount() != graph.GetVertexCount())
+	{
+		throw Exception("Partition does not match the graph");
+	}
+
+	SearchWorkspace * sides[2] = { &forward, &backward };
+	int best = INFINITE_DISTANCE;
+	int meet = NO_VERTEX;
+	SearchStats counts;
+	counts.searchSeconds -= StatsClock();
+
+	path.clear();
+	for (int side = 0; side < 2; side++)
+	{
+		sides[side]->Prepare(graph.GetVertexCount());
+		if (graph.MayConnect(source, target))
+		{
+			int start = side == 0 ? source : target;
+			sides[side]->Touch(start);
+			sides[side]->GetDistances()[start] = 0;
+			sides[side]->GetQueue().Push(0, start);
+			STATS_ADD(counts.pushes, 1);
+		}
+	}
+	if (source == target && graph.MayConnect(source, target))
+	{
+		best = 0;
+		meet = source;
+	}
+
+	//************************** Search from both ends **********************************
+	for (;;)
+	{
+		RadixHeap<int> & forwardQueue = forward.GetQueue();
+		RadixHeap<int> & backwardQueue = backward.GetQueue();
+		long long forwardKey = forwardQueue.IsEmpty() ? INFINITE_DISTANCE : forwardQueue.GetTopKey();
+		long long backwardKey = backwardQueue.IsEmpty() ? INFINITE_DISTANCE : backwardQueue.GetTopKey();
+		if ((forwardQueue.IsEmpty() && backwardQueue.IsEmpty()) || forwardKey + backwardKey >= best)
+		{
+			break;
+		}
+
+		int side = forwardKey <= backwardKey ? 0 : 1;
+		SearchWorkspace & here = *sides[side];
+		const int * other = sides[1 - side]->GetDistances();
+		int * distance = here.GetDistances();
+		int * pred = here.GetPreds();
+		char * done = here.GetDone();
+		int dist = here.GetQueue().GetTopKey();
+		int current = here.GetQueue().GetTopVertex();
+		here.GetQueue().Pop();
+		STATS_ADD(counts.pops, 1);
+		if (dist != distance[current] || done[current])
+		{
+			continue;	//Improved after it was pushed
+		}
+		done[current] = 1;
+		STATS_ADD(counts.settled, 1);
+
+		ForEachOverlayEdge(graph, weights, QueryLevel(current, source, target), current, [&](int to, int weight)
+		{
+			int cost = dist + weight;
+			STATS_ADD(counts.relaxed, 1);
+			if (cost < distance[to])
+			{
+				if (distance[to] == INFINITE_DISTANCE)
+				{
+					here.Touch(to);
+				}
+				distance[to] = cost;
+				pred[to] = current;
+				here.GetQueue().Push(cost, to);
+				STATS_ADD(counts.pushes, 1);
+				if (other[to] != INFINITE_DISTANCE && cost + other[to] < best)
+				{
+					best = cost + other[to];
+					meet = to;
+				}
+			}
+		});
+	}
+	forward.GetQueue().Clear();
+	backward.GetQueue().Clear();
+	counts.searchSeconds += StatsClock();
+	counts.reconstructSeconds -= StatsClock();
+
+	//************************** Unpack the route **********************************
+	if (meet != NO_VERTEX)
+	{
+		vector<int> half;	//Multilevel route, source to meet then meet to target
+
+		for (int vertex = meet; vertex != NO_VERTEX; vertex = forward.GetPreds()[vertex])
+		{
+			half.push_back(vertex);
+		}
+		std::reverse(half.begin(), half.end());
+		const size_t MEET = half.size() - 1;
+		for (int vertex = backward.GetPreds()[meet]; vertex != NO_VERTEX; vertex = backward.GetPreds()[vertex])
+		{
+			half.push_back(vertex);
+		}
+
+		path.push_back(half[0]);
+		for (size_t i = 1; i < half.size(); i++)
+		{
+			//A step was read at the query level of the vertex its search scanned
+			int from = half[i - 1];
+			int to = half[i];
+			int level = i <= MEET ? QueryLevel(from, source, target) : QueryLevel(to, source, target);
+			if (level >= 0 && m_partition.GetCell(level, from) == m_partition.GetCell(level, to))
+			{
+				Unpack(graph, weights, level, from, to, forward, path);	//Its preds are in half already
+			}
+			else
+			{
+				path.push_back(to);
+			}
+		}
+	}
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.reconstructSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+	return best;
+}
+
+/**********************************************************************
+* Purpose: This function returns the partition.
+*
+* Precondition:	N/A
+*
+* Postcondition: The partition is returned.
+************************************************************************/
+inline const MultilevelPartition & CellOverlay::GetPartition() const
+{
+	return m_partition;
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of boundary vertices on a
+*		   level, which is what customization and queries grow with.
+*
+* Precondition:	level is below the partition's level count.
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int CellOverlay::GetBoundaryCount(int level) const
+{
+	return static_cast<int>(m_boundary[level].size());
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of clique entries, which is
+*		   the memory one metric takes.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline long long CellOverlay::GetCliqueSize() const
+{
+	long long size = 0;
+	for (size_t level = 0; level < m_cliques.size(); level++)
+	{
+		size += static_cast<long long>(m_cliques[level].size());
+	}
+	return size;
+}
+
+/**********************************************************************
+* Purpose: This function returns the level a query from source to target
+*		   reads vertex's edges at: the highest level where vertex's
+*		   cell holds neither source nor target. Cells nest, so it is
+*		   the first such level from the top.
+*
+* Precondition:	All three are valid vertices.
+*
+* Postcondition: The level is returned, -1 for the plain edges.
+************************************************************************/
+inline int CellOverlay::QueryLevel(int vertex, int source, int target) const
+{
+	for (int level = m_partition.GetLevelCount() - 1; level >= 0; level--)
+	{
+		int cell = m_partition.GetCell(level, vertex);
+		if (cell != m_partition.GetCell(level, source) && cell != m_partition.GetCell(level, target))
+		{
+			return level;
+		}
+	}
+	return -1;
+}
+
+/**********************************************************************
+* Purpose: This function drops the entries of a clique that the path
+*		   through another of its boundary vertices matches, marking
+*		   them INFINITE_DISTANCE. Each dropped entry is matched by two
+*		   shorter ones, so every distance is still reached by the
+*		   entries left. Zero entries are neither dropped nor used to
+*		   drop others, or two could drop each other.
+*
+* Precondition:	clique holds count x count distances, row by row.
+*
+* Postcondition: Only entries no other boundary vertex can stand in for
+*				 are left.
+************************************************************************/
+inline void CellOverlay::PruneClique(int * clique, int count)
+{
+	const vector<int> FULL(clique, clique + count * count);
+
+	for (int row = 0; row < count; row++)
+	{
+		for (int column = 0; column < count; column++)
+		{
+			const int DIRECT = FULL[row * count + column];
+			if (row == column || DIRECT == INFINITE_DISTANCE || DIRECT == 0)
+			{
+				continue;
+			}
+			for (int via = 0; via < count; via++)
+			{
+				int first = FULL[row * count + via];
+				int second = FULL[via * count + column];
+				if (via != row && via != column && first > 0 && second > 0 && first != INFINITE_DISTANCE
+					&& second != INFINITE_DISTANCE && first + second == DIRECT)
+				{
+					clique[row * count + column] = INFINITE_DISTANCE;
+					break;
+				}
+			}
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function calls visit(to, weight) for every edge of vertex
+*		   in the overlay of level: its clique in its cell and the plain
+*		   edges that leave the cell. Level -1 is the plain graph.
+*
+* Precondition:	On a level of 0 or more, vertex is a boundary vertex.
+*
+* Postcondition: visit was called once per edge.
+************************************************************************/
+template<typename V, typename E, typename Visit>
+void CellOverlay::ForEachOverlayEdge(const CompactGraph<V, E> & graph, const int * weights, int level, int vertex, Visit visit) const
+{
+	const int * targets = graph.GetTargets();
+
+	if (level < 0)
+	{
+		for (int edge = graph.GetEdgeBegin(vertex); edge != graph.GetEdgeEnd(vertex); ++edge)
+		{
+			visit(targets[edge], weights[edge]);
+		}
+		return;
+	}
+
+	int cell = m_partition.GetCell(level, vertex);
+	int first = m_boundaryBegin[level][cell];
+	int count = m_boundaryBegin[level][cell + 1] - first;
+	const int * row = &m_cliques[level][static_cast<size_t>(m_cliqueBegin[level][cell] + static_cast<long long>(m_position[level][vertex]) * count)];
+	for (int column = 0; column < count; column++)
+	{
+		if (row[column] != INFINITE_DISTANCE)	//Its own column is 0, which never improves it
+		{
+			visit(m_boundary[level][first + column], row[column]);
+		}
+	}
+	for (int edge = graph.GetEdgeBegin(vertex); edge != graph.GetEdgeEnd(vertex); ++edge)
+	{
+		if (m_partition.GetCell(level, targets[edge]) != cell)
+		{
+			visit(targets[edge], weights[edge]);
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function runs Dijkstra from source without leaving its
+*		   cell on level, over the overlay of the level below (the plain
+*		   graph for level 0). With a target it stops once the target is
+*		   settled.
+*
+* Precondition:	source is a boundary vertex of its cell on level, or any
+*				vertex of it on level 0; the level below is customized.
+*
+* Postcondition: workspace holds the distances and predecessors inside
+*				 the cell.
+************************************************************************/
+template<typename V, typename E>
+void CellOverlay::SearchCell(const CompactGraph<V, E> & graph, const int * weights, int level, int source, int target,
+	SearchWorkspace & workspace) const
+{
+	const int CELL = m_partition.GetCell(level, source);
+	workspace.Prepare(graph.GetVertexCount());
+	int * distance = workspace.GetDistances();
+	int * pred = workspace.GetPreds();
+	char * done = workspace.GetDone();
+	RadixHeap<int> & heap = workspace.GetQueue();
+
+	workspace.Touch(source);
+	distance[source] = 0;
+	heap.Push(0, source);
+	while (!heap.IsEmpty())
+	{
+		int dist = heap.GetTopKey();
+		int current = heap.GetTopVertex();
+		heap.Pop();
+		if (dist != distance[current] || done[current])
+		{
+			continue;
+		}
+		done[current] = 1;
+		if (current == target)
+		{
+			break;
+		}
+
+		ForEachOverlayEdge(graph, weights, level - 1, current, [&](int to, int weight)
+		{
+			int cost = dist + weight;
+			if (m_partition.GetCell(level, to) == CELL && cost < distance[to])
+			{
+				if (distance[to] == INFINITE_DISTANCE)
+				{
+					workspace.Touch(to);
+				}
+				distance[to] = cost;
+				pred[to] = current;
+				heap.Push(cost, to);
+			}
+		});
+	}
+	heap.Clear();
+}
+
+/**********************************************************************
+* Purpose: This function turns a clique edge of level from from to to
+*		   into plain edges: a search inside the cell gives the path over
+*		   the level below, and any clique edge on that is unpacked the
+*		   same way.
+*
+* Precondition:	from and to are boundary vertices of the same cell on
+*				level, and the clique joins them.
+*
+* Postcondition: The vertices after from, up to and including to, are
+*				 added to path.
+************************************************************************/
+template<typename V, typename E>
+void CellOverlay::Unpack(const CompactGraph<V, E> & graph, const int * weights, int level, int from, int to,
+	SearchWorkspace & workspace, vector<int> & path) const
+{
+	vector<int> steps;	//Path over the level below, from to to
+
+	SearchCell(graph, weights, level, from, to, workspace);
+	for (int vertex = to; vertex != NO_VERTEX; vertex = workspace.GetPreds()[vertex])
+	{
+		steps.push_back(vertex);
+	}
+	std::reverse(steps.begin(), steps.end());
+
+	for (size_t i = 1; i < steps.size(); i++)
+	{
+		if (level > 0 && m_partition.GetCell(level - 1, steps[i - 1]) == m_partition.GetCell(level - 1, steps[i]))
+		{
+			Unpack(graph, weights, level - 1, steps[i - 1], steps[i], workspace, path);
+		}
+		else
+		{
+			path.push_back(steps[i]);
+		}
+	}
+}
@@ -0,0 +1,687 @@
+/************************************************************************
+* Class: CompactGraph
+*
+* Purpose: This class holds a flattened copy of a Graph, with every vertex
+*		   numbered 0 to n-1 and the edges stored in contiguous arrays
+*		   (compressed sparse rows). It is what the search engines run on.
+*		   Every array is copy on write, so copying a compact graph is a
+*		   handful of reference counts, and a copy that only changes
+*		   weights shares its vertices and adjacency with the original.
+*
+* Manager functions
+*	CompactGraph()
+*		Creates an empty compact graph.
+*	CompactGraph(Graph<V, E> & graph)
+*		Builds the compact graph from graph.
+*	~CompactGraph()
+*		Lets go of all of the arrays.
+*	CompactGraph(const CompactGraph<V, E> & copy)
+*		Shares copy's arrays, the same as op= does.
+*	operator=(const CompactGraph<V, E> & rhs)
+*		Shares rhs's arrays until one side changes them.
+*
+* Methods:
+*	Build(Graph<V, E> & graph)
+*		Flattens graph into the arrays, replacing anything already there.
+*	Build(const vector<V> & data, const vector<int> & from, const vector<int> & to,
+*		  const vector<E> & edgeData, const vector<Weight> & weights)
+*		Builds the arrays straight from a list of two way edges.
+*	Reorder(const vector<int> & order)
+*		Renumbers the vertices so old vertex order[i] becomes vertex i.
+*	GetVertexCount()
+*		Returns the number of vertices.
+*	GetEdgeCount()
+*		Returns the number of edges.
+*	GetIndex(const V & data)
+*		Returns the index of the vertex holding data.
+*	FindIndex(const V & data)
+*		Same, but returns NO_VERTEX instead of throwing.
+*	GetData(int index)
+*		Returns the data of the vertex at index.
+*	GetEdgeBegin(int index) / GetEdgeEnd(int index)
+*		Returns the range of edge ids leaving the vertex at index.
+*	GetTarget(int edge) / GetWeight(int edge) / GetEdgeData(int edge)
+*		Returns the destination, weight and data of an edge.
+*	GetTargets() / GetWeights()
+*		Returns the raw edge arrays, for tight loops.
+*	ForEachEdge(int index, Visit visit)
+*		Calls visit(edge, target, weight) for every edge leaving index.
+*	SetWeight(int edge, Weight weight)
+*		Changes the weight of one edge.
+*	SetComponents(const vector<int> & components)
+*		Stores a connected component id for every vertex.
+*	GetComponent(int index)
+*		Returns the component of index, NO_VERTEX if none are stored.
+*	MayConnect(int from, int to)
+*		Returns false only if from and to are known to be apart.
+*************************************************************************/
+#include <vector>
+#include <map>
+#include <climits>
+#include "Graph.h"
+#include "VertexKey.h"
+#include "CopyOnWrite.h"
+using std::vector;
+using std::map;
+
+#pragma once
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+
+const int INFINITE_DISTANCE = INT_MAX;	//Distance of a vertex that was never reached
+const int NO_VERTEX = -1;				//Index used when there is no vertex (no predecessor)
+
+template <typename V, typename E>
+class CompactGraph
+{
+public:
+	typedef int Weight;
+
+	CompactGraph();
+	CompactGraph(Graph<V, E> & graph);
+	~CompactGraph();
+	CompactGraph(const CompactGraph<V, E> & copy);
+	const CompactGraph<V, E> & operator=(const CompactGraph<V, E> & rhs);
+
+	void Build(Graph<V, E> & graph);
+	void Build(const vector<V> & data, const vector<int> & from, const vector<int> & to,
+		const vector<E> & edgeData, const vector<Weight> & weights);
+	void Reorder(const vector<int> & order);
+	int GetVertexCount() const;
+	int GetEdgeCount() const;
+	int GetIndex(const V & data) const;
+	int FindIndex(const V & data) const;
+	const V & GetData(int index) const;
+	int GetEdgeBegin(int index) const;
+	int GetEdgeEnd(int index) const;
+	int GetTarget(int edge) const;
+	Weight GetWeight(int edge) const;
+	const E & GetEdgeData(int edge) const;
+	const int * GetTargets() const;
+	const Weight * GetWeights() const;
+	template <typename Visit>
+	void ForEachEdge(int index, Visit visit) const;
+	void SetWeight(int edge, Weight weight);
+	void SetComponents(const vector<int> & components);
+	int GetComponent(int index) const;
+	bool MayConnect(int from, int to) const;
+
+private:
+	CopyOnWrite<vector<V>> m_data;			//Data of each vertex, by index
+	CopyOnWrite<IndexMap<V>> m_index;		//Data to index lookup, an array for integer ids
+	CopyOnWrite<vector<int>> m_offsets;		//Edges of vertex i are [m_offsets[i], m_offsets[i + 1])
+	CopyOnWrite<vector<int>> m_targets;		//Destination index of each edge
+	CopyOnWrite<vector<Weight>> m_weights;	//Weight of each edge
+	CopyOnWrite<vector<E>> m_edgeData;		//Data of each edge
+	CopyOnWrite<vector<int>> m_components;	//Component of each vertex, empty until set
+	const int * m_offsetsView;				//Raw arrays of the three above, so the search
+	const int * m_targetsView;				//loops read them with one load, not two
+	const Weight * m_weightsView;
+
+	void UpdateViews();
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty compact graph.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The graph has no vertices and one offset of 0.
+************************************************************************/
+template<typename V, typename E>
+inline CompactGraph<V, E>::CompactGraph() : m_offsets(vector<int>(1, 0))
+{
+	UpdateViews();
+}
+
+/**********************************************************************
+* Purpose: This function builds the compact graph from graph.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The arrays hold every vertex and edge of graph.
+************************************************************************/
+template<typename V, typename E>
+inline CompactGraph<V, E>::CompactGraph(Graph<V, E> & graph)
+{
+	Build(graph);
+}
+
+/**********************************************************************
+* Purpose: This function lets go of all of the arrays. Arrays a copy
+*		   still shares stay alive for it.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: Arrays only this graph held are freed.
+************************************************************************/
+template<typename V, typename E>
+inline CompactGraph<V, E>::~CompactGraph()
+{
+	//Each CopyOnWrite frees its array when the last graph sharing it goes
+}
+
+/**********************************************************************
+* Purpose: This function shares copy's arrays. They are taken straight
+*		   in the initializer list, so no empty array is made first
+*		   only to be thrown away by op=.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: members share copy's arrays.
+************************************************************************/
+template<typename V, typename E>
+inline CompactGraph<V, E>::CompactGraph(const CompactGraph<V, E> & copy)
+	: m_data(copy.m_data), m_index(copy.m_index), m_offsets(copy.m_offsets), m_targets(copy.m_targets),
+	m_weights(copy.m_weights), m_edgeData(copy.m_edgeData), m_components(copy.m_components),
+	m_offsetsView(nullptr), m_targetsView(nullptr), m_weightsView(nullptr)
+{
+	UpdateViews();
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members. No array
+*		   is copied; both graphs share them until one changes.
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+template<typename V, typename E>
+inline const CompactGraph<V, E> & CompactGraph<V, E>::operator=(const CompactGraph<V, E> & rhs)
+{
+	if (this != &rhs)
+	{
+		m_data = rhs.m_data;
+		m_index = rhs.m_index;
+		m_offsets = rhs.m_offsets;
+		m_targets = rhs.m_targets;
+		m_weights = rhs.m_weights;
+		m_edgeData = rhs.m_edgeData;
+		m_components = rhs.m_components;
+		UpdateViews();
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function flattens graph into the arrays. Vertices keep
+*		   the order they have in the graphs list, so index i is the
+*		   i'th vertex of graph.GetVertices().
+*
+* Precondition:	N/A
+*
+* Postcondition: The arrays hold every vertex and edge of graph.
+************************************************************************/
+template<typename V, typename E>
+inline void CompactGraph<V, E>::Build(Graph<V, E> & graph)
+{
+	m_data.Clear();
+	m_index.Clear();
+	m_offsets.Assign(vector<int>(1, 0));
+	m_targets.Clear();
+	m_weights.Clear();
+	m_edgeData.Clear();
+	m_components.Clear();
+	UpdateViews();
+
+	if (graph.IsEmpty())
+	{
+		return;
+	}
+
+	vector<V> & data = m_data.Edit();
+	IndexMap<V> & index = m_index.Edit();
+	vector<int> & offsets = m_offsets.Edit();
+	vector<int> & targets = m_targets.Edit();
+	vector<Weight> & weights = m_weights.Edit();
+	vector<E> & edgeData = m_edgeData.Edit();
+
+	map<const Vertex<V, E> *, int> position;	//Vertex address to index, so edges can be numbered
+	Vertex<V, E> * temp = nullptr;
+	typename list<Vertex<V, E>>::iterator viter;
+	typename list<Edge<V, E>>::iterator eiter;
+	int count = 0;
+
+	for (viter = graph.GetVertices().begin(); viter != graph.GetVertices().end(); ++viter)
+	{
+		temp = &(*viter);
+		position[temp] = count;
+		index.Set(temp->GetData(), count);
+		data.push_back(temp->GetData());
+		count++;
+	}
+
+	offsets.reserve(count + 1);
+	for (viter = graph.GetVertices().begin(); viter != graph.GetVertices().end(); ++viter)
+	{
+		temp = &(*viter);
+		for (eiter = temp->GetEdges().begin(); eiter != temp->GetEdges().end(); ++eiter)
+		{
+			targets.push_back(position[eiter->GetDestination()]);
+			weights.push_back(eiter->GetWeight());
+			edgeData.push_back(eiter->GetData());
+		}
+		offsets.push_back(static_cast<int>(targets.size()));	//End of this vertex's edges
+	}
+	UpdateViews();
+}
+
+/**********************************************************************
+* Purpose: This function builds the arrays from a list of edges without
+*		   going through a Graph, which is too slow for millions of
+*		   vertices. Like Graph::AddEdge, every edge goes both ways, and
+*		   each vertex keeps its edges in the order they are listed, so
+*		   the result matches Build() of the same edges added to a Graph.
+*
+* Precondition:	data holds each vertex's data once; from, to, edgeData and
+*				weights have one entry per edge, from and to are indices
+*				into data.
+*
+* Postcondition: The arrays hold the edges, replacing anything already there.
+************************************************************************/
+template<typename V, typename E>
+inline void CompactGraph<V, E>::Build(const vector<V> & data, const vector<int> & from, const vector<int> & to,
+	const vector<E> & edgeData, const vector<Weight> & weights)
+{
+	const int SIZE = static_cast<int>(data.size());
+	const size_t EDGES = from.size();
+
+	if (to.size() != EDGES || edgeData.size() != EDGES || weights.size() != EDGES)
+	{
+		throw Exception("Every edge needs a from, a to, data and a weight");
+	}
+
+	m_data.Assign(vector<V>(data));
+	m_index.Clear();
+	m_offsets.Assign(vector<int>(SIZE + 1, 0));
+	m_targets.Assign(vector<int>(EDGES * 2, 0));
+	m_weights.Assign(vector<Weight>(EDGES * 2, 0));
+	m_edgeData.Assign(vector<E>(EDGES * 2, E()));
+	m_components.Clear();
+
+	IndexMap<V> & index = m_index.Edit();
+	vector<int> & offsets = m_offsets.Edit();
+	vector<int> & targets = m_targets.Edit();
+	vector<Weight> & edgeWeights = m_weights.Edit();
+	vector<E> & edgeValues = m_edgeData.Edit();
+
+	for (int i = 0; i < SIZE; i++)
+	{
+		index.Set(data[i], i);
+	}
+	for (size_t i = 0; i < EDGES; i++)	//Count the edges of each vertex
+	{
+		if (from[i] < 0 || from[i] >= SIZE || to[i] < 0 || to[i] >= SIZE)
+		{
+			throw Exception("Unable to add edge; vertex was not found!");
+		}
+		offsets[from[i] + 1]++;
+		offsets[to[i] + 1]++;
+	}
+	for (int i = 0; i < SIZE; i++)
+	{
+		offsets[i + 1] += offsets[i];
+	}
+
+	vector<int> next(offsets.begin(), offsets.end() - 1);	//Next free slot of each vertex
+	for (size_t i = 0; i < EDGES; i++)
+	{
+		int slot = next[from[i]]++;
+		targets[slot] = to[i];
+		edgeWeights[slot] = weights[i];
+		edgeValues[slot] = edgeData[i];
+
+		slot = next[to[i]]++;
+		targets[slot] = from[i];
+		edgeWeights[slot] = weights[i];
+		edgeValues[slot] = edgeData[i];
+	}
+	UpdateViews();
+}
+
+/**********************************************************************
+* Purpose: This function renumbers the vertices so that old vertex
+*		   order[i] becomes vertex i, rewriting every edge to match.
+*		   Edges keep their order within a vertex.
+*
+* Precondition:	order is a permutation of 0 to GetVertexCount() - 1.
+*
+* Postcondition: The arrays are laid out in the new order.
+************************************************************************/
+template<typename V, typename E>
+inline void CompactGraph<V, E>::Reorder(const vector<int> & order)
+{
+	const int SIZE = GetVertexCount();
+	vector<int> position(SIZE, NO_VERTEX);	//Old index to new index
+
+	if (static_cast<int>(order.size()) != SIZE)
+	{
+		throw Exception("Order does not match the number of vertices");
+	}
+	for (int i = 0; i < SIZE; i++)
+	{
+		if (order[i] < 0 || order[i] >= SIZE || position[order[i]] != NO_VERTEX)
+		{
+			throw Exception("Order is not a permutation of the vertices");
+		}
+		position[order[i]] = i;
+	}
+
+	vector<V> data;
+	vector<int> offsets;
+	vector<int> targets;
+	vector<Weight> weights;
+	vector<E> edgeData;
+
+	data.reserve(SIZE);
+	offsets.reserve(SIZE + 1);
+	targets.reserve(m_targets->size());
+	weights.reserve(m_weights->size());
+	edgeData.reserve(m_edgeData->size());
+	offsets.push_back(0);
+	m_index.Clear();
+	IndexMap<V> & index = m_index.Edit();
+
+	for (int i = 0; i < SIZE; i++)
+	{
+		int old = order[i];
+		data.push_back((*m_data)[old]);
+		index.Set((*m_data)[old], i);
+		for (int edge = (*m_offsets)[old]; edge != (*m_offsets)[old + 1]; ++edge)
+		{
+			targets.push_back(position[(*m_targets)[edge]]);
+			weights.push_back((*m_weights)[edge]);
+			edgeData.push_back((*m_edgeData)[edge]);
+		}
+		offsets.push_back(static_cast<int>(targets.size()));
+	}
+
+	m_data.Assign(std::move(data));
+	m_offsets.Assign(std::move(offsets));
+	m_targets.Assign(std::move(targets));
+	m_weights.Assign(std::move(weights));
+	m_edgeData.Assign(std::move(edgeData));
+	UpdateViews();
+
+	if (!m_components->empty())
+	{
+		vector<int> components(SIZE);
+		for (int i = 0; i < SIZE; i++)
+		{
+			components[i] = (*m_components)[order[i]];
+		}
+		m_components.Assign(std::move(components));
+	}
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of vertices.
+*
+* Precondition:	N/A
+*
+* Postcondition: The number of vertices is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int CompactGraph<V, E>::GetVertexCount() const
+{
+	return static_cast<int>(m_data->size());
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of edges.
+*
+* Precondition:	N/A
+*
+* Postcondition: The number of edges is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int CompactGraph<V, E>::GetEdgeCount() const
+{
+	return static_cast<int>(m_targets->size());
+}
+
+/**********************************************************************
+* Purpose: This function returns the index of the vertex holding data.
+*
+* Precondition:	data is in the graph.
+*
+* Postcondition: The index is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int CompactGraph<V, E>::GetIndex(const V & data) const
+{
+	int index = m_index->Find(data);
+	if (index == NO_VERTEX)
+	{
+		throw Exception("Data is not in the graph");
+	}
+	return index;
+}
+
+/**********************************************************************
+* Purpose: This function returns the index of the vertex holding data,
+*		   for callers that want to handle a missing vertex themselves.
+*
+* Precondition:	N/A
+*
+* Postcondition: The index is returned, NO_VERTEX if data is not there.
+************************************************************************/
+template<typename V, typename E>
+inline int CompactGraph<V, E>::FindIndex(const V & data) const
+{
+	return m_index->Find(data);
+}
+
+/**********************************************************************
+* Purpose: This function returns the data of the vertex at index.
+*
+* Precondition:	index is a valid vertex.
+*
+* Postcondition: The data is returned.
+************************************************************************/
+template<typename V, typename E>
+inline const V & CompactGraph<V, E>::GetData(int index) const
+{
+	return (*m_data)[index];
+}
+
+/**********************************************************************
+* Purpose: This function returns the first edge id leaving index.
+*
+* Precondition:	index is a valid vertex.
+*
+* Postcondition: The first edge id is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int CompactGraph<V, E>::GetEdgeBegin(int index) const
+{
+	return m_offsetsView[index];
+}
+
+/**********************************************************************
+* Purpose: This function returns one past the last edge id leaving index.
+*
+* Precondition:	index is a valid vertex.
+*
+* Postcondition: The end edge id is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int CompactGraph<V, E>::GetEdgeEnd(int index) const
+{
+	return m_offsetsView[index + 1];
+}
+
+/**********************************************************************
+* Purpose: This function returns the destination index of an edge.
+*
+* Precondition:	edge is a valid edge id.
+*
+* Postcondition: The destination is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int CompactGraph<V, E>::GetTarget(int edge) const
+{
+	return m_targetsView[edge];
+}
+
+/**********************************************************************
+* Purpose: This function returns the weight of an edge.
+*
+* Precondition:	edge is a valid edge id.
+*
+* Postcondition: The weight is returned.
+************************************************************************/
+template<typename V, typename E>
+inline typename CompactGraph<V, E>::Weight CompactGraph<V, E>::GetWeight(int edge) const
+{
+	return m_weightsView[edge];
+}
+
+/**********************************************************************
+* Purpose: This function returns the data of an edge.
+*
+* Precondition:	edge is a valid edge id.
+*
+* Postcondition: The data is returned.
+************************************************************************/
+template<typename V, typename E>
+inline const E & CompactGraph<V, E>::GetEdgeData(int edge) const
+{
+	return (*m_edgeData)[edge];
+}
+
+/**********************************************************************
+* Purpose: This function returns the array of edge destinations.
+*
+* Precondition:	N/A
+*
+* Postcondition: The array is returned, indexed by edge id.
+************************************************************************/
+template<typename V, typename E>
+inline const int * CompactGraph<V, E>::GetTargets() const
+{
+	return m_targetsView;
+}
+
+/**********************************************************************
+* Purpose: This function returns the array of edge weights.
+*
+* Precondition:	N/A
+*
+* Postcondition: The array is returned, indexed by edge id.
+************************************************************************/
+template<typename V, typename E>
+inline const typename CompactGraph<V, E>::Weight * CompactGraph<V, E>::GetWeights() const
+{
+	return m_weightsView;
+}
+
+/**********************************************************************
+* Purpose: This function calls visit(edge, target, weight) for every
+*		   edge leaving index. Engines written against it run on a
+*		   ScenarioGraph too.
+*
+* Precondition:	index is a valid vertex.
+*
+* Postcondition: visit was called once per edge, in edge id order.
+************************************************************************/
+template<typename V, typename E>
+template<typename Visit>
+inline void CompactGraph<V, E>::ForEachEdge(int index, Visit visit) const
+{
+	for (int edge = m_offsetsView[index]; edge != m_offsetsView[index + 1]; ++edge)
+	{
+		visit(edge, m_targetsView[edge], m_weightsView[edge]);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function changes the weight of one edge, for what-if
+*		   copies of a graph. If the weights are shared with another
+*		   copy they are copied first; the vertices and adjacency stay
+*		   shared. Pointers from GetWeights() are stale afterwards.
+*
+* Precondition:	edge is a valid edge id, weight is 0 or more.
+*
+* Postcondition: The edge has the new weight in this graph only.
+************************************************************************/
+template<typename V, typename E>
+inline void CompactGraph<V, E>::SetWeight(int edge, Weight weight)
+{
+	if (edge < 0 || edge >= GetEdgeCount())
+	{
+		throw Exception("Edge is not in the graph");
+	}
+	m_weights.Edit()[edge] = weight;
+	UpdateViews();
+}
+
+/**********************************************************************
+* Purpose: This function stores the connected component of every vertex
+*		   (see LabelComponents() in Components.h), so queries between
+*		   two parts of the network can fail without a search. Any
+*		   rebuild clears them.
+*
+* Precondition:	components holds one id per vertex, equal for exactly the
+*				vertices that are connected, or is empty.
+*
+* Postcondition: The components are stored.
+************************************************************************/
+template<typename V, typename E>
+inline void CompactGraph<V, E>::SetComponents(const vector<int> & components)
+{
+	if (!components.empty() && static_cast<int>(components.size()) != GetVertexCount())
+	{
+		throw Exception("Components do not match the number of vertices");
+	}
+	m_components.Assign(vector<int>(components));
+}
+
+/**********************************************************************
+* Purpose: This function returns the connected component of a vertex.
+*
+* Precondition:	index is a valid vertex.
+*
+* Postcondition: The component id is returned, NO_VERTEX if components
+*				 were never set.
+************************************************************************/
+template<typename V, typename E>
+inline int CompactGraph<V, E>::GetComponent(int index) const
+{
+	return m_components->empty() ? NO_VERTEX : (*m_components)[index];
+}
+
+/**********************************************************************
+* Purpose: This function returns whether a route from one vertex to the
+*		   other may exist. Without stored components it can't tell, so
+*		   it always says it may.
+*
+* Precondition:	from and to are valid vertices.
+*
+* Postcondition: false is returned only if from and to are in different
+*				 components.
+************************************************************************/
+template<typename V, typename E>
+inline bool CompactGraph<V, E>::MayConnect(int from, int to) const
+{
+	return m_components->empty() || (*m_components)[from] == (*m_components)[to];
+}
+
+/**********************************************************************
+* Purpose: This function points the raw views at the current offsets,
+*		   targets and weights. Any change that can replace or unshare
+*		   one of them calls it.
+*
+* Precondition:	N/A
+*
+* Postcondition: The views match the arrays, nullptr for an empty one.
+************************************************************************/
+template<typename V, typename E>
+inline void CompactGraph<V, E>::UpdateViews()
+{
+	m_offsetsView = m_offsets->empty() ? nullptr : m_offsets->data();
+	m_targetsView = m_targets->empty() ? nullptr : m_targets->data();
+	m_weightsView = m_weights->empty() ? nullptr : m_weights->data();
+}
@@ -0,0 +1,209 @@
+/*************************************************************
+* Filename:		Components.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Connected components and reachability on a CompactGraph.
+*
+*	ConnectedComponents() is a lock free union-find run over the
+*	vertices in parallel: every edge joins the sets of its ends,
+*	roots are only ever hung under a smaller root with a compare
+*	and swap, and finds halve the path as they go. The smallest
+*	vertex of each component ends up its root, so the numbering
+*	is the same for any thread count. LabelComponents() stores the
+*	result in the graph, after which ShortestRoute() answers a
+*	query between two components without searching.
+*
+*	ReachableFrom() marks what one vertex can reach in a Bitmap,
+*	leaving the graph untouched (DepthFirst and BreadthFirst on
+*	Graph mark m_processed on the graph itself).
+*
+*	The graph must be two way, as every graph built by
+*	Graph::AddEdge or CompactGraph::Build is.
+**************************************************************/
+#include <vector>
+#include <atomic>
+#include <memory>
+#include "CompactGraph.h"
+#include "Bitmap.h"
+#include "Parallel.h"
+using std::vector;
+using std::atomic;
+using std::unique_ptr;
+
+#pragma once
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+template <typename V, typename E>
+int ConnectedComponents(const CompactGraph<V, E> & graph, int threads, vector<int> & component);	//Component id of every vertex
+
+template <typename V, typename E>
+int LabelComponents(CompactGraph<V, E> & graph, int threads);	//Stores the components in graph
+
+template <typename V, typename E>
+int ReachableFrom(const CompactGraph<V, E> & graph, int source, Bitmap & reached);	//Marks what source can reach
+
+int FindRoot(atomic<int> * parent, int vertex);		//Root of vertex's set, halving the path
+void JoinSets(atomic<int> * parent, int first, int second);	//Merges the sets of first and second
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function finds the root of vertex's set. On the way up
+*		   each vertex is pointed at its grandparent (path halving); a
+*		   failed swap only means another thread got there first.
+*
+* Precondition:	parent holds a forest of the vertices.
+*
+* Postcondition: The root is returned.
+************************************************************************/
+inline int FindRoot(atomic<int> * parent, int vertex)
+{
+	for (;;)
+	{
+		int up = parent[vertex].load(std::memory_order_relaxed);
+		if (up == vertex)
+		{
+			return vertex;
+		}
+		int next = parent[up].load(std::memory_order_relaxed);
+		if (next != up)
+		{
+			parent[vertex].compare_exchange_weak(up, next, std::memory_order_relaxed);
+		}
+		vertex = next;
+	}
+}
+
+/**********************************************************************
+* Purpose: This function merges the sets of first and second by hanging
+*		   the larger root under the smaller. The swap only succeeds
+*		   while the larger is still a root, otherwise it finds again.
+*
+* Precondition:	parent holds a forest of the vertices.
+*
+* Postcondition: first and second have the same root.
+************************************************************************/
+inline void JoinSets(atomic<int> * parent, int first, int second)
+{
+	for (;;)
+	{
+		first = FindRoot(parent, first);
+		second = FindRoot(parent, second);
+		if (first == second)
+		{
+			return;
+		}
+		int high = first > second ? first : second;
+		int low = first > second ? second : first;
+		if (parent[high].compare_exchange_strong(high, low, std::memory_order_relaxed))
+		{
+			return;
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function numbers the connected components of graph with
+*		   threads threads. Components are numbered 0 up in the order of
+*		   their smallest vertex.
+*
+* Precondition:	threads is 1 or more.
+*
+* Postcondition: component holds the id of every vertex; the number of
+*				 components is returned.
+************************************************************************/
+template<typename V, typename E>
+int ConnectedComponents(const CompactGraph<V, E> & graph, int threads, vector<int> & component)
+{
+	const int SIZE = graph.GetVertexCount();
+	const int * targets = graph.GetTargets();
+	unique_ptr<atomic<int>[]> parent(new atomic<int>[SIZE > 0 ? SIZE : 1]);
+	atomic<int> * sets = parent.get();
+	int count = 0;
+
+	ParallelFor(0, SIZE, threads, [&](int, int i)
+	{
+		sets[i].store(i, std::memory_order_relaxed);
+	});
+	ParallelFor(0, SIZE, threads, [&](int, int i)
+	{
+		for (int edge = graph.GetEdgeBegin(i); edge != graph.GetEdgeEnd(i); ++edge)
+		{
+			if (targets[edge] < i)	//Each road is stored both ways, one is enough
+			{
+				JoinSets(sets, i, targets[edge]);
+			}
+		}
+	});
+
+	component.resize(SIZE);
+	ParallelFor(0, SIZE, threads, [&](int, int i)
+	{
+		component[i] = FindRoot(sets, i);
+	});
+	for (int i = 0; i < SIZE; i++)	//Roots are the smallest vertex, so they come first
+	{
+		component[i] = component[i] == i ? count++ : component[component[i]];
+	}
+	return count;
+}
+
+/**********************************************************************
+* Purpose: This function finds the connected components of graph and
+*		   stores them in it, so routes between components fail at once.
+*
+* Precondition:	threads is 1 or more.
+*
+* Postcondition: graph holds the component of every vertex; the number
+*				 of components is returned.
+************************************************************************/
+template<typename V, typename E>
+int LabelComponents(CompactGraph<V, E> & graph, int threads)
+{
+	vector<int> component;
+	int count = ConnectedComponents(graph, threads, component);
+	graph.SetComponents(component);
+	return count;
+}
+
+/**********************************************************************
+* Purpose: This function marks every vertex source can reach, breadth
+*		   first, with the bitmap as the visited set.
+*
+* Precondition:	source is a valid index of graph.
+*
+* Postcondition: reached has a bit set for every vertex source can reach;
+*				 the number reached is returned.
+************************************************************************/
+template<typename V, typename E>
+int ReachableFrom(const CompactGraph<V, E> & graph, int source, Bitmap & reached)
+{
+	const int * targets = graph.GetTargets();
+	vector<int> queue;
+
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+
+	reached.Resize(graph.GetVertexCount());
+	reached.Set(source);
+	queue.push_back(source);
+	for (size_t next = 0; next < queue.size(); next++)
+	{
+		int from = queue[next];
+		for (int edge = graph.GetEdgeBegin(from); edge != graph.GetEdgeEnd(from); ++edge)
+		{
+			if (!reached.Test(targets[edge]))
+			{
+				reached.Set(targets[edge]);
+				queue.push_back(targets[edge]);
+			}
+		}
+	}
+	return static_cast<int>(queue.size());
+}
+#endif
@@ -0,0 +1,379 @@
+/************************************************************************
+* Class: CompressedGraph
+*
+* Purpose: This class holds the adjacency of a CompactGraph in about a
+*		   third of the memory, for graphs too big to search otherwise.
+*		   Each vertex's edges are sorted by target and written as
+*		   varints (7 bits a byte, the high bit set on all but the
+*		   last byte): the first target as a zigzag coded difference
+*		   from the vertex itself, each next target as the difference
+*		   from the one before, and each weight divided by a quantum.
+*		   On a graph numbered so neighbors are close (Reordering.h,
+*		   MultilevelPartition::CellOrder()) most differences and
+*		   weights fit in one byte, so an edge takes 2 to 3 bytes
+*		   against the 8 of a target and a weight. Where each vertex's
+*		   codes start is kept in 2 bytes, as the distance from a 4
+*		   byte start shared by 64 vertices, rather than 4; a graph
+*		   with a group of vertices too dense for that keeps 4.
+*
+*		   Only the adjacency and weights are kept; names and edge
+*		   data stay with the CompactGraph, if it is kept at all.
+*		   Searches read it through ForEachEdge(), which decodes one
+*		   vertex's edges as it walks them, so ShortestRouteOver() and
+*		   the other ForEachEdge engines run on it unchanged. The edge
+*		   id passed to visit is the byte offset of the edge's code.
+*
+*		   A quantum of 1 keeps the weights exact. A larger one rounds
+*		   each weight to a multiple of it, which shortens the codes of
+*		   large weights (driving seconds) at the cost of that much
+*		   error per edge; a weight above 0 never rounds to 0.
+*
+* Manager functions
+*	CompressedGraph()
+*		Creates an empty graph.
+*	~CompressedGraph()
+*		Clears the codes.
+*	CompressedGraph(const CompressedGraph & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const CompressedGraph & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Build(const CompactGraph<V, E> & graph, const int * weights, int quantum)
+*		Encodes graph with the given weights.
+*	GetVertexCount() / GetEdgeCount()
+*		Returns the number of vertices and edges.
+*	GetQuantum()
+*		Returns what the weights were rounded to.
+*	GetByteCount()
+*		Returns the memory the codes and offsets take.
+*	ForEachEdge(int index, Visit visit)
+*		Calls visit(edge, target, weight) for every edge of index.
+*************************************************************************/
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include "CompactGraph.h"
+#include "Exception.h"
+using std::vector;
+using std::pair;
+
+#pragma once
+#ifndef COMPRESSEDGRAPH_H
+#define COMPRESSEDGRAPH_H
+
+class CompressedGraph
+{
+public:
+	CompressedGraph();
+	~CompressedGraph();
+	CompressedGraph(const CompressedGraph & copy);
+	CompressedGraph & operator=(const CompressedGraph & rhs);
+
+	template <typename V, typename E>
+	void Build(const CompactGraph<V, E> & graph, const int * weights, int quantum = 1);
+	int GetVertexCount() const;
+	int GetEdgeCount() const;
+	int GetQuantum() const;
+	long long GetByteCount() const;
+	template <typename Visit>
+	void ForEachEdge(int index, Visit visit) const;
+
+private:
+	vector<uint32_t> m_bases;		//Byte where each group of 64 vertices starts
+	vector<uint16_t> m_starts;		//Where each vertex starts past its group's base, one extra at the end
+	vector<uint32_t> m_offsets;		//Where each vertex starts, instead, when a group is too dense
+	vector<uint8_t> m_codes;		//Varint coded targets and weights
+	int m_vertexCount;
+	int m_edgeCount;
+	int m_quantum;					//Weights are stored divided by this
+
+	uint32_t GetStart(int index) const;
+	static void WriteVarint(vector<uint8_t> & codes, uint32_t value);
+	static uint32_t ReadVarint(const uint8_t * & at);
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty graph.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: There are no vertices.
+************************************************************************/
+inline CompressedGraph::CompressedGraph()
+	: m_offsets(1, 0), m_vertexCount(0), m_edgeCount(0), m_quantum(1)
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the codes.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are empty.
+************************************************************************/
+inline CompressedGraph::~CompressedGraph()
+{
+	m_bases.clear();
+	m_starts.clear();
+	m_offsets.clear();
+	m_codes.clear();
+	m_vertexCount = 0;
+	m_edgeCount = 0;
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+inline CompressedGraph::CompressedGraph(const CompressedGraph & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+inline CompressedGraph & CompressedGraph::operator=(const CompressedGraph & rhs)
+{
+	if (this != &rhs)
+	{
+		m_bases = rhs.m_bases;
+		m_starts = rhs.m_starts;
+		m_offsets = rhs.m_offsets;
+		m_codes = rhs.m_codes;
+		m_vertexCount = rhs.m_vertexCount;
+		m_edgeCount = rhs.m_edgeCount;
+		m_quantum = rhs.m_quantum;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function encodes graph with weights, one per edge id,
+*		   replacing what was held.
+*
+* Precondition:	Every weight is 0 or more, quantum is 1 or more.
+*
+* Postcondition: The graph is encoded; throws if quantum is below 1 or
+*				 the codes would pass 4 GiB.
+************************************************************************/
+template<typename V, typename E>
+void CompressedGraph::Build(const CompactGraph<V, E> & graph, const int * weights, int quantum)
+{
+	const int SIZE = graph.GetVertexCount();
+	vector<pair<int, int>> edges;	//(target, weight) of one vertex, sorted
+
+	if (quantum < 1)
+	{
+		throw Exception("Quantum must be 1 or more");
+	}
+
+	m_quantum = quantum;
+	m_vertexCount = SIZE;
+	m_edgeCount = graph.GetEdgeCount();
+	m_offsets.assign(SIZE + 1, 0);
+	m_codes.clear();
+	m_codes.reserve(static_cast<size_t>(graph.GetEdgeCount()) * 3);
+	for (int v = 0; v < SIZE; v++)
+	{
+		edges.clear();
+		for (int edge = graph.GetEdgeBegin(v); edge != graph.GetEdgeEnd(v); ++edge)
+		{
+			edges.push_back(std::make_pair(graph.GetTarget(edge), weights[edge]));
+		}
+		std::sort(edges.begin(), edges.end());
+
+		int previous = v;
+		for (size_t i = 0; i < edges.size(); i++)
+		{
+			int delta = edges[i].first - previous;
+			if (i == 0)
+			{
+				WriteVarint(m_codes, delta < 0 ? (static_cast<uint32_t>(-(delta + 1)) << 1) | 1 : static_cast<uint32_t>(delta) << 1);
+			}
+			else
+			{
+				WriteVarint(m_codes, static_cast<uint32_t>(delta));
+			}
+			uint32_t weight = static_cast<uint32_t>((static_cast<long long>(edges[i].second) + quantum / 2) / quantum);
+			WriteVarint(m_codes, weight == 0 && edges[i].second > 0 ? 1 : weight);
+			previous = edges[i].first;
+		}
+		if (m_codes.size() > UINT32_MAX)
+		{
+			throw Exception("Graph is too large to compress");
+		}
+		m_offsets[v + 1] = static_cast<uint32_t>(m_codes.size());
+	}
+	m_codes.shrink_to_fit();
+
+	m_bases.assign((SIZE >> 6) + 1, 0);
+	m_starts.assign(SIZE + 1, 0);
+	for (int v = 0; v <= SIZE; v++)
+	{
+		if ((v & 63) == 0)
+		{
+			m_bases[v >> 6] = m_offsets[v];
+		}
+		if (m_offsets[v] - m_bases[v >> 6] > UINT16_MAX)
+		{
+			m_bases.clear();	//Too dense, keep the full offsets
+			m_starts.clear();
+			return;
+		}
+		m_starts[v] = static_cast<uint16_t>(m_offsets[v] - m_bases[v >> 6]);
+	}
+	vector<uint32_t>().swap(m_offsets);
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of vertices.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int CompressedGraph::GetVertexCount() const
+{
+	return m_vertexCount;
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of edges.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int CompressedGraph::GetEdgeCount() const
+{
+	return m_edgeCount;
+}
+
+/**********************************************************************
+* Purpose: This function returns what the weights were rounded to.
+*
+* Precondition:	N/A
+*
+* Postcondition: The quantum is returned, 1 if the weights are exact.
+************************************************************************/
+inline int CompressedGraph::GetQuantum() const
+{
+	return m_quantum;
+}
+
+/**********************************************************************
+* Purpose: This function returns the memory the codes and offsets take,
+*		   to compare with a CompactGraph's targets, weights and offsets.
+*
+* Precondition:	N/A
+*
+* Postcondition: The bytes are returned.
+************************************************************************/
+inline long long CompressedGraph::GetByteCount() const
+{
+	return static_cast<long long>(m_bases.size() * sizeof(uint32_t) + m_starts.size() * sizeof(uint16_t)
+		+ m_offsets.size() * sizeof(uint32_t) + m_codes.size());
+}
+
+/**********************************************************************
+* Purpose: This function calls visit(edge, target, weight) for every
+*		   edge leaving index, decoding them in target order. The first
+*		   edge is decoded apart, so the loop has no zigzag step, and a
+*		   one byte varint, the usual case, is one compare.
+*
+* Precondition:	index is a valid vertex.
+*
+* Postcondition: visit was called once per edge; edge is the byte offset
+*				 of its code.
+************************************************************************/
+template<typename Visit>
+inline void CompressedGraph::ForEachEdge(int index, Visit visit) const
+{
+	const uint8_t * codes = m_codes.data();
+	const uint8_t * at = codes + GetStart(index);
+	const uint8_t * end = codes + GetStart(index + 1);
+
+	if (at == end)
+	{
+		return;
+	}
+
+	const uint8_t * start = at;
+	uint32_t zigzag = ReadVarint(at);
+	int target = index + ((zigzag & 1) ? -static_cast<int>(zigzag >> 1) - 1 : static_cast<int>(zigzag >> 1));
+	visit(static_cast<int>(start - codes), target, static_cast<int>(ReadVarint(at)) * m_quantum);
+	while (at != end)
+	{
+		start = at;
+		target += static_cast<int>(ReadVarint(at));
+		visit(static_cast<int>(start - codes), target, static_cast<int>(ReadVarint(at)) * m_quantum);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function returns the byte where a vertex's codes start.
+*
+* Precondition:	index is 0 to GetVertexCount().
+*
+* Postcondition: The offset is returned.
+************************************************************************/
+inline uint32_t CompressedGraph::GetStart(int index) const
+{
+	return m_offsets.empty() ? m_bases[index >> 6] + m_starts[index] : m_offsets[index];
+}
+
+/**********************************************************************
+* Purpose: This function appends value as a varint: 7 bits a byte, low
+*		   bits first, the high bit set on every byte but the last.
+*
+* Precondition:	N/A
+*
+* Postcondition: 1 to 5 bytes are appended to codes.
+************************************************************************/
+inline void CompressedGraph::WriteVarint(vector<uint8_t> & codes, uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		codes.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	codes.push_back(static_cast<uint8_t>(value));
+}
+
+/**********************************************************************
+* Purpose: This function reads a varint written by WriteVarint().
+*
+* Precondition:	at points to a varint.
+*
+* Postcondition: The value is returned and at is moved past it.
+************************************************************************/
+inline uint32_t CompressedGraph::ReadVarint(const uint8_t * & at)
+{
+	uint32_t value = *at++;
+	if (value < 0x80)
+	{
+		return value;
+	}
+
+	value &= 0x7f;
+	for (int shift = 7; ; shift += 7)
+	{
+		uint32_t next = *at++;
+		value |= (next & 0x7f) << shift;
+		if (next < 0x80)
+		{
+			return value;
+		}
+	}
+}
@@ -0,0 +1,215 @@
+/************************************************************************
+* Class: CopyOnWrite
+*
+* Purpose: This class holds a value that copies share until one of them
+*		   changes it. Copying is one reference count, so copies of a
+*		   CompactGraph made for what-if changes keep pointing at the
+*		   same arrays; only the array a copy writes to is duplicated,
+*		   and only the first time it writes.
+*
+* Manager functions
+*	CopyOnWrite()
+*		Holds a default value.
+*	CopyOnWrite(const T & value)
+*		Holds a copy of value.
+*	~CopyOnWrite()
+*		Lets go of the value, freeing it if nothing else shares it.
+*	CopyOnWrite(const CopyOnWrite<T> & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const CopyOnWrite<T> & rhs)
+*		Shares rhs's value.
+*
+* Methods:
+*	Get() / operator* / operator->
+*		Returns the value to read.
+*	Edit()
+*		Returns the value to change, copying it first if it is shared.
+*	Assign(T && value)
+*		Holds value instead, without copying what was held.
+*	Clear()
+*		Holds a default value instead.
+*	IsShared()
+*		Returns whether another copy holds the same value.
+*************************************************************************/
+#include <memory>
+#include <utility>
+using std::shared_ptr;
+
+#pragma once
+#ifndef COPYONWRITE_H
+#define COPYONWRITE_H
+
+template <typename T>
+class CopyOnWrite
+{
+public:
+	CopyOnWrite();
+	CopyOnWrite(const T & value);
+	~CopyOnWrite();
+	CopyOnWrite(const CopyOnWrite<T> & copy);
+	const CopyOnWrite<T> & operator=(const CopyOnWrite<T> & rhs);
+
+	const T & Get() const;
+	const T & operator*() const;
+	const T * operator->() const;
+	T & Edit();
+	void Assign(T && value);
+	void Clear();
+	bool IsShared() const;
+
+private:
+	shared_ptr<T> m_value;	//Never null; shared by every copy until one edits
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function holds a default value.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The value is T().
+************************************************************************/
+template<typename T>
+inline CopyOnWrite<T>::CopyOnWrite() : m_value(std::make_shared<T>())
+{
+}
+
+/**********************************************************************
+* Purpose: This function holds a copy of value.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The value is a copy of value, not shared.
+************************************************************************/
+template<typename T>
+inline CopyOnWrite<T>::CopyOnWrite(const T & value) : m_value(std::make_shared<T>(value))
+{
+}
+
+/**********************************************************************
+* Purpose: This function lets go of the value.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: The value is freed if no other copy shares it.
+************************************************************************/
+template<typename T>
+inline CopyOnWrite<T>::~CopyOnWrite()
+{
+	m_value.reset();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+template<typename T>
+inline CopyOnWrite<T>::CopyOnWrite(const CopyOnWrite<T> & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function shares rhs's value rather than copying it.
+*
+* Precondition:	N/A
+*
+* Postcondition: This and rhs hold the same value.
+************************************************************************/
+template<typename T>
+inline const CopyOnWrite<T> & CopyOnWrite<T>::operator=(const CopyOnWrite<T> & rhs)
+{
+	if (this != &rhs)
+	{
+		m_value = rhs.m_value;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: These functions return the value to read.
+*
+* Precondition:	N/A
+*
+* Postcondition: The value is returned; it may be shared.
+************************************************************************/
+template<typename T>
+inline const T & CopyOnWrite<T>::Get() const
+{
+	return *m_value;
+}
+
+template<typename T>
+inline const T & CopyOnWrite<T>::operator*() const
+{
+	return *m_value;
+}
+
+template<typename T>
+inline const T * CopyOnWrite<T>::operator->() const
+{
+	return m_value.get();
+}
+
+/**********************************************************************
+* Purpose: This function returns the value to change. A shared value is
+*		   copied first, so the other copies never see the change. The
+*		   reference is only good until this is next copied or assigned.
+*
+* Precondition:	Only one thread edits or copies this at a time.
+*
+* Postcondition: The value is unshared and returned.
+************************************************************************/
+template<typename T>
+inline T & CopyOnWrite<T>::Edit()
+{
+	if (m_value.use_count() > 1)
+	{
+		m_value = std::make_shared<T>(*m_value);
+	}
+	return *m_value;
+}
+
+/**********************************************************************
+* Purpose: This function holds value instead of the current value, for
+*		   rebuilds that make a whole new array.
+*
+* Precondition:	N/A
+*
+* Postcondition: value was moved in and is not shared; copies still hold
+*				 the old value.
+************************************************************************/
+template<typename T>
+inline void CopyOnWrite<T>::Assign(T && value)
+{
+	m_value = std::make_shared<T>(std::move(value));
+}
+
+/**********************************************************************
+* Purpose: This function holds a default value instead.
+*
+* Precondition:	N/A
+*
+* Postcondition: The value is T(), not shared.
+************************************************************************/
+template<typename T>
+inline void CopyOnWrite<T>::Clear()
+{
+	m_value = std::make_shared<T>();
+}
+
+/**********************************************************************
+* Purpose: This function returns whether another copy holds the value.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if an Edit() would copy.
+************************************************************************/
+template<typename T>
+inline bool CopyOnWrite<T>::IsShared() const
+{
+	return m_value.use_count() > 1;
+}
@@ -0,0 +1,323 @@
+/*************************************************************
+* Filename:		DeltaStepping.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Parallel single source shortest paths (Meyer and Sanders delta
+*	stepping). Vertices are kept in buckets of width delta; every
+*	vertex of the lowest bucket is relaxed at once, split across
+*	threads, with an atomic min on the distance array. The threads
+*	are started once per call and kept in a WorkerPool, since one
+*	query runs thousands of short phases. Light edges
+*	(weight <= delta) are relaxed until the bucket stops refilling,
+*	then heavy edges are relaxed once. Each vertex keeps its distance
+*	and predecessor in one 64 bit word, lowered together by a single
+*	compare and swap, so a predecessor always belongs to the distance
+*	beside it. The distances match ShortestPaths() exactly; where two
+*	shortest paths tie the predecessor may differ, but it is always a
+*	shortest path tree. With a SearchStats,
+*	every vertex taken from a bucket counts as a pop and a settle,
+*	so re-settled vertices show up as the extra work they are.
+**************************************************************/
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include "CompactGraph.h"
+#include "ShortestPaths.h"
+#include "Parallel.h"
+using std::vector;
+using std::atomic;
+using std::unique_ptr;
+
+#pragma once
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+template <typename V, typename E>
+int SuggestDelta(const CompactGraph<V, E> & graph);	//Average edge weight, a reasonable default delta
+
+template <typename V, typename E>
+void DeltaStepping(const CompactGraph<V, E> & graph, int source, int delta, int threads, vector<int> & distance, vector<int> & pred,
+	SearchStats * stats = nullptr);	//Parallel distances to every vertex
+
+template <typename V, typename E>
+void RelaxBucket(const CompactGraph<V, E> & graph, const vector<int> & frontier, bool light, int delta, WorkerPool & pool,
+	atomic<uint64_t> * label, vector<vector<int>> & improved);	//Relaxes the light or heavy edges of frontier
+
+int QueueImproved(atomic<uint64_t> * label, int delta, vector<vector<int>> & improved, vector<int> & queued,
+	vector<vector<int>> & buckets);	//Moves lowered vertices into their new buckets
+
+uint64_t PackLabel(int distance, int pred);	//Distance in the high half, predecessor in the low
+int LabelDistance(uint64_t label);
+int LabelPred(uint64_t label);
+bool LowerLabel(atomic<uint64_t> & label, int distance, int pred);	//Sets both if distance is lower, true if it changed
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function returns the average edge weight of the graph,
+*		   which keeps most buckets busy without many re-relaxations.
+*
+* Precondition:	N/A
+*
+* Postcondition: A delta of at least 1 is returned.
+************************************************************************/
+template<typename V, typename E>
+int SuggestDelta(const CompactGraph<V, E> & graph)
+{
+	long long total = 0;
+	for (int edge = 0; edge < graph.GetEdgeCount(); edge++)
+	{
+		total += graph.GetWeight(edge);
+	}
+
+	int delta = 1;
+	if (graph.GetEdgeCount() > 0 && total / graph.GetEdgeCount() > 1)
+	{
+		delta = static_cast<int>(total / graph.GetEdgeCount());
+	}
+	return delta;
+}
+
+/**********************************************************************
+* Purpose: This function calculates the minimum distance from source to
+*		   every vertex, relaxing each bucket with threads workers.
+*
+* Precondition:	source is a valid index of graph, delta >= 1.
+*
+* Postcondition: distance and pred hold one entry per vertex; distance is
+*				 identical to what ShortestPaths() gives. One query is
+*				 added to stats when it is given.
+************************************************************************/
+template<typename V, typename E>
+void DeltaStepping(const CompactGraph<V, E> & graph, int source, int delta, int threads, vector<int> & distance, vector<int> & pred,
+	SearchStats * stats)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (delta < 1)
+	{
+		throw Exception("Delta must be at least 1");
+	}
+	if (threads < 1)
+	{
+		threads = DefaultThreadCount();
+	}
+
+	const int SIZE = graph.GetVertexCount();
+	WorkerPool pool(threads);
+	unique_ptr<atomic<uint64_t>[]> label(new atomic<uint64_t>[SIZE]);	//Distance and predecessor of each vertex
+	vector<vector<int>> buckets(1);			//buckets[i] holds vertices with distance in [i * delta, (i + 1) * delta)
+	vector<int> queued(SIZE, -1);			//Bucket a vertex is waiting in, so it is only queued once
+	vector<vector<int>> improved(threads);	//Vertices each worker lowered in the last phase
+	vector<int> frontier;
+	vector<int> settled;
+	SearchStats counts;
+	bool counting = ROUTING_STATS && stats != nullptr;	//Edge counts cost a pass over each frontier
+	counts.searchSeconds -= StatsClock();
+
+	for (int i = 0; i < SIZE; i++)
+	{
+		label[i].store(PackLabel(INFINITE_DISTANCE, NO_VERTEX), std::memory_order_relaxed);
+	}
+	label[source].store(PackLabel(0, NO_VERTEX), std::memory_order_relaxed);	//Distance from the starting point is always 0
+	buckets[0].push_back(source);
+	queued[source] = 0;
+	STATS_ADD(counts.pushes, 1);
+
+	for (size_t current = 0; current < buckets.size(); current++)
+	{
+		settled.clear();
+
+		//Light edge phases, until nothing new lands in this bucket
+		while (!buckets[current].empty())
+		{
+			frontier.clear();
+			frontier.swap(buckets[current]);
+			for (size_t i = 0; i < frontier.size(); i++)
+			{
+				queued[frontier[i]] = -1;
+				settled.push_back(frontier[i]);
+				if (counting)
+				{
+					STATS_ADD(counts.relaxed, graph.GetEdgeEnd(frontier[i]) - graph.GetEdgeBegin(frontier[i]));
+				}
+			}
+			STATS_ADD(counts.pops, frontier.size());
+			STATS_ADD(counts.settled, frontier.size());
+
+			RelaxBucket(graph, frontier, true, delta, pool, label.get(), improved);
+			int queuedCount = QueueImproved(label.get(), delta, improved, queued, buckets);	//Merge what the workers found into buckets
+			STATS_ADD(counts.pushes, queuedCount);
+		}
+
+		//Heavy edges only once, they can't land back in this bucket
+		RelaxBucket(graph, settled, false, delta, pool, label.get(), improved);
+		int queuedCount = QueueImproved(label.get(), delta, improved, queued, buckets);
+		STATS_ADD(counts.pushes, queuedCount);
+		vector<int>().swap(buckets[current]);	//Give back the memory of finished buckets
+	}
+	counts.searchSeconds += StatsClock();
+	counts.reconstructSeconds -= StatsClock();
+
+	distance.resize(SIZE);
+	pred.resize(SIZE);
+	for (int i = 0; i < SIZE; i++)
+	{
+		uint64_t packed = label[i].load(std::memory_order_relaxed);
+		distance[i] = LabelDistance(packed);
+		pred[i] = LabelPred(packed);
+	}
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		long long reached = 0;
+		for (int i = 0; i < SIZE; i++)
+		{
+			reached += distance[i] != INFINITE_DISTANCE ? 1 : 0;
+		}
+		counts.queries = 1;
+		counts.decreaseKeys = counts.pushes - reached;
+		counts.reconstructSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+}
+
+/**********************************************************************
+* Purpose: This function relaxes either the light (weight <= delta) or the
+*		   heavy edges leaving every vertex of frontier in parallel. A
+*		   vertex whose distance was lowered is recorded in the worker's
+*		   improved list; it may show up more than once.
+*
+* Precondition:	improved holds one empty list per worker of pool.
+*
+* Postcondition: label is lowered along the chosen edges.
+************************************************************************/
+template<typename V, typename E>
+void RelaxBucket(const CompactGraph<V, E> & graph, const vector<int> & frontier, bool light, int delta, WorkerPool & pool,
+	atomic<uint64_t> * label, vector<vector<int>> & improved)
+{
+	const int * targets = graph.GetTargets();
+	const int * weights = graph.GetWeights();
+
+	pool.For(0, static_cast<int>(frontier.size()), [&](int worker, int i)
+	{
+		int from = frontier[i];
+		int base = LabelDistance(label[from].load(std::memory_order_relaxed));
+
+		for (int edge = graph.GetEdgeBegin(from); edge != graph.GetEdgeEnd(from); ++edge)
+		{
+			if ((weights[edge] <= delta) == light)
+			{
+				if (LowerLabel(label[targets[edge]], base + weights[edge], from))
+				{
+					improved[worker].push_back(targets[edge]);
+				}
+			}
+		}
+	});
+}
+
+/**********************************************************************
+* Purpose: This function moves every vertex the workers lowered into the
+*		   bucket of its new distance, skipping ones already waiting there.
+*
+* Precondition:	Workers are finished with label.
+*
+* Postcondition: improved lists are empty, buckets hold the vertices. The
+*				 number of vertices queued is returned.
+************************************************************************/
+inline int QueueImproved(atomic<uint64_t> * label, int delta, vector<vector<int>> & improved, vector<int> & queued,
+	vector<vector<int>> & buckets)
+{
+	int count = 0;
+	for (size_t worker = 0; worker < improved.size(); worker++)
+	{
+		for (size_t i = 0; i < improved[worker].size(); i++)
+		{
+			int vertex = improved[worker][i];
+			int bucket = LabelDistance(label[vertex].load(std::memory_order_relaxed)) / delta;
+			if (queued[vertex] != bucket)
+			{
+				if (bucket >= static_cast<int>(buckets.size()))
+				{
+					buckets.resize(bucket + 1);
+				}
+				buckets[bucket].push_back(vertex);
+				queued[vertex] = bucket;
+				count++;
+			}
+		}
+		improved[worker].clear();
+	}
+	return count;
+}
+
+/**********************************************************************
+* Purpose: This function packs a distance and a predecessor into one
+*		   word, so both can be swapped in by one atomic operation.
+*
+* Precondition:	distance is 0 or more.
+*
+* Postcondition: The packed word is returned.
+************************************************************************/
+inline uint64_t PackLabel(int distance, int pred)
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(distance)) << 32) | static_cast<uint32_t>(pred);
+}
+
+/**********************************************************************
+* Purpose: This function returns the distance half of a packed label.
+*
+* Precondition:	label came from PackLabel().
+*
+* Postcondition: The distance is returned.
+************************************************************************/
+inline int LabelDistance(uint64_t label)
+{
+	return static_cast<int>(label >> 32);
+}
+
+/**********************************************************************
+* Purpose: This function returns the predecessor half of a packed label.
+*
+* Precondition:	label came from PackLabel().
+*
+* Postcondition: The predecessor is returned, NO_VERTEX if there is none.
+************************************************************************/
+inline int LabelPred(uint64_t label)
+{
+	return static_cast<int>(static_cast<uint32_t>(label));
+}
+
+/**********************************************************************
+* Purpose: This function lowers a label to (distance, pred) if distance
+*		   is below the one it holds, retrying when another thread
+*		   changed it in between. Only a strictly lower distance is
+*		   taken, so zero weight edges can't make predecessors a cycle.
+*
+* Precondition:	N/A
+*
+* Postcondition: label holds the lower of the two, true is returned if
+*				 it changed.
+************************************************************************/
+inline bool LowerLabel(atomic<uint64_t> & label, int distance, int pred)
+{
+	uint64_t current = label.load(std::memory_order_relaxed);
+	uint64_t lowered = PackLabel(distance, pred);
+	while (distance < LabelDistance(current))
+	{
+		if (label.compare_exchange_weak(current, lowered, std::memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+#endif
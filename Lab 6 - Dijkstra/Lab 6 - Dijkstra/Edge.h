@@ -42,9 +42,9 @@ public:
 	Edge(const Edge<V, E> & copy);
 	const Edge<V, E> & operator=(const Edge<V, E> & rhs);
 
-	int GetWeight();
-	E GetData();
-	Vertex<V, E>* GetDestination();
+	int GetWeight() const;
+	const E & GetData() const;
+	Vertex<V, E>* GetDestination() const;
 	void SetDestination(Vertex<V, E> *dest);
 
 private:
@@ -75,7 +75,7 @@ inline Edge<V, E>::Edge() : m_weight(0), m_dest(nullptr)
 * Postcondition: members are assigned to passed in values.
 ************************************************************************/
 template<typename V, typename E>
-inline Edge<V, E>::Edge(Vertex<V, E> *dest, E data, int weight) : m_dest(dest), m_weight(weight), m_data(data)
+inline Edge<V, E>::Edge(Vertex<V, E> *dest, E data, int weight) : m_weight(weight), m_data(data), m_dest(dest)
 {
 }
 
@@ -133,7 +133,7 @@ inline const Edge<V, E>& Edge<V, E>::operator=(const Edge<V, E>& rhs)
 * Postcondition: The weight of the edge is accessable.
 ************************************************************************/
 template<typename V, typename E>
-inline int Edge<V, E>::GetWeight()
+inline int Edge<V, E>::GetWeight() const
 {
 	return m_weight;
 }
@@ -146,7 +146,7 @@ inline int Edge<V, E>::GetWeight()
 * Postcondition: The data of the edge is accessable.
 ************************************************************************/
 template<typename V, typename E>
-inline E Edge<V, E>::GetData()
+inline const E & Edge<V, E>::GetData() const
 {
 	return m_data;
 }
@@ -159,7 +159,7 @@ inline E Edge<V, E>::GetData()
 * Postcondition: The destination of the edge is accessable.
 ************************************************************************/
 template<typename V, typename E>
-inline Vertex<V, E>* Edge<V, E>::GetDestination()
+inline Vertex<V, E>* Edge<V, E>::GetDestination() const
 {
 	return m_dest;
 }
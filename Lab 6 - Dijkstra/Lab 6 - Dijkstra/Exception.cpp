@@ -1,10 +1,12 @@
 #include "Exception.h"
+#include <cstring>
 /*************************************************************
 * Author:		Levi Pomeroy
 * Filename:		Exception.cpp
 * Date Created:	1/10/17
 * Modifications:	1/12/17  Fixed ctors to allocate room for message
-**************************************************************\
+*					10/19/26 - Takes const messages, no leak on reassignment
+**************************************************************/
 
 /**********************************************************************
 * Purpose: This function initialized m_msg to nullptr.
@@ -24,23 +26,22 @@ Exception::Exception() :m_msg(nullptr)
 *
 * Postcondition: m_msg is set to msg.
 ************************************************************************/
-Exception::Exception(char * msg) : m_msg(msg)
+Exception::Exception(const char * msg) : m_msg(nullptr)
 {
 	m_msg = new char[strlen(msg) + 1];
 	strcpy(m_msg, msg);
 }
 
 /**********************************************************************
-* Purpose: This function sets m_msg to copy.m_msg, using strcpy.
+* Purpose: This function calls op= to set m_msg to copy.m_msg.
 *
 * Precondition:	m_msg was unassigned.
 *
 * Postcondition: m_msg is set to copy.m_msg.
 ************************************************************************/
-Exception::Exception(const Exception & copy)
+Exception::Exception(const Exception & copy) : m_msg(nullptr)
 {
-	m_msg = new char[strlen(copy.m_msg) + 1];
-	strcpy(m_msg, copy.m_msg);
+	*this = copy;
 }
 
 /**********************************************************************
@@ -67,8 +68,13 @@ Exception & Exception::operator=(const Exception & rhs)
 {
 	if (this != &rhs)
 	{
-		m_msg = new char[strlen(rhs.m_msg) + 1];
-		strcpy(m_msg, rhs.m_msg);
+		delete[] m_msg;
+		m_msg = nullptr;
+		if (rhs.m_msg != nullptr)
+		{
+			m_msg = new char[strlen(rhs.m_msg) + 1];
+			strcpy(m_msg, rhs.m_msg);
+		}
 	}
 	return *this;
 }
@@ -91,8 +97,9 @@ const char * Exception::GetMessage() const
 *
 * Postcondition: m_msg is set to msg.
 ************************************************************************/
-void Exception::SetMessage(char * msg)
+void Exception::SetMessage(const char * msg)
 {
+	delete[] m_msg;
 	m_msg = new char[strlen(msg) + 1];
 	strcpy(m_msg, msg);
 }
@@ -107,5 +114,9 @@ void Exception::SetMessage(char * msg)
 ************************************************************************/
 ostream & operator<<(ostream & stream, const Exception & except)
 {
-	return stream << except.m_msg;
+	if (except.m_msg != nullptr)
+	{
+		stream << except.m_msg;
+	}
+	return stream;
 }
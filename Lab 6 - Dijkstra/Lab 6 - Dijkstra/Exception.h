@@ -9,7 +9,7 @@ using std::ostream;
 * Manager functions:
 * 	Exception ()
 * 		The default msg is set to nullptr.
-*	Exception (char * msg)
+*	Exception (const char * msg)
 *		Assigns the m_msg to msg.
 *	Exception (const Exception & copy)
 *		Sets m_msg to copy.m_msg, using string copy.
@@ -22,7 +22,7 @@ using std::ostream;
 Methods:
 *	GetMessage() const
 *		Returns m_msg;
-*	SetMessage(char * msg)
+*	SetMessage(const char * msg)
 *		Sets m_msg to msg;
 *	operator<<
 *		Overloads the ouptut operator to allow simple output of an exception.
@@ -37,13 +37,13 @@ private:
 
 public:
 	Exception();	//Default constructor
-	Exception(char * msg);	//Sets m_msg to msg
+	Exception(const char * msg);	//Sets m_msg to msg
 	Exception(const Exception & copy);	//Copy constructor
 	~Exception();	//Destructor
 	Exception & operator=(const Exception & rhs);	//Assignment operator
 	const char * GetMessage() const;	//Gets m_msg
-	void SetMessage(char * msg);	//Set m_msg to msg
+	void SetMessage(const char * msg);	//Set m_msg to msg
 	friend ostream & operator<< (ostream & stream, const Exception & except);	//Output operator
 };
 
-#endif;
+#endif
@@ -0,0 +1,645 @@
+/************************************************************************
+* Class: ExternalGraph
+*
+* Purpose: This class searches a graph too big for memory straight from
+*		   a file. Write() lays a CompactGraph out on disk once; Open()
+*		   memory maps the file read only, so the graph's pages are
+*		   loaded as a search touches them and dropped by the system
+*		   when memory runs short, instead of the process running out
+*		   of it. Queries get slower as less of the file stays cached,
+*		   rather than failing.
+*
+*		   Only the searches work out of core. Write() is not a
+*		   streaming writer: it takes the whole CompactGraph and orders
+*		   its vertices in memory, so the file has to be built on a
+*		   machine that can hold the graph and then copied to the ones
+*		   that search it.
+*
+*		   The file holds, after a header, the offset of every
+*		   vertex's first edge, the vertex order, and the edges as
+*		   (target, weight) pairs cut into fixed size blocks (64 KiB,
+*		   aligned to the pages). A vertex's edges never straddle two
+*		   blocks unless there are more than a block holds. Vertices
+*		   are written in an order that keeps neighbors near each
+*		   other (reverse Cuthill-McKee unless one is given), so the
+*		   edges a search needs next are mostly in blocks it already
+*		   loaded. The slots left empty at the end of a block have
+*		   target NO_VERTEX, which also ends the edges of the vertex
+*		   before them. Vertices are numbered by that order in the file;
+*		   GetFileIndex() and GetOriginalIndex() translate.
+*
+*		   Searches read it through ForEachEdge() like a CompactGraph,
+*		   so ShortestRouteOver() runs on it as is. Route() also asks
+*		   the system to start reading a block as soon as the search
+*		   first reaches a vertex in it (madvise, or
+*		   PrefetchVirtualMemory on Windows), so by the time the vertex
+*		   is settled its edges are usually in memory. Edge ids are
+*		   slots in the edge blocks, so they are not all used.
+*
+* Manager functions
+*	ExternalGraph()
+*		Creates a graph with no file open.
+*	ExternalGraph(const string & filename)
+*		Opens a file written by Write().
+*	~ExternalGraph()
+*		Unmaps the file.
+*	ExternalGraph(const ExternalGraph & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const ExternalGraph & rhs)
+*		Maps the same file as rhs.
+*
+* Methods:
+*	Write(const CompactGraph<V, E> & graph, const int * weights, const vector<int> & order, const string & filename)
+*		Writes graph with the given weights in the given order.
+*	Open(const string & filename) / Close() / IsOpen()
+*		Maps a file, unmaps it, or returns whether one is mapped.
+*	GetVertexCount() / GetEdgeCount() / GetBlockCount()
+*		Returns the vertices, edges and edge blocks of the file.
+*	GetBlock(int vertex)
+*		Returns the block holding a vertex's edges.
+*	GetFileIndex(int original) / GetOriginalIndex(int vertex)
+*		Translates between the CompactGraph's and the file's indices.
+*	ForEachEdge(int index, Visit visit)
+*		Calls visit(edge, target, weight) for every edge of index.
+*	Prefetch(int block)
+*		Asks the system to start reading a block.
+*	Route(int source, int target, SearchWorkspace & workspace, vector<int> & path, SearchStats * stats)
+*		Finds the shortest route, prefetching blocks ahead of the search.
+*************************************************************************/
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <climits>
+#include "CompactGraph.h"
+#include "Reordering.h"
+#include "Bitmap.h"
+#include "ShortestPaths.h"
+#include "SearchWorkspace.h"
+#include "SearchStats.h"
+#include "Exception.h"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#undef GetMessage	//windows.h renames it, which breaks Exception::GetMessage
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+using std::vector;
+using std::string;
+using std::ofstream;
+using std::ios;
+
+#pragma once
+#ifndef EXTERNALGRAPH_H
+#define EXTERNALGRAPH_H
+
+const int EXTERNAL_BLOCK_BYTES = 64 * 1024;	//Edge block size, a multiple of every page size
+
+struct ExternalHeader
+{
+	char magic[8];			//"RGRAPH1"
+	int vertexCount;
+	int edgeCount;
+	int blockBytes;
+	int blockCount;
+	long long offsetsAt;	//Where each section starts in the file
+	long long orderAt;
+	long long inverseAt;
+	long long edgesAt;
+	long long fileBytes;
+};
+
+struct ExternalEdge
+{
+	int target;
+	int weight;
+};
+
+class ExternalGraph
+{
+public:
+	ExternalGraph();
+	ExternalGraph(const string & filename);
+	~ExternalGraph();
+	ExternalGraph(const ExternalGraph & copy);
+	ExternalGraph & operator=(const ExternalGraph & rhs);
+
+	template <typename V, typename E>
+	static void Write(const CompactGraph<V, E> & graph, const int * weights, const vector<int> & order, const string & filename);
+	void Open(const string & filename);
+	void Close();
+	bool IsOpen() const;
+	int GetVertexCount() const;
+	int GetEdgeCount() const;
+	int GetBlockCount() const;
+	int GetBlock(int vertex) const;
+	int GetFileIndex(int original) const;
+	int GetOriginalIndex(int vertex) const;
+	template <typename Visit>
+	void ForEachEdge(int index, Visit visit) const;
+	void Prefetch(int block) const;
+	int Route(int source, int target, SearchWorkspace & workspace, vector<int> & path, SearchStats * stats = nullptr) const;
+
+private:
+	/************************************************************************
+	* Class: Prefetching
+	*
+	* Purpose: The graph as Route() searches it: the first time the
+	*		   search reaches a vertex of a block not asked for yet, the
+	*		   block is prefetched.
+	*************************************************************************/
+	class Prefetching
+	{
+	public:
+		Prefetching(const ExternalGraph & graph, Bitmap & asked) : m_graph(&graph), m_asked(&asked) {}
+		int GetVertexCount() const { return m_graph->GetVertexCount(); }
+		template <typename Visit>
+		void ForEachEdge(int index, Visit visit) const
+		{
+			m_graph->ForEachEdge(index, [&](int edge, int target, int weight)
+			{
+				int block = m_graph->GetBlock(target);
+				if (!m_asked->Test(block))
+				{
+					m_asked->Set(block);
+					m_graph->Prefetch(block);
+				}
+				visit(edge, target, weight);
+			});
+		}
+
+	private:
+		const ExternalGraph * m_graph;
+		Bitmap * m_asked;		//Blocks prefetched this query
+	};
+
+	string m_filename;					//File mapped, empty if none
+	char * m_base;						//Start of the mapping
+	long long m_bytes;					//Length of the mapping
+	const ExternalHeader * m_header;
+	const int * m_offsets;				//Slot of each vertex's first edge, one extra at the end
+	const int * m_order;				//Original index of each vertex
+	const int * m_inverse;				//File index of each original index
+	const ExternalEdge * m_edges;		//Edge slots, block after block
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates a graph with no file open.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: members are null.
+************************************************************************/
+inline ExternalGraph::ExternalGraph()
+	: m_base(nullptr), m_bytes(0), m_header(nullptr), m_offsets(nullptr), m_order(nullptr), m_inverse(nullptr), m_edges(nullptr)
+{
+}
+
+/**********************************************************************
+* Purpose: This function opens a file written by Write().
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The file is mapped; throws if it can't be.
+************************************************************************/
+inline ExternalGraph::ExternalGraph(const string & filename)
+	: m_base(nullptr), m_bytes(0), m_header(nullptr), m_offsets(nullptr), m_order(nullptr), m_inverse(nullptr), m_edges(nullptr)
+{
+	Open(filename);
+}
+
+/**********************************************************************
+* Purpose: This function unmaps the file.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are null.
+************************************************************************/
+inline ExternalGraph::~ExternalGraph()
+{
+	Close();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+inline ExternalGraph::ExternalGraph(const ExternalGraph & copy)
+	: m_base(nullptr), m_bytes(0), m_header(nullptr), m_offsets(nullptr), m_order(nullptr), m_inverse(nullptr), m_edges(nullptr)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function maps the file rhs has mapped. The pages are
+*		   the system's, so both share them.
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+inline ExternalGraph & ExternalGraph::operator=(const ExternalGraph & rhs)
+{
+	if (this != &rhs)
+	{
+		Close();
+		if (rhs.IsOpen())
+		{
+			Open(rhs.m_filename);
+		}
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function writes graph to filename for Open(): the
+*		   header, each vertex's first edge slot, the order and its
+*		   inverse, then the edges block by block. A vertex whose edges
+*		   would cross into the next block starts that block instead,
+*		   so loading one vertex loads one block.
+*
+* Precondition:	weights holds one weight per edge id of graph; order is
+*				empty or a permutation of the vertices, as for
+*				CompactGraph::Reorder(). The whole graph is in memory,
+*				with room for about three more ints per vertex besides;
+*				the edges are written out a block at a time.
+*
+* Postcondition: The file is written; throws if it can't be, or if the
+*				 graph needs more edge slots than an int counts.
+************************************************************************/
+template<typename V, typename E>
+void ExternalGraph::Write(const CompactGraph<V, E> & graph, const int * weights, const vector<int> & order, const string & filename)
+{
+	const int SIZE = graph.GetVertexCount();
+	const int SLOTS = EXTERNAL_BLOCK_BYTES / static_cast<int>(sizeof(ExternalEdge));	//Edge slots per block
+	const vector<int> & sequence = order.empty() ? CuthillMcKeeOrder(graph) : order;
+	vector<int> inverse(SIZE, NO_VERTEX);
+	vector<int> offsets(SIZE + 1);
+	long long slot = 0;
+
+	if (static_cast<int>(sequence.size()) != SIZE)
+	{
+		throw Exception("Order does not match the graph");
+	}
+	for (int i = 0; i < SIZE; i++)
+	{
+		inverse[sequence[i]] = i;
+	}
+	for (int i = 0; i < SIZE; i++)
+	{
+		int degree = graph.GetEdgeEnd(sequence[i]) - graph.GetEdgeBegin(sequence[i]);
+		if (slot % SLOTS != 0 && slot % SLOTS + degree > SLOTS && degree <= SLOTS)
+		{
+			slot += SLOTS - slot % SLOTS;	//Start the next block
+		}
+		offsets[i] = static_cast<int>(slot);
+		slot += degree;
+		if (slot > INT_MAX - SLOTS)
+		{
+			throw Exception("Graph is too large for one file");
+		}
+	}
+	offsets[SIZE] = static_cast<int>(slot);
+
+	ExternalHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, "RGRAPH1", 8);
+	header.vertexCount = SIZE;
+	header.edgeCount = graph.GetEdgeCount();
+	header.blockBytes = EXTERNAL_BLOCK_BYTES;
+	header.blockCount = static_cast<int>((slot + SLOTS - 1) / SLOTS);
+	header.offsetsAt = sizeof(ExternalHeader);
+	header.orderAt = header.offsetsAt + static_cast<long long>(SIZE + 1) * sizeof(int);
+	header.inverseAt = header.orderAt + static_cast<long long>(SIZE) * sizeof(int);
+	header.edgesAt = (header.inverseAt + static_cast<long long>(SIZE) * sizeof(int) + EXTERNAL_BLOCK_BYTES - 1)
+		/ EXTERNAL_BLOCK_BYTES * EXTERNAL_BLOCK_BYTES;
+	header.fileBytes = header.edgesAt + static_cast<long long>(header.blockCount) * EXTERNAL_BLOCK_BYTES;
+
+	ofstream out;
+	out.open(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!out.is_open())
+	{
+		throw Exception("Error opening file!");
+	}
+	out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char *>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(int)));
+	out.write(reinterpret_cast<const char *>(sequence.data()), static_cast<std::streamsize>(sequence.size() * sizeof(int)));
+	out.write(reinterpret_cast<const char *>(inverse.data()), static_cast<std::streamsize>(inverse.size() * sizeof(int)));
+
+	const ExternalEdge EMPTY = { NO_VERTEX, 0 };
+	vector<ExternalEdge> block;		//Edges of the block being filled
+	long long filled = 0;			//Edge slots written or in block
+	auto put = [&](const ExternalEdge & entry)
+	{
+		block.push_back(entry);
+		filled++;
+		if (static_cast<int>(block.size()) == SLOTS)
+		{
+			out.write(reinterpret_cast<const char *>(block.data()), EXTERNAL_BLOCK_BYTES);
+			block.clear();
+		}
+	};
+
+	block.reserve(SLOTS);
+	for (long long at = header.inverseAt + static_cast<long long>(SIZE) * sizeof(int); at < header.edgesAt; at++)
+	{
+		out.put(0);		//Blocks start on a block boundary of the file
+	}
+	for (int i = 0; i <= SIZE; i++)
+	{
+		long long next = i < SIZE ? offsets[i] : static_cast<long long>(header.blockCount) * SLOTS;
+		while (filled < next)
+		{
+			put(EMPTY);
+		}
+		if (i < SIZE)
+		{
+			for (int edge = graph.GetEdgeBegin(sequence[i]); edge != graph.GetEdgeEnd(sequence[i]); ++edge)
+			{
+				ExternalEdge entry = { inverse[graph.GetTarget(edge)], weights[edge] };
+				put(entry);
+			}
+		}
+	}
+	if (!out)
+	{
+		throw Exception("Error writing file!");
+	}
+	out.close();
+}
+
+/**********************************************************************
+* Purpose: This function maps a file written by Write(), read only. The
+*		   edge blocks are marked for random access, so a fault loads
+*		   one page rather than the system's readahead window; Route()
+*		   asks for whole blocks itself.
+*
+* Precondition:	N/A
+*
+* Postcondition: The file is mapped, replacing any mapped before; throws
+*				 if it can't be opened or isn't a graph file.
+************************************************************************/
+inline void ExternalGraph::Open(const string & filename)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+	LARGE_INTEGER size;
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw Exception("Error opening file!");
+	}
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<long long>(sizeof(ExternalHeader)))
+	{
+		CloseHandle(file);
+		throw Exception("Not a graph file");
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void * base = mapping == nullptr ? nullptr : MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (mapping != nullptr)
+	{
+		CloseHandle(mapping);	//The view keeps the mapping alive
+	}
+	CloseHandle(file);
+	if (base == nullptr)
+	{
+		throw Exception("Error mapping file!");
+	}
+	m_bytes = size.QuadPart;
+#else
+	int file = open(filename.c_str(), O_RDONLY);
+	struct stat info;
+	if (file < 0)
+	{
+		throw Exception("Error opening file!");
+	}
+	if (fstat(file, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(ExternalHeader)))
+	{
+		close(file);
+		throw Exception("Not a graph file");
+	}
+	void * base = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, file, 0);
+	close(file);	//The mapping keeps the file open
+	if (base == MAP_FAILED)
+	{
+		throw Exception("Error mapping file!");
+	}
+	m_bytes = info.st_size;
+#endif
+
+	m_base = static_cast<char *>(base);
+	m_filename = filename;
+	m_header = reinterpret_cast<const ExternalHeader *>(m_base);
+	if (std::memcmp(m_header->magic, "RGRAPH1", 8) != 0 || m_header->fileBytes != m_bytes
+		|| m_header->blockBytes != EXTERNAL_BLOCK_BYTES || m_header->edgesAt % EXTERNAL_BLOCK_BYTES != 0)
+	{
+		Close();
+		throw Exception("Not a graph file");
+	}
+	m_offsets = reinterpret_cast<const int *>(m_base + m_header->offsetsAt);
+	m_order = reinterpret_cast<const int *>(m_base + m_header->orderAt);
+	m_inverse = reinterpret_cast<const int *>(m_base + m_header->inverseAt);
+	m_edges = reinterpret_cast<const ExternalEdge *>(m_base + m_header->edgesAt);
+#ifndef _WIN32
+	madvise(m_base + m_header->edgesAt, static_cast<size_t>(m_bytes - m_header->edgesAt), MADV_RANDOM);
+#endif
+}
+
+/**********************************************************************
+* Purpose: This function unmaps the file, if one is mapped.
+*
+* Precondition:	N/A
+*
+* Postcondition: No file is mapped.
+************************************************************************/
+inline void ExternalGraph::Close()
+{
+	if (m_base != nullptr)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m_base);
+#else
+		munmap(m_base, static_cast<size_t>(m_bytes));
+#endif
+	}
+	m_filename.clear();
+	m_base = nullptr;
+	m_bytes = 0;
+	m_header = nullptr;
+	m_offsets = nullptr;
+	m_order = nullptr;
+	m_inverse = nullptr;
+	m_edges = nullptr;
+}
+
+/**********************************************************************
+* Purpose: This function returns whether a file is mapped.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if a file is mapped.
+************************************************************************/
+inline bool ExternalGraph::IsOpen() const
+{
+	return m_base != nullptr;
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of vertices.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned, 0 with no file.
+************************************************************************/
+inline int ExternalGraph::GetVertexCount() const
+{
+	return m_header == nullptr ? 0 : m_header->vertexCount;
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of edges.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned, 0 with no file.
+************************************************************************/
+inline int ExternalGraph::GetEdgeCount() const
+{
+	return m_header == nullptr ? 0 : m_header->edgeCount;
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of edge blocks.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned, 0 with no file.
+************************************************************************/
+inline int ExternalGraph::GetBlockCount() const
+{
+	return m_header == nullptr ? 0 : m_header->blockCount;
+}
+
+/**********************************************************************
+* Purpose: This function returns the block holding the first edge of a
+*		   vertex (its only block, unless it has more edges than one
+*		   holds).
+*
+* Precondition:	vertex is a valid file index.
+*
+* Postcondition: The block is returned.
+************************************************************************/
+inline int ExternalGraph::GetBlock(int vertex) const
+{
+	return m_offsets[vertex] / (EXTERNAL_BLOCK_BYTES / static_cast<int>(sizeof(ExternalEdge)));
+}
+
+/**********************************************************************
+* Purpose: This function returns the file index of a vertex of the
+*		   CompactGraph the file was written from.
+*
+* Precondition:	original is a valid index of that graph.
+*
+* Postcondition: The file index is returned.
+************************************************************************/
+inline int ExternalGraph::GetFileIndex(int original) const
+{
+	return m_inverse[original];
+}
+
+/**********************************************************************
+* Purpose: This function returns the index a vertex had in the
+*		   CompactGraph the file was written from.
+*
+* Precondition:	vertex is a valid file index.
+*
+* Postcondition: The original index is returned.
+************************************************************************/
+inline int ExternalGraph::GetOriginalIndex(int vertex) const
+{
+	return m_order[vertex];
+}
+
+/**********************************************************************
+* Purpose: This function calls visit(edge, target, weight) for every
+*		   edge leaving index, read from the mapped blocks.
+*
+* Precondition:	index is a valid file index.
+*
+* Postcondition: visit was called once per edge; edge is its slot.
+************************************************************************/
+template<typename Visit>
+inline void ExternalGraph::ForEachEdge(int index, Visit visit) const
+{
+	for (int edge = m_offsets[index]; edge != m_offsets[index + 1] && m_edges[edge].target != NO_VERTEX; ++edge)
+	{
+		visit(edge, m_edges[edge].target, m_edges[edge].weight);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function asks the system to start reading a block into
+*		   memory without waiting for it. Blocks already in memory cost
+*		   one system call.
+*
+* Precondition:	block is 0 or more.
+*
+* Postcondition: The read is started, unless the block is past the end
+*				 (the block of a vertex with no edges can be).
+************************************************************************/
+inline void ExternalGraph::Prefetch(int block) const
+{
+	if (block >= GetBlockCount())
+	{
+		return;
+	}
+
+	char * start = m_base + m_header->edgesAt + static_cast<long long>(block) * EXTERNAL_BLOCK_BYTES;
+#ifdef _WIN32
+#if _WIN32_WINNT >= 0x0602
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = start;
+	range.NumberOfBytes = EXTERNAL_BLOCK_BYTES;
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+	(void)start;	//PrefetchVirtualMemory needs Windows 8
+#endif
+#else
+	madvise(start, EXTERNAL_BLOCK_BYTES, MADV_WILLNEED);
+#endif
+}
+
+/**********************************************************************
+* Purpose: This function finds the shortest route from source to target
+*		   (file indices), prefetching each block when the search first
+*		   reaches a vertex in it, so the read overlaps the settling of
+*		   the vertices ahead of it in the queue.
+*
+* Precondition:	A file is mapped.
+*
+* Postcondition: path holds the file indices from source to target
+*				 (empty if target can't be reached) and the distance is
+*				 returned, INFINITE_DISTANCE if target can't be reached.
+************************************************************************/
+inline int ExternalGraph::Route(int source, int target, SearchWorkspace & workspace, vector<int> & path, SearchStats * stats) const
+{
+	Bitmap asked(GetBlockCount() + 1);	//Vertices with no edges at the end are past the last block
+
+	if (source >= 0 && source < GetVertexCount())
+	{
+		asked.Set(GetBlock(source));
+		Prefetch(GetBlock(source));
+	}
+	return ShortestRouteOver(Prefetching(*this, asked), source, target, workspace, path, stats);
+}
@@ -12,7 +12,9 @@
 *	Graph(const Graph<V, E> & copy)
 *		Calls op= to handle the assignment of the copy.
 *	operator=(const Graph<V, E> & rhs)
-*		Sets this to rhs, and all of its data members
+*		Sets this to rhs, and all of its data members, in one pass.
+*	Graph(Graph<V, E> && other) / operator=(Graph<V, E> && rhs)
+*		Takes the vertices of other without copying them.
 *
 * Methods:
 * 	InsertVertex(V data)
@@ -31,21 +33,25 @@
 *		Adds an edge between two vertices.
 *	RemoveEdge(V from, V to)
 *		Removes an edge between two vertices.
-*	DepthFirst(void(*visit)(V data))
-*		Traverses the graph by depth first order.
-*	BreadthFirst(void(*visit)(V data))
-*		Traverses the graph by breadthfirst order.
+*	DepthFirst(Visit visit)
+*		Traverses the graph by depth first order, calling visit(data).
+*	BreadthFirst(Visit visit)
+*		Traverses the graph by breadthfirst order, calling visit(data).
 *************************************************************************/
 #include <list>
 #include <stack>
 #include <queue>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
 #include "Vertex.h"
 #include "Exception.h"
-using std::iterator;
 using std::list;
 using std::stack;
 using std::queue;
-using std::iterator;
+using std::unordered_map;
+using std::cout;
+using std::endl;
 
 #pragma once
 #ifndef GRAPH_H
@@ -57,8 +63,10 @@ class Graph
 public:
 	Graph();
 	~Graph();
-	Graph(Graph<V, E> & copy);
-	const Graph<V, E> & operator=(Graph<V, E> & rhs);
+	Graph(const Graph<V, E> & copy);
+	const Graph<V, E> & operator=(const Graph<V, E> & rhs);
+	Graph(Graph<V, E> && other);
+	const Graph<V, E> & operator=(Graph<V, E> && rhs);
 
 	void InsertVertex(V data);
 	void RemoveVertex(V data);
@@ -70,8 +78,10 @@ public:
 	void RemoveEdge(V from, V to);
 	const int GetCount();
 
-	void DepthFirst(void(*visit)(V data));
-	void BreadthFirst(void(*visit)(V data));
+	template <typename Visit>
+	void DepthFirst(Visit visit);
+	template <typename Visit>
+	void BreadthFirst(Visit visit);
 
 private:
 	list<Vertex<V, E>> m_vertices;	//List of vertices
@@ -114,44 +124,46 @@ inline Graph<V, E>::~Graph()
 * Postcondition: copy's members are assigned.
 ************************************************************************/
 template<typename V, typename E>
-inline Graph<V, E>::Graph(Graph<V, E>& copy)
+inline Graph<V, E>::Graph(const Graph<V, E>& copy) : m_count(0)
 {
 	*this = copy;
 }
 
 /**********************************************************************
-* Purpose: This function sets this's members to rhs's members
+* Purpose: This function sets this's members to rhs's members. Vertices
+*		   are copied in order first, remembering where each one went,
+*		   then every edge is copied as it is with its destination
+*		   pointed at the new vertex. rhs already holds both directions
+*		   of every road, so nothing goes through AddEdge(), which would
+*		   search the list for both ends and add each road twice more.
 *
 * Precondition:	rhs members were unassigned.
 *
-* Postcondition: rhs members are assigned.
+* Postcondition: rhs members are assigned; no vertex is processed.
 ************************************************************************/
 template<typename V, typename E>
-inline const Graph<V, E>& Graph<V, E>::operator=(Graph<V, E> & rhs)
+inline const Graph<V, E>& Graph<V, E>::operator=(const Graph<V, E> & rhs)
 {
 	if (this != &rhs)
 	{
-		m_vertices.clear();
+		unordered_map<const Vertex<V, E> *, Vertex<V, E> *> position;	//rhs's vertex to its copy in this
+		typename list<Vertex<V, E>>::const_iterator viter;
+		typename list<Edge<V, E>>::const_iterator eiter;
+		typename list<Vertex<V, E>>::iterator copy;
 
 		m_vertices.clear();
-		Vertex<V, E> * temp = nullptr;
-		Edge<V, E> * edge_temp = nullptr;
-		list<Vertex<V, E>>::iterator viter;
-		list<Edge<V, E>>::iterator eiter;
-
+		position.reserve(rhs.m_vertices.size());
 		for (viter = rhs.m_vertices.begin(); viter != rhs.m_vertices.end(); ++viter)
 		{
-			temp = &(*viter);
-			InsertVertex(temp->GetData());
+			m_vertices.push_back(Vertex<V, E>(viter->GetData()));
+			position[&(*viter)] = &m_vertices.back();
 		}
 
-		for (viter = rhs.m_vertices.begin(); viter != rhs.m_vertices.end(); ++viter)
+		for (viter = rhs.m_vertices.begin(), copy = m_vertices.begin(); viter != rhs.m_vertices.end(); ++viter, ++copy)
 		{
-			temp = &(*viter);
-			for (eiter = temp->GetEdges().begin(); eiter != temp->GetEdges().end();++eiter)
+			for (eiter = viter->GetEdges().begin(); eiter != viter->GetEdges().end(); ++eiter)
 			{
-				edge_temp = &(*eiter);
-				AddEdge(temp->GetData(), edge_temp->GetDestination()->GetData(), edge_temp->GetData(), edge_temp->GetWeight());
+				copy->GetEdges().push_back(Edge<V, E>(position[eiter->GetDestination()], eiter->GetData(), eiter->GetWeight()));
 			}
 		}
 		m_count = rhs.m_count;
@@ -159,6 +171,43 @@ inline const Graph<V, E>& Graph<V, E>::operator=(Graph<V, E> & rhs)
 	return *this;
 }
 
+/**********************************************************************
+* Purpose: This function takes other's vertices without copying them.
+*		   list nodes keep their addresses when the list is moved, so
+*		   every edge still points at the right vertex.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: This holds other's graph; other is empty.
+************************************************************************/
+template<typename V, typename E>
+inline Graph<V, E>::Graph(Graph<V, E> && other) : m_vertices(std::move(other.m_vertices)), m_count(other.m_count)
+{
+	other.m_vertices.clear();
+	other.m_count = 0;
+}
+
+/**********************************************************************
+* Purpose: This function takes rhs's vertices without copying them,
+*		   freeing this's own.
+*
+* Precondition:	N/A
+*
+* Postcondition: This holds rhs's graph; rhs is empty.
+************************************************************************/
+template<typename V, typename E>
+inline const Graph<V, E>& Graph<V, E>::operator=(Graph<V, E> && rhs)
+{
+	if (this != &rhs)
+	{
+		m_vertices = std::move(rhs.m_vertices);
+		m_count = rhs.m_count;
+		rhs.m_vertices.clear();
+		rhs.m_count = 0;
+	}
+	return *this;
+}
+
 /**********************************************************************
 * Purpose: This function inserts a vertex into the graph.
 *
@@ -170,7 +219,7 @@ template<typename V, typename E>
 inline void Graph<V, E>::InsertVertex(V data)
 {
 	Vertex<V, E> * temp = nullptr;
-	list<Vertex<V, E>>::iterator viter;
+	typename list<Vertex<V, E>>::iterator viter;
 	bool already_exists = false;
 	for (viter = m_vertices.begin(); viter != m_vertices.end(); ++viter)
 	{
@@ -205,10 +254,10 @@ inline void Graph<V, E>::RemoveVertex(V data)
 	bool found = false;
 	Vertex<V, E> * temp = nullptr;
 	Edge<V, E> * edge_temp = nullptr;
-	list<Edge<V, E>>::iterator eiter;
+	typename list<Edge<V, E>>::iterator eiter;
 	Vertex<V, E> * vto = nullptr;
 
-	for (list<Vertex<V, E>>::iterator viter = m_vertices.begin(); found != true && viter != m_vertices.end(); ++viter)
+	for (typename list<Vertex<V, E>>::iterator viter = m_vertices.begin(); found != true && viter != m_vertices.end(); ++viter)
 	{
 		temp = &(*viter);
 
@@ -276,7 +325,7 @@ inline void Graph<V, E>::Reset()
 	}
 
 	Vertex<V, E> * temp = nullptr;
-	for (list<Vertex<V, E>>::iterator viter = m_vertices.begin(); viter != m_vertices.end(); ++viter)
+	for (typename list<Vertex<V, E>>::iterator viter = m_vertices.begin(); viter != m_vertices.end(); ++viter)
 	{
 		temp = &(*viter);
 		temp->SetProcessed(false);
@@ -316,7 +365,7 @@ inline void Graph<V, E>::PrintGraph()
 	}
 
 	Vertex<V, E> * temp = nullptr;
-	list<Vertex<V, E>>::iterator viter;
+	typename list<Vertex<V, E>>::iterator viter;
 	int i = 1;
 	for (viter = m_vertices.begin(); viter != m_vertices.end(); ++viter)
 	{
@@ -352,7 +401,7 @@ inline void Graph<V, E>::AddEdge(V from, V to, E data, int weight)
 	bool found = false;
 
 	Vertex<V, E> * temp = nullptr;
-	list<Vertex<V, E>>::iterator viter;
+	typename list<Vertex<V, E>>::iterator viter;
 	for (viter = m_vertices.begin(); viter != m_vertices.end(); ++viter)
 	{
 		temp = &(*viter);
@@ -403,7 +452,7 @@ inline void Graph<V, E>::RemoveEdge(V from, V to)
 	bool found_to = false;
 
 	Vertex<V, E> * temp = nullptr;
-	list<Vertex<V, E>>::iterator viter;
+	typename list<Vertex<V, E>>::iterator viter;
 	for (viter = m_vertices.begin(); viter != m_vertices.end(); ++viter)
 	{
 		temp = &(*viter);
@@ -415,7 +464,7 @@ inline void Graph<V, E>::RemoveEdge(V from, V to)
 	}
 
 	Edge<V, E> * edge_temp = nullptr;
-	list<Edge<V, E>>::iterator eiter;
+	typename list<Edge<V, E>>::iterator eiter;
 	for (eiter = vfrom->GetEdges().begin(); found_to != true && eiter != vfrom->GetEdges().end(); ++eiter)
 	{
 		edge_temp = &(*eiter);
@@ -473,14 +522,18 @@ inline const int Graph<V, E>::GetCount()
 }
 
 /**********************************************************************
-* Purpose: This function traverses the graph in depth first order.
+* Purpose: This function traverses the graph in depth first order. visit
+*		   is any callable taking the vertex data (a lambda, a function
+*		   pointer); it is a template so the call can be inlined, and
+*		   the data is passed by const reference, not copied.
 *
 * Precondition:	N/A.
 *
 * Postcondition: N/A.
 ************************************************************************/
 template<typename V, typename E>
-inline void Graph<V, E>::DepthFirst(void(*visit)(V data))
+template<typename Visit>
+inline void Graph<V, E>::DepthFirst(Visit visit)
 {
 	if (IsEmpty())
 	{
@@ -489,8 +542,8 @@ inline void Graph<V, E>::DepthFirst(void(*visit)(V data))
 
 	stack<Vertex<V, E>*> vstack;
 	Vertex<V, E> * temp = nullptr;
-	list<Vertex<V, E>>::iterator viter;
-	list<Edge<V, E>>::iterator eiter;
+	typename list<Vertex<V, E>>::iterator viter;
+	typename list<Edge<V, E>>::iterator eiter;
 
 	for (viter = m_vertices.begin(); viter != m_vertices.end(); ++viter)
 	{
@@ -525,14 +578,16 @@ inline void Graph<V, E>::DepthFirst(void(*visit)(V data))
 }
 
 /**********************************************************************
-* Purpose: This function traverses the graph in breadth first order.
+* Purpose: This function traverses the graph in breadth first order,
+*		   calling visit like DepthFirst() does.
 *
 * Precondition:	N/A.
 *
 * Postcondition: N/A.
 ************************************************************************/
 template<typename V, typename E>
-inline void Graph<V, E>::BreadthFirst(void(*visit)(V data))
+template<typename Visit>
+inline void Graph<V, E>::BreadthFirst(Visit visit)
 {
 	if (IsEmpty())
 	{
@@ -541,8 +596,8 @@ inline void Graph<V, E>::BreadthFirst(void(*visit)(V data))
 
 	queue<Vertex<V, E>*> vqueque;
 	Vertex<V, E> * temp = nullptr;
-	list<Vertex<V, E>>::iterator viter;
-	list<Edge<V, E>>::iterator eiter;
+	typename list<Vertex<V, E>>::iterator viter;
+	typename list<Edge<V, E>>::iterator eiter;
 
 	for (viter = m_vertices.begin(); viter != m_vertices.end(); ++viter)
 	{
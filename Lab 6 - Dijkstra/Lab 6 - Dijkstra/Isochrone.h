@@ -0,0 +1,186 @@
+/*************************************************************
+* Filename:		Isochrone.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Bounded reachability: every vertex within a budget of a
+*	source ("what can I reach in 90 minutes"). The search is a
+*	Dijkstra that stops as soon as the cheapest queued vertex is
+*	over the budget, so it only pays for the area inside the
+*	isochrone, and it runs in a SearchWorkspace that is reset by
+*	the vertices it touched rather than the whole graph.
+*
+*	Costs come from a weight array indexed by edge id: the
+*	graph's own weights (miles) or TravelTimeModel::EdgeSeconds()
+*	for driving time. ReachableWithinBatch() answers many sources
+*	at once, one workspace per thread.
+**************************************************************/
+#include <vector>
+#include "CompactGraph.h"
+#include "SearchWorkspace.h"
+#include "Parallel.h"
+#include "SearchStats.h"
+#include "Exception.h"
+using std::vector;
+
+#pragma once
+#ifndef ISOCHRONE_H
+#define ISOCHRONE_H
+
+struct ReachedVertex
+{
+	int vertex;		//Graph index
+	int cost;		//Cost from the source, never over the budget
+};
+
+template <typename V, typename E>
+void ReachableWithin(const CompactGraph<V, E> & graph, const int * weights, int source, int budget,
+	SearchWorkspace & workspace, vector<ReachedVertex> & reached, SearchStats * stats = nullptr);	//Vertices within budget, nearest first
+
+template <typename V, typename E>
+void ReachableWithin(const CompactGraph<V, E> & graph, const int * weights, int source, int budget,
+	vector<ReachedVertex> & reached, SearchStats * stats = nullptr);	//Same, with its own workspace
+
+template <typename V, typename E>
+void ReachableWithinBatch(const CompactGraph<V, E> & graph, const int * weights, const vector<int> & sources, int budget,
+	int threads, vector<vector<ReachedVertex> > & results);	//One isochrone per source, in parallel
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function finds every vertex whose cheapest cost from
+*		   source is at most budget. Vertices are listed in the order they
+*		   are settled, so the nearest come first and source is first.
+*
+* Precondition:	weights holds one cost of 0 or more per edge id.
+*
+* Postcondition: reached holds the vertices and their costs, and the
+*				 workspace is left holding them until its next
+*				 Prepare(). Throws if source is not in the graph.
+************************************************************************/
+template<typename V, typename E>
+void ReachableWithin(const CompactGraph<V, E> & graph, const int * weights, int source, int budget,
+	SearchWorkspace & workspace, vector<ReachedVertex> & reached, SearchStats * stats)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+
+	workspace.Prepare(graph.GetVertexCount());
+	int * distance = workspace.GetDistances();
+	char * done = workspace.GetDone();
+	RadixHeap<int> & heap = workspace.GetQueue();
+	const int * targets = graph.GetTargets();
+	SearchStats counts;
+	counts.searchSeconds -= StatsClock();
+
+	reached.clear();
+	if (budget < 0)
+	{
+		return;
+	}
+	workspace.Touch(source);
+	distance[source] = 0;
+	heap.Push(0, source);
+	STATS_ADD(counts.pushes, 1);
+
+	while (!heap.IsEmpty() && heap.GetTopKey() <= budget)	//Everything left is over the budget
+	{
+		int dist = heap.GetTopKey();
+		int current = heap.GetTopVertex();
+		heap.Pop();
+		STATS_ADD(counts.pops, 1);
+
+		if (dist == distance[current] && !done[current])
+		{
+			done[current] = 1;
+			ReachedVertex entry = { current, dist };
+			reached.push_back(entry);
+			STATS_ADD(counts.settled, 1);
+			STATS_ADD(counts.relaxed, graph.GetEdgeEnd(current) - graph.GetEdgeBegin(current));
+
+			for (int edge = graph.GetEdgeBegin(current); edge != graph.GetEdgeEnd(current); ++edge)
+			{
+				int to = targets[edge];
+				int cost = dist + weights[edge];
+				if (cost <= budget && cost < distance[to])	//Nothing over the budget is queued
+				{
+					if (distance[to] == INFINITE_DISTANCE)
+					{
+						workspace.Touch(to);
+					}
+					else
+					{
+						STATS_ADD(counts.decreaseKeys, 1);
+					}
+					distance[to] = cost;
+					heap.Push(cost, to);
+					STATS_ADD(counts.pushes, 1);
+				}
+			}
+		}
+	}
+	heap.Clear();
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.searchSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+}
+
+/**********************************************************************
+* Purpose: This function is ReachableWithin() for a single query, with a
+*		   workspace of its own.
+*
+* Precondition:	weights holds one cost of 0 or more per edge id.
+*
+* Postcondition: reached holds the vertices within budget.
+************************************************************************/
+template<typename V, typename E>
+void ReachableWithin(const CompactGraph<V, E> & graph, const int * weights, int source, int budget,
+	vector<ReachedVertex> & reached, SearchStats * stats)
+{
+	SearchWorkspace workspace;
+	ReachableWithin(graph, weights, source, budget, workspace, reached, stats);
+}
+
+/**********************************************************************
+* Purpose: This function computes the isochrone of every source, split
+*		   over threads. Each thread keeps one workspace for all of its
+*		   sources, so the per vertex arrays are allocated once a thread.
+*
+* Precondition:	weights holds one cost of 0 or more per edge id, and every
+*				source is a valid index of graph.
+*
+* Postcondition: results[i] holds the vertices within budget of sources[i].
+************************************************************************/
+template<typename V, typename E>
+void ReachableWithinBatch(const CompactGraph<V, E> & graph, const int * weights, const vector<int> & sources, int budget,
+	int threads, vector<vector<ReachedVertex> > & results)
+{
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		if (sources[i] < 0 || sources[i] >= graph.GetVertexCount())
+		{
+			throw Exception("Starting vertex is not in the graph!");	//Checked up front, workers must not throw
+		}
+	}
+	if (threads < 1)
+	{
+		threads = 1;
+	}
+
+	vector<SearchWorkspace> workspaces(threads);
+	results.resize(sources.size());
+	ParallelFor(0, static_cast<int>(sources.size()), threads, [&](int worker, int i)
+	{
+		ReachableWithin(graph, weights, sources[i], budget, workspaces[worker], results[i]);
+	});
+}
+#endif
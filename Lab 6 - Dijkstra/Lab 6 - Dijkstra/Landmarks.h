@@ -0,0 +1,536 @@
+/************************************************************************
+* Class: LandmarkTable
+*
+* Purpose: This class holds the ALT (A*, landmarks, triangle inequality)
+*		   preprocessing of a CompactGraph. A few landmarks are picked
+*		   and the distance from each to every vertex is stored; for any
+*		   landmark L, |d(L, t) - d(L, v)| is a lower bound on d(v, t),
+*		   which steers a point to point A* toward the target without
+*		   any coordinates. Graphs here are two way, so the distance to
+*		   a landmark is the distance from it and one array serves both.
+*
+*		   Distances are stored as 16 bit steps of GetScale() miles,
+*		   vertex by vertex, so up to 32 landmarks' bounds for one
+*		   vertex share a cache line. A step is rounded down, so a bound loses up to
+*		   one step and stays a lower bound.
+*
+*		   Landmarks are picked in the largest connected component:
+*			Farthest - each landmark is the vertex farthest from the
+*				ones already picked.
+*			Avoid - grows a shortest path tree from a random root and
+*				walks down into the subtree the current landmarks bound
+*				worst, taking the leaf it ends at (Goldberg and
+*				Werneck). Usually better bounds for the same count.
+*
+* Manager functions
+*	LandmarkTable()
+*		Creates an empty table.
+*	~LandmarkTable()
+*		Clears the table.
+*	LandmarkTable(const LandmarkTable & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const LandmarkTable & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Build(const CompactGraph<V, E> & graph, int count, LandmarkSelection selection, unsigned seed)
+*		Picks count landmarks and stores their distances.
+*	GetCount() / GetLandmark(int i)
+*		Returns the number of landmarks / the vertex of landmark i.
+*	GetScale()
+*		Returns the miles per stored step.
+*	GetDistance(int i, int vertex)
+*		Returns the stored distance from landmark i, rounded down.
+*	LowerBound(int from, int to)
+*		Returns a lower bound on the distance from one vertex to another.
+*	Route(const CompactGraph<V, E> & graph, int source, int target, SearchWorkspace & workspace,
+*		  vector<int> & path, SearchStats * stats)
+*		Finds the shortest route with A* on the lower bounds.
+*************************************************************************/
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+#include "CompactGraph.h"
+#include "ShortestPaths.h"
+#include "Components.h"
+#include "BinaryHeap.h"
+#include "SearchWorkspace.h"
+#include "SearchStats.h"
+#include "Exception.h"
+using std::vector;
+
+#pragma once
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+enum LandmarkSelection
+{
+	LANDMARKS_FARTHEST,	//Farthest from those already picked
+	LANDMARKS_AVOID		//Leaf of the worst bounded shortest path subtree
+};
+
+const uint16_t LANDMARK_UNREACHED = 0xFFFF;	//Stored distance of a vertex a landmark can't reach
+
+class LandmarkTable
+{
+public:
+	LandmarkTable();
+	~LandmarkTable();
+	LandmarkTable(const LandmarkTable & copy);
+	LandmarkTable & operator=(const LandmarkTable & rhs);
+
+	template <typename V, typename E>
+	void Build(const CompactGraph<V, E> & graph, int count, LandmarkSelection selection, unsigned seed = 1);
+	int GetCount() const;
+	int GetLandmark(int i) const;
+	int GetScale() const;
+	int GetDistance(int i, int vertex) const;
+	int LowerBound(int from, int to) const;
+	template <typename V, typename E>
+	int Route(const CompactGraph<V, E> & graph, int source, int target, SearchWorkspace & workspace, vector<int> & path,
+		SearchStats * stats = nullptr) const;
+
+private:
+	vector<int> m_landmarks;		//Vertex of each landmark
+	vector<uint16_t> m_distances;	//Landmark i's distance to vertex v is at v * m_stride + i
+	int m_stride;					//Slots per vertex, the count asked for
+	int m_scale;					//Miles per step
+	int m_vertexCount;				//Vertices of the graph it was built for
+
+	void Store(int landmark, const vector<int> & distance);
+	template <typename V, typename E>
+	int PickAvoid(const CompactGraph<V, E> & graph, int root, const vector<char> & isLandmark);
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty table.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: There are no landmarks.
+************************************************************************/
+inline LandmarkTable::LandmarkTable() : m_stride(0), m_scale(1), m_vertexCount(0)
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the table.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are empty.
+************************************************************************/
+inline LandmarkTable::~LandmarkTable()
+{
+	m_landmarks.clear();
+	m_distances.clear();
+	m_stride = 0;
+	m_vertexCount = 0;
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+inline LandmarkTable::LandmarkTable(const LandmarkTable & copy) : m_stride(0), m_scale(1), m_vertexCount(0)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+inline LandmarkTable & LandmarkTable::operator=(const LandmarkTable & rhs)
+{
+	if (this != &rhs)
+	{
+		m_landmarks = rhs.m_landmarks;
+		m_distances = rhs.m_distances;
+		m_stride = rhs.m_stride;
+		m_scale = rhs.m_scale;
+		m_vertexCount = rhs.m_vertexCount;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function picks count landmarks in the largest component
+*		   of graph and stores the distance from each to every vertex,
+*		   one ShortestPaths() run per landmark (two for avoid). The
+*		   step size is set from the first search: no distance in the
+*		   component can be more than twice the farthest vertex from
+*		   its start, so that range is split into 65535 steps.
+*
+* Precondition:	graph is two way, count is 1 or more.
+*
+* Postcondition: The table holds up to count landmarks; fewer if the
+*				 component has fewer vertices.
+************************************************************************/
+template<typename V, typename E>
+void LandmarkTable::Build(const CompactGraph<V, E> & graph, int count, LandmarkSelection selection, unsigned seed)
+{
+	const int SIZE = graph.GetVertexCount();
+	if (count < 1)
+	{
+		throw Exception("Landmark count must be at least 1");
+	}
+
+	m_landmarks.clear();
+	m_stride = count;
+	m_scale = 1;
+	m_vertexCount = SIZE;
+	m_distances.assign(static_cast<size_t>(SIZE) * count, LANDMARK_UNREACHED);
+	if (SIZE == 0)
+	{
+		return;
+	}
+
+	//************************** Start in the largest component **********************************
+	vector<int> component;
+	vector<int> members;
+	vector<int> sizes(ConnectedComponents(graph, 1, component), 0);
+	for (int i = 0; i < SIZE; i++)
+	{
+		sizes[component[i]]++;
+	}
+	int largest = static_cast<int>(std::max_element(sizes.begin(), sizes.end()) - sizes.begin());
+	for (int i = 0; i < SIZE; i++)
+	{
+		if (component[i] == largest)
+		{
+			members.push_back(i);
+		}
+	}
+
+	std::mt19937 rng(seed);
+	vector<int> distance, pred;
+	vector<int> nearest;			//Distance to the closest landmark so far
+	vector<char> isLandmark(SIZE, 0);
+	int farthest = 0;
+
+	ShortestPaths(graph, members[rng() % members.size()], nearest, pred);
+	for (size_t i = 0; i < members.size(); i++)
+	{
+		farthest = nearest[members[i]] > farthest ? nearest[members[i]] : farthest;
+	}
+	m_scale = static_cast<int>((2LL * farthest) / (LANDMARK_UNREACHED - 1) + 1);
+
+	//************************** Pick and store **********************************
+	for (int i = 0; i < count; i++)
+	{
+		int next = NO_VERTEX;
+		if (selection == LANDMARKS_AVOID && i > 0)
+		{
+			next = PickAvoid(graph, members[rng() % members.size()], isLandmark);
+		}
+		if (next == NO_VERTEX)	//Farthest, and the first avoid landmark
+		{
+			int best = -1;
+			for (size_t m = 0; m < members.size(); m++)
+			{
+				if (!isLandmark[members[m]] && nearest[members[m]] > best)
+				{
+					best = nearest[members[m]];
+					next = members[m];
+				}
+			}
+		}
+		if (next == NO_VERTEX)
+		{
+			break;	//Every vertex of the component is a landmark
+		}
+
+		ShortestPaths(graph, next, distance, pred);
+		isLandmark[next] = 1;
+		Store(next, distance);
+		for (size_t m = 0; m < members.size(); m++)
+		{
+			int vertex = members[m];
+			nearest[vertex] = i == 0 || distance[vertex] < nearest[vertex] ? distance[vertex] : nearest[vertex];
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of landmarks.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int LandmarkTable::GetCount() const
+{
+	return static_cast<int>(m_landmarks.size());
+}
+
+/**********************************************************************
+* Purpose: This function returns the vertex of landmark i.
+*
+* Precondition:	i is below GetCount().
+*
+* Postcondition: The vertex is returned.
+************************************************************************/
+inline int LandmarkTable::GetLandmark(int i) const
+{
+	return m_landmarks[i];
+}
+
+/**********************************************************************
+* Purpose: This function returns how many miles one stored step is.
+*
+* Precondition:	N/A
+*
+* Postcondition: The scale is returned, 1 when distances are exact.
+************************************************************************/
+inline int LandmarkTable::GetScale() const
+{
+	return m_scale;
+}
+
+/**********************************************************************
+* Purpose: This function returns the stored distance from landmark i to
+*		   vertex, rounded down to a whole step.
+*
+* Precondition:	i is below GetCount(), vertex is a valid vertex.
+*
+* Postcondition: The distance is returned, INFINITE_DISTANCE if the
+*				 landmark can't reach vertex.
+************************************************************************/
+inline int LandmarkTable::GetDistance(int i, int vertex) const
+{
+	uint16_t step = m_distances[static_cast<size_t>(vertex) * m_stride + i];
+	return step == LANDMARK_UNREACHED ? INFINITE_DISTANCE : step * m_scale;
+}
+
+/**********************************************************************
+* Purpose: This function returns the best triangle inequality bound on
+*		   the distance from from to to. Each stored distance can be up
+*		   to a step short, so every bound gives one step back.
+*
+* Precondition:	from and to are valid vertices.
+*
+* Postcondition: A lower bound of 0 or more is returned.
+************************************************************************/
+inline int LandmarkTable::LowerBound(int from, int to) const
+{
+	const uint16_t * first = &m_distances[static_cast<size_t>(from) * m_stride];
+	const uint16_t * second = &m_distances[static_cast<size_t>(to) * m_stride];
+	int best = 0;
+
+	for (size_t i = 0; i < m_landmarks.size(); i++)
+	{
+		if (first[i] != LANDMARK_UNREACHED && second[i] != LANDMARK_UNREACHED)
+		{
+			int steps = first[i] > second[i] ? first[i] - second[i] : second[i] - first[i];
+			int bound = steps * m_scale - (m_scale - 1);
+			best = bound > best ? bound : best;
+		}
+	}
+	return best;
+}
+
+/**********************************************************************
+* Purpose: This function finds the shortest route from source to target
+*		   with A*, ordering vertices by distance so far plus the lower
+*		   bound to target. Rounded bounds can be off by a step from one
+*		   vertex to the next, so a vertex may be reached again for less
+*		   after it was expanded; it is then expanded again, which keeps
+*		   the answer exact. With exact distances (scale 1) that never
+*		   happens.
+*
+* Precondition:	The table was built for graph.
+*
+* Postcondition: path holds the indices from source to target (empty if
+*				 there is no route) and the distance is returned,
+*				 INFINITE_DISTANCE if there is no route.
+************************************************************************/
+template<typename V, typename E>
+int LandmarkTable::Route(const CompactGraph<V, E> & graph, int source, int target, SearchWorkspace & workspace,
+	vector<int> & path, SearchStats * stats) const
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (target < 0 || target >= graph.GetVertexCount())
+	{
+		throw Exception("Ending vertex is not in the graph!");
+	}
+	if (graph.GetVertexCount() != m_vertexCount)
+	{
+		throw Exception("Landmarks were built for another graph");
+	}
+
+	const int * targets = graph.GetTargets();
+	const int * weights = graph.GetWeights();
+	BinaryHeap<int> heap;
+	SearchStats counts;
+	counts.searchSeconds -= StatsClock();
+
+	path.clear();
+	workspace.Prepare(graph.GetVertexCount());
+	int * distance = workspace.GetDistances();
+	int * pred = workspace.GetPreds();
+
+	if (graph.MayConnect(source, target))
+	{
+		workspace.Touch(source);
+		distance[source] = 0;
+		heap.Push(LowerBound(source, target), source);
+		STATS_ADD(counts.pushes, 1);
+	}
+
+	while (!heap.IsEmpty())
+	{
+		int key = heap.GetTopKey();
+		int current = heap.GetTopVertex();
+		heap.Pop();
+		STATS_ADD(counts.pops, 1);
+		if (key != distance[current] + LowerBound(current, target))
+		{
+			continue;	//Improved after it was pushed
+		}
+		STATS_ADD(counts.settled, 1);
+		if (current == target)
+		{
+			break;
+		}
+
+		STATS_ADD(counts.relaxed, graph.GetEdgeEnd(current) - graph.GetEdgeBegin(current));
+		for (int edge = graph.GetEdgeBegin(current); edge != graph.GetEdgeEnd(current); ++edge)
+		{
+			int to = targets[edge];
+			int cost = distance[current] + weights[edge];
+			if (cost < distance[to])
+			{
+				if (distance[to] == INFINITE_DISTANCE)
+				{
+					workspace.Touch(to);
+				}
+				distance[to] = cost;
+				pred[to] = current;
+				heap.Push(cost + LowerBound(to, target), to);
+				STATS_ADD(counts.pushes, 1);
+			}
+		}
+	}
+
+	if (distance[target] != INFINITE_DISTANCE)
+	{
+		for (int vertex = target; vertex != NO_VERTEX; vertex = pred[vertex])
+		{
+			path.push_back(vertex);
+		}
+		std::reverse(path.begin(), path.end());
+	}
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.searchSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+	return distance[target];
+}
+
+/**********************************************************************
+* Purpose: This function stores the distances from a new landmark,
+*		   rounded down to whole steps.
+*
+* Precondition:	Fewer than m_stride landmarks are stored.
+*
+* Postcondition: The landmark is added.
+************************************************************************/
+inline void LandmarkTable::Store(int landmark, const vector<int> & distance)
+{
+	size_t slot = m_landmarks.size();
+	for (int v = 0; v < m_vertexCount; v++)
+	{
+		m_distances[static_cast<size_t>(v) * m_stride + slot] = distance[v] == INFINITE_DISTANCE
+			? LANDMARK_UNREACHED : static_cast<uint16_t>(distance[v] / m_scale);
+	}
+	m_landmarks.push_back(landmark);
+}
+
+/**********************************************************************
+* Purpose: This function picks the next avoid landmark. Every vertex of
+*		   the shortest path tree from root weighs how much its bound
+*		   from root falls short of the real distance; a subtree's size
+*		   is the sum of its weights, or 0 if it holds a landmark. The
+*		   walk starts at root and keeps taking the child with the
+*		   largest size, and the leaf it reaches is the landmark. The
+*		   root's own subtree always holds the landmarks, so only its
+*		   children are sized.
+*
+* Precondition:	root is in the largest component, at least one
+*				landmark is stored.
+*
+* Postcondition: The landmark is returned, NO_VERTEX if the landmarks
+*				 already bound every subtree exactly.
+************************************************************************/
+template<typename V, typename E>
+int LandmarkTable::PickAvoid(const CompactGraph<V, E> & graph, int root, const vector<char> & isLandmark)
+{
+	const int SIZE = graph.GetVertexCount();
+	vector<int> distance, pred;
+	vector<int> order;				//Reached vertices, farthest first
+	vector<long long> size(SIZE, 0);
+	vector<char> covered(SIZE, 0);	//Subtree holds a landmark
+	vector<int> child(SIZE, NO_VERTEX);	//Largest child
+
+	ShortestPaths(graph, root, distance, pred);
+	for (int v = 0; v < SIZE; v++)
+	{
+		if (distance[v] != INFINITE_DISTANCE)
+		{
+			order.push_back(v);
+			size[v] = distance[v] - LowerBound(root, v);
+			covered[v] = isLandmark[v];
+		}
+	}
+	std::sort(order.begin(), order.end(), [&](int first, int second)
+	{
+		return distance[first] > distance[second] || (distance[first] == distance[second] && first > second);
+	});
+
+	for (size_t i = 0; i < order.size(); i++)	//Children come before their parent
+	{
+		int v = order[i];
+		if (covered[v])
+		{
+			size[v] = 0;
+		}
+		int up = pred[v];
+		if (up != NO_VERTEX)
+		{
+			covered[up] = covered[up] || covered[v];
+			size[up] += size[v];
+			if (size[v] > 0 && (child[up] == NO_VERTEX || size[v] > size[child[up]]))
+			{
+				child[up] = v;
+			}
+		}
+	}
+	if (child[root] == NO_VERTEX)
+	{
+		return NO_VERTEX;
+	}
+
+	int leaf = root;
+	while (child[leaf] != NO_VERTEX)
+	{
+		leaf = child[leaf];
+	}
+	return isLandmark[leaf] ? NO_VERTEX : leaf;
+}
@@ -0,0 +1,372 @@
+/************************************************************************
+* Class: MaskedGraph
+*
+* Purpose: This class is a view of a CompactGraph that hides the edges
+*		   set in a Bitmap over edge ids, usually compiled by RoadRules.
+*		   Searches read it through ForEachEdge(), like a ScenarioGraph,
+*		   so ShortestRouteOver() and the other engines written against
+*		   ForEachEdge() run on it unchanged. The graph and the mask are
+*		   only pointed to: neither is copied or changed, and both must
+*		   outlive the view. A view costs one bit test per edge in the
+*		   search's inner loop.
+*
+*		   With a penalty of 0 masked edges are closed. With a penalty
+*		   above 1 they stay open at their weight times the penalty, for
+*		   rules that should be kept where possible rather than always;
+*		   RouteWherePossible() tries the closed view first and falls
+*		   back to that.
+*
+* Manager functions
+*	MaskedGraph()
+*		Creates a view of nothing.
+*	MaskedGraph(const CompactGraph<V, E> & graph, const Bitmap & mask, int penalty)
+*		Creates a view of graph without the edges set in mask.
+*	~MaskedGraph()
+*		Forgets the graph and mask.
+*	MaskedGraph(const MaskedGraph<V, E> & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const MaskedGraph<V, E> & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	ForEachEdge(int index, Visit visit)
+*		Calls visit(edge, target, weight) for every edge the view keeps.
+*	GetVertexCount()
+*		Returns the number of vertices.
+*	IsMasked(int edge)
+*		Returns whether the mask is set for an edge.
+*	SetPenalty(int penalty) / GetPenalty()
+*		Sets or returns what masked edges' weights are multiplied by.
+*	GetGraph()
+*		Returns the graph under the view.
+*	PathWeight(const vector<int> & path, vector<int> * edges, bool * followed)
+*		Returns the graph's weight of a path found over the view.
+*	RouteWherePossible(int source, int target, int penalty, ...)
+*		Finds a route without masked edges, or with as few as the
+*		penalty makes worthwhile if there is none.
+*************************************************************************/
+#include <vector>
+#include "CompactGraph.h"
+#include "Bitmap.h"
+#include "ShortestPaths.h"
+#include "SearchWorkspace.h"
+#include "SearchStats.h"
+#include "Exception.h"
+using std::vector;
+
+#pragma once
+#ifndef MASKEDGRAPH_H
+#define MASKEDGRAPH_H
+
+const int MASK_PENALTY = 10;	//Default weight multiplier for masked edges kept "where possible"
+
+template <typename V, typename E>
+class MaskedGraph
+{
+public:
+	typedef typename CompactGraph<V, E>::Weight Weight;
+
+	MaskedGraph();
+	MaskedGraph(const CompactGraph<V, E> & graph, const Bitmap & mask, int penalty = 0);
+	~MaskedGraph();
+	MaskedGraph(const MaskedGraph<V, E> & copy);
+	const MaskedGraph<V, E> & operator=(const MaskedGraph<V, E> & rhs);
+
+	template <typename Visit>
+	void ForEachEdge(int index, Visit visit) const;
+	int GetVertexCount() const;
+	bool IsMasked(int edge) const;
+	void SetPenalty(int penalty);
+	int GetPenalty() const;
+	const CompactGraph<V, E> & GetGraph() const;
+	Weight PathWeight(const vector<int> & path, vector<int> * edges, bool * followed) const;
+	Weight RouteWherePossible(int source, int target, int penalty, SearchWorkspace & workspace, vector<int> & path,
+		bool * followed, SearchStats * stats) const;
+
+private:
+	const CompactGraph<V, E> * m_graph;	//Graph under the view
+	const Bitmap * m_mask;				//One bit per edge id, set if masked
+	int m_penalty;						//0 closes masked edges, else multiplies their weight
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates a view of nothing.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: members are null.
+************************************************************************/
+template<typename V, typename E>
+inline MaskedGraph<V, E>::MaskedGraph()
+	: m_graph(nullptr), m_mask(nullptr), m_penalty(0)
+{
+}
+
+/**********************************************************************
+* Purpose: This function creates a view of graph without the edges set
+*		   in mask.
+*
+* Precondition:	mask was sized for graph (RoadRules::Compile()).
+*
+* Postcondition: members are assigned.
+************************************************************************/
+template<typename V, typename E>
+inline MaskedGraph<V, E>::MaskedGraph(const CompactGraph<V, E> & graph, const Bitmap & mask, int penalty)
+	: m_graph(&graph), m_mask(&mask), m_penalty(0)
+{
+	if (mask.GetSize() < graph.GetEdgeCount())
+	{
+		throw Exception("Mask does not match the graph");
+	}
+	SetPenalty(penalty);
+}
+
+/**********************************************************************
+* Purpose: This function forgets the graph and mask.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are null.
+************************************************************************/
+template<typename V, typename E>
+inline MaskedGraph<V, E>::~MaskedGraph()
+{
+	m_graph = nullptr;
+	m_mask = nullptr;
+	m_penalty = 0;
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+template<typename V, typename E>
+inline MaskedGraph<V, E>::MaskedGraph(const MaskedGraph<V, E> & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+template<typename V, typename E>
+inline const MaskedGraph<V, E> & MaskedGraph<V, E>::operator=(const MaskedGraph<V, E> & rhs)
+{
+	if (this != &rhs)
+	{
+		m_graph = rhs.m_graph;
+		m_mask = rhs.m_mask;
+		m_penalty = rhs.m_penalty;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function calls visit(edge, target, weight) for every edge
+*		   leaving index that the view keeps. It reads the graph's arrays
+*		   and the mask's words directly; the penalty is checked once per
+*		   vertex, not per edge.
+*
+* Precondition:	index is a valid vertex.
+*
+* Postcondition: visit was called once per kept edge, in edge id order.
+************************************************************************/
+template<typename V, typename E>
+template<typename Visit>
+inline void MaskedGraph<V, E>::ForEachEdge(int index, Visit visit) const
+{
+	const int * targets = m_graph->GetTargets();
+	const Weight * weights = m_graph->GetWeights();
+	const uint64_t * words = m_mask->GetWords();
+	const int END = m_graph->GetEdgeEnd(index);
+
+	if (m_penalty == 0)
+	{
+		for (int edge = m_graph->GetEdgeBegin(index); edge != END; ++edge)
+		{
+			if (!((words[edge >> 6] >> (edge & 63)) & 1))
+			{
+				visit(edge, targets[edge], weights[edge]);
+			}
+		}
+	}
+	else
+	{
+		for (int edge = m_graph->GetEdgeBegin(index); edge != END; ++edge)
+		{
+			Weight weight = weights[edge];
+			if ((words[edge >> 6] >> (edge & 63)) & 1)
+			{
+				weight *= m_penalty;
+			}
+			visit(edge, targets[edge], weight);
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of vertices.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int MaskedGraph<V, E>::GetVertexCount() const
+{
+	return m_graph == nullptr ? 0 : m_graph->GetVertexCount();
+}
+
+/**********************************************************************
+* Purpose: This function returns whether the mask is set for an edge.
+*
+* Precondition:	edge is a valid edge id.
+*
+* Postcondition: true is returned if edge is masked.
+************************************************************************/
+template<typename V, typename E>
+inline bool MaskedGraph<V, E>::IsMasked(int edge) const
+{
+	return m_mask->Test(edge);
+}
+
+/**********************************************************************
+* Purpose: This function sets what masked edges' weights are multiplied
+*		   by, or 0 to close them.
+*
+* Precondition:	N/A
+*
+* Postcondition: The penalty is set.
+************************************************************************/
+template<typename V, typename E>
+inline void MaskedGraph<V, E>::SetPenalty(int penalty)
+{
+	if (penalty < 0)
+	{
+		throw Exception("Penalty must be 0 or more");
+	}
+	m_penalty = penalty;
+}
+
+/**********************************************************************
+* Purpose: This function returns what masked edges' weights are
+*		   multiplied by, 0 if they are closed.
+*
+* Precondition:	N/A
+*
+* Postcondition: The penalty is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int MaskedGraph<V, E>::GetPenalty() const
+{
+	return m_penalty;
+}
+
+/**********************************************************************
+* Purpose: This function returns the graph under the view.
+*
+* Precondition:	The view has a graph.
+*
+* Postcondition: The graph is returned.
+************************************************************************/
+template<typename V, typename E>
+inline const CompactGraph<V, E> & MaskedGraph<V, E>::GetGraph() const
+{
+	return *m_graph;
+}
+
+/**********************************************************************
+* Purpose: This function returns the graph's weight of a path found over
+*		   the view, taking for each step the edge the search would have
+*		   (the lightest in the view), so penalties are not counted.
+*
+* Precondition:	Consecutive vertices of path are joined in the view.
+*
+* Postcondition: The weight is returned, edges, if given, holds the edge
+*				 of each step, and followed, if given, says whether the
+*				 path stays off masked edges.
+************************************************************************/
+template<typename V, typename E>
+typename MaskedGraph<V, E>::Weight MaskedGraph<V, E>::PathWeight(const vector<int> & path, vector<int> * edges, bool * followed) const
+{
+	Weight total = 0;
+
+	if (edges != nullptr)
+	{
+		edges->clear();
+	}
+	if (followed != nullptr)
+	{
+		*followed = true;
+	}
+	for (size_t i = 1; i < path.size(); i++)
+	{
+		int best = NO_VERTEX;
+		Weight bestWeight = 0;
+		ForEachEdge(path[i - 1], [&](int edge, int target, Weight weight)
+		{
+			if (target == path[i] && (best == NO_VERTEX || weight < bestWeight))
+			{
+				best = edge;
+				bestWeight = weight;
+			}
+		});
+		if (best == NO_VERTEX)
+		{
+			throw Exception("Path is not in the graph");
+		}
+		total += m_graph->GetWeight(best);
+		if (edges != nullptr)
+		{
+			edges->push_back(best);
+		}
+		if (followed != nullptr && IsMasked(best))
+		{
+			*followed = false;
+		}
+	}
+	return total;
+}
+
+/**********************************************************************
+* Purpose: This function finds the shortest route from source to target
+*		   without masked edges, and when there is none, the shortest
+*		   with masked edges weighing penalty times as much, so rules
+*		   like "interstates only" are kept where possible.
+*
+* Precondition:	penalty is 1 or more.
+*
+* Postcondition: path holds the route (empty if target can't be reached
+*				 at all), its weight in the graph is returned, or
+*				 INFINITE_DISTANCE, and followed, if given, says whether
+*				 the route stays off masked edges.
+************************************************************************/
+template<typename V, typename E>
+typename MaskedGraph<V, E>::Weight MaskedGraph<V, E>::RouteWherePossible(int source, int target, int penalty,
+	SearchWorkspace & workspace, vector<int> & path, bool * followed, SearchStats * stats) const
+{
+	MaskedGraph<V, E> view(*this);
+
+	view.SetPenalty(0);
+	if (ShortestRouteOver(view, source, target, workspace, path, stats) == INFINITE_DISTANCE)
+	{
+		view.SetPenalty(penalty < 1 ? 1 : penalty);
+		if (ShortestRouteOver(view, source, target, workspace, path, stats) == INFINITE_DISTANCE)
+		{
+			if (followed != nullptr)
+			{
+				*followed = false;
+			}
+			return INFINITE_DISTANCE;
+		}
+	}
+	return view.PathWeight(path, nullptr, followed);
+}
@@ -0,0 +1,365 @@
+/************************************************************************
+* Class: MultilevelPartition
+*
+* Purpose: This class splits the vertices of a CompactGraph into nested
+*		   cells, several levels deep: level 0 has the smallest cells,
+*		   and every cell of a level is a union of cells of the level
+*		   below. It looks only at which vertices are joined, never at
+*		   weights, so it is built once and serves every metric (see
+*		   CellOverlay).
+*
+*		   The graph is cut in two again and again until the pieces are
+*		   small enough. Each cut walks breadth first from a vertex far
+*		   out on the piece and gives the first half it reaches to one
+*		   side, which keeps both sides in one piece and the cut short
+*		   on road networks. A piece becomes a cell of level l the first
+*		   time it is no bigger than the size asked for level l.
+*
+* Manager functions
+*	MultilevelPartition()
+*		Creates an empty partition.
+*	~MultilevelPartition()
+*		Clears the cells.
+*	MultilevelPartition(const MultilevelPartition & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const MultilevelPartition & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Build(const CompactGraph<V, E> & graph, const vector<int> & cellSizes)
+*		Partitions graph with the largest cell of each level, smallest first.
+*	GetLevelCount()
+*		Returns the number of levels.
+*	GetCellCount(int level)
+*		Returns the number of cells on a level.
+*	GetCell(int level, int vertex)
+*		Returns the cell of vertex on a level.
+*	GetVertexCount()
+*		Returns the number of vertices partitioned.
+*	CellOrder()
+*		Returns an order that keeps the vertices of each cell together.
+*	Reorder(const vector<int> & order)
+*		Renumbers the vertices the way CompactGraph::Reorder() does.
+*************************************************************************/
+#include <vector>
+#include "CompactGraph.h"
+#include "Exception.h"
+using std::vector;
+
+#pragma once
+#ifndef MULTILEVELPARTITION_H
+#define MULTILEVELPARTITION_H
+
+class MultilevelPartition
+{
+public:
+	MultilevelPartition();
+	~MultilevelPartition();
+	MultilevelPartition(const MultilevelPartition & copy);
+	MultilevelPartition & operator=(const MultilevelPartition & rhs);
+
+	template <typename V, typename E>
+	void Build(const CompactGraph<V, E> & graph, const vector<int> & cellSizes);
+	int GetLevelCount() const;
+	int GetCellCount(int level) const;
+	int GetCell(int level, int vertex) const;
+	int GetVertexCount() const;
+	vector<int> CellOrder() const;
+	void Reorder(const vector<int> & order);
+
+private:
+	vector<vector<int>> m_cells;	//Cell of every vertex, one array per level
+	vector<int> m_cellCounts;		//Number of cells on each level
+
+	template <typename V, typename E>
+	void Bisect(const CompactGraph<V, E> & graph, const vector<int> & piece, vector<int> & mark, int stamp,
+		vector<int> & first, vector<int> & second);
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty partition.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: There are no levels.
+************************************************************************/
+inline MultilevelPartition::MultilevelPartition()
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the cells.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are empty.
+************************************************************************/
+inline MultilevelPartition::~MultilevelPartition()
+{
+	m_cells.clear();
+	m_cellCounts.clear();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+inline MultilevelPartition::MultilevelPartition(const MultilevelPartition & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+inline MultilevelPartition & MultilevelPartition::operator=(const MultilevelPartition & rhs)
+{
+	if (this != &rhs)
+	{
+		m_cells = rhs.m_cells;
+		m_cellCounts = rhs.m_cellCounts;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function partitions graph. Pieces are cut depth first,
+*		   so the cells of one parent get consecutive numbers.
+*
+* Precondition:	cellSizes is not empty and grows, each size 1 or more.
+*
+* Postcondition: Every vertex has a cell on every level, and cells nest.
+************************************************************************/
+template<typename V, typename E>
+void MultilevelPartition::Build(const CompactGraph<V, E> & graph, const vector<int> & cellSizes)
+{
+	const int SIZE = graph.GetVertexCount();
+	const int LEVELS = static_cast<int>(cellSizes.size());
+
+	if (LEVELS == 0)
+	{
+		throw Exception("A partition needs at least one level");
+	}
+	for (int level = 0; level < LEVELS; level++)
+	{
+		if (cellSizes[level] < 1 || (level > 0 && cellSizes[level] <= cellSizes[level - 1]))
+		{
+			throw Exception("Cell sizes must be 1 or more and grow with the level");
+		}
+	}
+
+	m_cells.assign(LEVELS, vector<int>(SIZE, NO_VERTEX));
+	m_cellCounts.assign(LEVELS, 0);
+
+	vector<vector<int>> pieces(1);	//Pieces left to cut, as a stack
+	vector<int> mark(SIZE, NO_VERTEX);	//Stamp of the piece a vertex is in
+	vector<int> first, second;
+	int stamp = 0;
+
+	for (int i = 0; i < SIZE; i++)
+	{
+		pieces[0].push_back(i);
+	}
+	while (!pieces.empty())
+	{
+		vector<int> piece;
+		piece.swap(pieces.back());
+		pieces.pop_back();
+		if (piece.empty())
+		{
+			continue;
+		}
+
+		for (int level = LEVELS - 1; level >= 0; level--)
+		{
+			if (static_cast<int>(piece.size()) <= cellSizes[level] && m_cells[level][piece[0]] == NO_VERTEX)
+			{
+				for (size_t i = 0; i < piece.size(); i++)
+				{
+					m_cells[level][piece[i]] = m_cellCounts[level];
+				}
+				m_cellCounts[level]++;
+			}
+		}
+		if (static_cast<int>(piece.size()) > cellSizes[0])
+		{
+			Bisect(graph, piece, mark, stamp++, first, second);
+			pieces.push_back(second);	//first is cut next, so its cells come first
+			pieces.push_back(first);
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of levels.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int MultilevelPartition::GetLevelCount() const
+{
+	return static_cast<int>(m_cells.size());
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of cells on a level.
+*
+* Precondition:	level is below GetLevelCount().
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int MultilevelPartition::GetCellCount(int level) const
+{
+	return m_cellCounts[level];
+}
+
+/**********************************************************************
+* Purpose: This function returns the cell of vertex on a level.
+*
+* Precondition:	level is below GetLevelCount(), vertex is a valid vertex.
+*
+* Postcondition: The cell is returned.
+************************************************************************/
+inline int MultilevelPartition::GetCell(int level, int vertex) const
+{
+	return m_cells[level][vertex];
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of vertices partitioned.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int MultilevelPartition::GetVertexCount() const
+{
+	return m_cells.empty() ? 0 : static_cast<int>(m_cells[0].size());
+}
+
+/**********************************************************************
+* Purpose: This function returns an order, for CompactGraph::Reorder(),
+*		   that lists the vertices cell by cell on level 0. Cells of one
+*		   parent are numbered one after another, so every cell of
+*		   every level ends up in one run of indices, and a search over
+*		   a cell or an overlay touches nearby entries of its arrays.
+*
+* Precondition:	N/A
+*
+* Postcondition: order[i] is the old index of the vertex that should
+*				 become vertex i.
+************************************************************************/
+inline vector<int> MultilevelPartition::CellOrder() const
+{
+	vector<int> order;
+
+	if (!m_cells.empty())
+	{
+		vector<int> begin(m_cellCounts[0] + 1, 0);	//Counting sort by level 0 cell
+		for (size_t v = 0; v < m_cells[0].size(); v++)
+		{
+			begin[m_cells[0][v] + 1]++;
+		}
+		for (int cell = 0; cell < m_cellCounts[0]; cell++)
+		{
+			begin[cell + 1] += begin[cell];
+		}
+		order.resize(m_cells[0].size());
+		for (size_t v = 0; v < m_cells[0].size(); v++)
+		{
+			order[begin[m_cells[0][v]]++] = static_cast<int>(v);
+		}
+	}
+	return order;
+}
+
+/**********************************************************************
+* Purpose: This function renumbers the vertices to match a graph passed
+*		   the same order, so the partition need not be built again.
+*
+* Precondition:	order is a permutation of the vertices.
+*
+* Postcondition: Vertex i has the cells old vertex order[i] had.
+************************************************************************/
+inline void MultilevelPartition::Reorder(const vector<int> & order)
+{
+	if (order.size() != static_cast<size_t>(GetVertexCount()))
+	{
+		throw Exception("Order does not match the partition");
+	}
+	for (size_t level = 0; level < m_cells.size(); level++)
+	{
+		vector<int> cells(order.size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			cells[i] = m_cells[level][order[i]];
+		}
+		m_cells[level].swap(cells);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function cuts piece in two. A breadth first walk inside
+*		   the piece finds a vertex far out on it, and a second walk
+*		   from there hands out vertices in the order it reaches them:
+*		   the first half to first, the rest to second. Parts of the
+*		   piece the walk can't reach are walked after it.
+*
+* Precondition:	piece has 2 or more vertices, stamp is new.
+*
+* Postcondition: first and second hold the two halves.
+************************************************************************/
+template<typename V, typename E>
+void MultilevelPartition::Bisect(const CompactGraph<V, E> & graph, const vector<int> & piece, vector<int> & mark, int stamp,
+	vector<int> & first, vector<int> & second)
+{
+	const int * targets = graph.GetTargets();
+	vector<int> order;
+	int far = piece[0];
+
+	for (int walk = 0; walk < 2; walk++)
+	{
+		for (size_t i = 0; i < piece.size(); i++)
+		{
+			mark[piece[i]] = 2 * stamp;			//In the piece, not yet reached
+		}
+		order.clear();
+		size_t unreached = 0;				//Next vertex of piece to restart from
+		order.push_back(far);
+		mark[far] = 2 * stamp + 1;
+		for (size_t next = 0; order.size() < piece.size(); next++)
+		{
+			if (next == order.size())
+			{
+				while (mark[piece[unreached]] != 2 * stamp)
+				{
+					unreached++;
+				}
+				order.push_back(piece[unreached]);
+				mark[piece[unreached]] = 2 * stamp + 1;
+			}
+			int from = order[next];
+			for (int edge = graph.GetEdgeBegin(from); edge != graph.GetEdgeEnd(from); ++edge)
+			{
+				if (mark[targets[edge]] == 2 * stamp)
+				{
+					mark[targets[edge]] = 2 * stamp + 1;
+					order.push_back(targets[edge]);
+				}
+			}
+		}
+		far = order.back();
+	}
+
+	first.assign(order.begin(), order.begin() + order.size() / 2);
+	second.assign(order.begin() + order.size() / 2, order.end());
+}
@@ -0,0 +1,215 @@
+/************************************************************************
+* Class: NameTable
+*
+* Purpose: This class is the lookup layer between place names and the
+*		   dense integer ids (0 to n-1) used by Graph<uint32_t, RoadClass>.
+*		   Names only live here; the graph and the searches only ever
+*		   see ids.
+*
+* Manager functions
+*	NameTable()
+*		Creates an empty table.
+*	~NameTable()
+*		Clears the table.
+*	NameTable(const NameTable & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const NameTable & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Intern(const string & name)
+*		Returns the id of name, giving it the next id if it is new.
+*	GetId(const string & name)
+*		Returns the id of name, throws if it isn't in the table.
+*	Find(const string & name)
+*		Returns the id of name, or NO_NAME if it isn't in the table.
+*	Contains(const string & name)
+*		Returns whether or not name has an id.
+*	GetName(uint32_t id)
+*		Returns the name with the given id.
+*	GetCount()
+*		Returns the number of names.
+*************************************************************************/
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <limits>
+#include "Exception.h"
+using std::string;
+using std::vector;
+using std::map;
+
+#pragma once
+#ifndef NAMETABLE_H
+#define NAMETABLE_H
+
+const uint32_t NO_NAME = std::numeric_limits<uint32_t>::max();	//No name has this id, it is KeyTraits<uint32_t>::None()
+
+class NameTable
+{
+public:
+	NameTable();
+	~NameTable();
+	NameTable(const NameTable & copy);
+	const NameTable & operator=(const NameTable & rhs);
+
+	uint32_t Intern(const string & name);
+	uint32_t GetId(const string & name) const;
+	uint32_t Find(const string & name) const;
+	bool Contains(const string & name) const;
+	const string & GetName(uint32_t id) const;
+	int GetCount() const;
+
+private:
+	vector<string> m_names;			//Name of each id
+	map<string, uint32_t> m_ids;	//Id of each name
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty table.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The table is empty.
+************************************************************************/
+inline NameTable::NameTable()
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the table.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: The table is empty.
+************************************************************************/
+inline NameTable::~NameTable()
+{
+	m_names.clear();
+	m_ids.clear();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+inline NameTable::NameTable(const NameTable & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+inline const NameTable & NameTable::operator=(const NameTable & rhs)
+{
+	if (this != &rhs)
+	{
+		m_names = rhs.m_names;
+		m_ids = rhs.m_ids;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function returns the id of name, giving it the next id
+*		   if it has not been seen before.
+*
+* Precondition:	N/A
+*
+* Postcondition: name is in the table and its id is returned.
+************************************************************************/
+inline uint32_t NameTable::Intern(const string & name)
+{
+	map<string, uint32_t>::iterator found = m_ids.find(name);
+	if (found != m_ids.end())
+	{
+		return found->second;
+	}
+
+	uint32_t id = static_cast<uint32_t>(m_names.size());
+	m_names.push_back(name);
+	m_ids[name] = id;
+	return id;
+}
+
+/**********************************************************************
+* Purpose: This function returns the id of name.
+*
+* Precondition:	name is in the table.
+*
+* Postcondition: The id is returned.
+************************************************************************/
+inline uint32_t NameTable::GetId(const string & name) const
+{
+	map<string, uint32_t>::const_iterator found = m_ids.find(name);
+	if (found == m_ids.end())
+	{
+		throw Exception("Name is not in the table");
+	}
+	return found->second;
+}
+
+/**********************************************************************
+* Purpose: This function returns the id of name without throwing, for
+*		   lookups where a missing name is reported further on, as a
+*		   vertex that isn't in the graph.
+*
+* Precondition:	N/A
+*
+* Postcondition: The id is returned, NO_NAME if name has none.
+************************************************************************/
+inline uint32_t NameTable::Find(const string & name) const
+{
+	map<string, uint32_t>::const_iterator found = m_ids.find(name);
+	return found == m_ids.end() ? NO_NAME : found->second;
+}
+
+/**********************************************************************
+* Purpose: This function returns whether or not name has an id.
+*
+* Precondition:	N/A
+*
+* Postcondition: The status is returned.
+************************************************************************/
+inline bool NameTable::Contains(const string & name) const
+{
+	return m_ids.find(name) != m_ids.end();
+}
+
+/**********************************************************************
+* Purpose: This function returns the name with the given id.
+*
+* Precondition:	id is in the table.
+*
+* Postcondition: The name is returned.
+************************************************************************/
+inline const string & NameTable::GetName(uint32_t id) const
+{
+	if (id >= m_names.size())
+	{
+		throw Exception("Id is not in the table");
+	}
+	return m_names[id];
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of names.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int NameTable::GetCount() const
+{
+	return static_cast<int>(m_names.size());
+}
@@ -0,0 +1,373 @@
+/*************************************************************
+* Filename:		Parallel.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Small threading helpers shared by the parallel engines.
+*	ParallelFor() starts and joins its threads on every call, which
+*	is fine for one big loop. Engines that run a short loop per
+*	phase (a bucket, a BFS level) keep a WorkerPool instead, whose
+*	threads sleep between loops.
+**************************************************************/
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+using std::thread;
+using std::vector;
+using std::atomic;
+using std::mutex;
+using std::condition_variable;
+using std::unique_lock;
+using std::lock_guard;
+using std::function;
+
+#pragma once
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+int DefaultThreadCount();	//Number of hardware threads, at least 1
+
+template <typename Func>
+void ParallelFor(int begin, int end, int threads, Func func);	//Calls func(worker, i) for every i in [begin, end)
+
+bool AtomicMin(atomic<int> & target, int value);	//Lowers target to value, true if it changed
+
+const int POOL_GRAIN = 64;	//Fewest loop items worth waking another pool thread for
+
+/************************************************************************
+* Class: WorkerPool
+*
+* Purpose: This class keeps threads - 1 threads asleep between parallel
+*		   loops. The calling thread is worker 0; For() wakes the others,
+*		   splits the range the way ParallelFor() does, and returns once
+*		   every worker has finished its chunk, so each call is one
+*		   phase with a barrier at the end. A phase only wakes one
+*		   worker per POOL_GRAIN items, as waking costs more than a
+*		   few relaxations.
+*
+* Manager functions
+*	WorkerPool(int threads)
+*		Starts the threads, threads < 1 uses every hardware thread.
+*	~WorkerPool()
+*		Stops and joins the threads.
+*
+* Methods:
+*	For(int begin, int end, Func func)
+*		Calls func(worker, i) for every i in [begin, end).
+*	ForEachChunk(int begin, int end, Func func)
+*		Calls func(worker, first, last) once per worker's chunk.
+*	GetThreadCount()
+*		Returns the number of workers, the calling thread included.
+*************************************************************************/
+class WorkerPool
+{
+public:
+	WorkerPool(int threads);
+	~WorkerPool();
+
+	template <typename Func>
+	void For(int begin, int end, Func func);
+	template <typename Func>
+	void ForEachChunk(int begin, int end, Func func);
+	int GetThreadCount() const;
+
+private:
+	WorkerPool(const WorkerPool & copy);	//Not copyable, the threads point at this
+	const WorkerPool & operator=(const WorkerPool & rhs);
+
+	void Work(int worker);		//Loop each pool thread runs until the pool stops
+	void RunChunk(int worker);
+
+	vector<thread> m_threads;
+	mutex m_lock;
+	condition_variable m_wake;		//A loop was posted, or the pool is stopping
+	condition_variable m_done;		//The last pool thread finished its chunk
+	function<void(int, int, int)> m_func;	//Body of the current loop, per chunk
+	int m_begin;
+	int m_end;
+	int m_chunk;
+	int m_active;			//Workers the current loop is split across
+	long long m_round;		//Loops posted so far, so a thread runs each one once
+	int m_busy;				//Pool threads still in the current loop
+	bool m_stopping;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function returns the number of hardware threads.
+*
+* Precondition:	N/A
+*
+* Postcondition: The thread count is returned, never less than 1.
+************************************************************************/
+inline int DefaultThreadCount()
+{
+	int count = static_cast<int>(thread::hardware_concurrency());
+	return count > 0 ? count : 1;
+}
+
+/**********************************************************************
+* Purpose: This function splits [begin, end) into one contiguous chunk per
+*		   thread and calls func(worker, i) for every i. Worker 0 runs on
+*		   the calling thread, so threads == 1 never spawns anything.
+*
+* Precondition:	func is safe to call from several threads at once.
+*
+* Postcondition: func was called once for every i.
+************************************************************************/
+template<typename Func>
+void ParallelFor(int begin, int end, int threads, Func func)
+{
+	int count = end - begin;
+	if (threads > count)
+	{
+		threads = count;
+	}
+	if (threads <= 1)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			func(0, i);
+		}
+		return;
+	}
+
+	vector<thread> workers;
+	int chunk = (count + threads - 1) / threads;
+
+	for (int worker = 1; worker < threads; worker++)
+	{
+		int first = begin + worker * chunk;
+		int last = (first + chunk < end) ? first + chunk : end;
+		workers.push_back(thread([=, &func]()
+		{
+			for (int i = first; i < last; i++)
+			{
+				func(worker, i);
+			}
+		}));
+	}
+	for (int i = begin; i < begin + chunk && i < end; i++)	//Worker 0 does the first chunk
+	{
+		func(0, i);
+	}
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+}
+
+/**********************************************************************
+* Purpose: This function lowers target to value if value is smaller,
+*		   retrying when another thread changed it in between.
+*
+* Precondition:	N/A
+*
+* Postcondition: target is the min of its old value and value.
+************************************************************************/
+inline bool AtomicMin(atomic<int> & target, int value)
+{
+	int current = target.load(std::memory_order_relaxed);
+	while (value < current)
+	{
+		if (target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**********************************************************************
+* Purpose: This function starts threads - 1 pool threads, which sleep
+*		   until For() posts a loop.
+*
+* Precondition:	N/A
+*
+* Postcondition: The pool is ready.
+************************************************************************/
+inline WorkerPool::WorkerPool(int threads) : m_begin(0), m_end(0), m_chunk(0), m_active(1), m_round(0), m_busy(0), m_stopping(false)
+{
+	if (threads < 1)
+	{
+		threads = DefaultThreadCount();
+	}
+	for (int worker = 1; worker < threads; worker++)
+	{
+		m_threads.push_back(thread(&WorkerPool::Work, this, worker));
+	}
+}
+
+/**********************************************************************
+* Purpose: This function wakes every pool thread to stop, and joins it.
+*
+* Precondition:	No For() is running.
+*
+* Postcondition: The threads are gone.
+************************************************************************/
+inline WorkerPool::~WorkerPool()
+{
+	{
+		lock_guard<mutex> lock(m_lock);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (size_t i = 0; i < m_threads.size(); i++)
+	{
+		m_threads[i].join();
+	}
+}
+
+/**********************************************************************
+* Purpose: This function calls func(worker, i) for every i in [begin, end),
+*		   split the way ForEachChunk() splits it.
+*
+* Precondition:	func is safe to call from several threads at once, and
+*				only one thread calls For() at a time.
+*
+* Postcondition: func was called once for every i, and every worker is
+*				 done with it.
+************************************************************************/
+template<typename Func>
+void WorkerPool::For(int begin, int end, Func func)
+{
+	ForEachChunk(begin, end, [&func](int worker, int first, int last)
+	{
+		for (int i = first; i < last; i++)
+		{
+			func(worker, i);
+		}
+	});
+}
+
+/**********************************************************************
+* Purpose: This function splits [begin, end) into one contiguous chunk per
+*		   worker, at most one per POOL_GRAIN items, and calls
+*		   func(worker, first, last) once for each. A loop can count
+*		   into locals and add them to its worker's slot once, instead
+*		   of writing a slot next to other workers' on every item. A
+*		   range too short to share runs on the calling thread without
+*		   waking anyone.
+*
+* Precondition:	func is safe to call from several threads at once, and
+*				only one thread calls For() or ForEachChunk() at a time.
+*
+* Postcondition: Every i was in one call's [first, last), and every
+*				 worker is done with it.
+************************************************************************/
+template<typename Func>
+void WorkerPool::ForEachChunk(int begin, int end, Func func)
+{
+	int count = end - begin;
+	int threads = (count + POOL_GRAIN - 1) / POOL_GRAIN;	//Only as many workers as the range keeps busy
+	if (threads > GetThreadCount())
+	{
+		threads = GetThreadCount();
+	}
+	if (threads <= 1)
+	{
+		if (count > 0)
+		{
+			func(0, begin, end);
+		}
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(m_lock);
+		m_func = func;
+		m_begin = begin;
+		m_end = end;
+		m_chunk = (count + threads - 1) / threads;
+		m_active = threads;
+		m_busy = threads - 1;
+		m_round++;
+	}
+	m_wake.notify_all();
+	RunChunk(0);
+
+	unique_lock<mutex> lock(m_lock);
+	while (m_busy > 0)
+	{
+		m_done.wait(lock);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of workers.
+*
+* Precondition:	N/A
+*
+* Postcondition: The pool threads plus the calling thread are returned.
+************************************************************************/
+inline int WorkerPool::GetThreadCount() const
+{
+	return static_cast<int>(m_threads.size()) + 1;
+}
+
+/**********************************************************************
+* Purpose: This function is the body of each pool thread: sleep until a
+*		   new loop is posted, run this worker's chunk of it if the loop
+*		   was split that far, and tell For() when the last chunk is
+*		   done. A loop can't finish without its workers, so what is
+*		   read under the lock stays valid until this one reports.
+*
+* Precondition:	worker is 1 or more.
+*
+* Postcondition: Returns once the pool is stopping.
+************************************************************************/
+inline void WorkerPool::Work(int worker)
+{
+	long long seen = 0;
+	while (true)
+	{
+		bool needed = false;	//Whether this loop has a chunk for worker
+		{
+			unique_lock<mutex> lock(m_lock);
+			while (!m_stopping && m_round == seen)
+			{
+				m_wake.wait(lock);
+			}
+			if (m_stopping)
+			{
+				return;
+			}
+			seen = m_round;
+			needed = worker < m_active;
+		}
+
+		if (needed)
+		{
+			RunChunk(worker);
+
+			lock_guard<mutex> lock(m_lock);
+			if (--m_busy == 0)
+			{
+				m_done.notify_one();
+			}
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function calls the current loop for this worker's chunk.
+*
+* Precondition:	A loop is posted and split across more than worker.
+*
+* Postcondition: func was called for the chunk.
+************************************************************************/
+inline void WorkerPool::RunChunk(int worker)
+{
+	int first = m_begin + worker * m_chunk;
+	int last = (first + m_chunk < m_end) ? first + m_chunk : m_end;
+	if (first < last)
+	{
+		m_func(worker, first, last);
+	}
+}
+#endif
@@ -0,0 +1,255 @@
+/*************************************************************
+* Filename:		ParallelBfs.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Level synchronous parallel breadth first search on a
+*	CompactGraph, giving the hop count and parent of every vertex
+*	(Beamer's direction optimizing BFS). Each level is expanded
+*	one of two ways:
+*		Top down - the frontier is a list, each frontier vertex
+*			looks at its edges and claims unvisited neighbors
+*			with a compare and swap on the parent array, so no
+*			vertex is queued twice.
+*		Bottom up - the frontier is a Bitmap, each unvisited
+*			vertex looks for any neighbor in it and stops at the
+*			first. Threads split the bitmap by 64 bit word, so
+*			each one writes only its own words of the next one.
+*	Top down is cheap while the frontier is small; once the edges
+*	leaving the frontier pass 1/ALPHA of the edges left unvisited,
+*	bottom up skips most of them. Bottom up is only tried while the
+*	frontier holds at least 1/BETA of the vertices, and it goes back
+*	to top down below that. Road networks have narrow frontiers and
+*	a long diameter, so without that floor the end of every search
+*	flips between the two, each bottom up level rescanning every
+*	unvisited edge to settle a few dozen vertices.
+*
+*	Hops are the same for any thread count. Parents are a vertex
+*	one hop closer, but which one can depend on thread timing.
+*	With a SearchStats every vertex reached counts as a settle and
+*	every edge looked at as a relax, so the edges bottom up saves
+*	show up in relaxed.
+**************************************************************/
+#include <vector>
+#include <atomic>
+#include <memory>
+#include "CompactGraph.h"
+#include "Bitmap.h"
+#include "Parallel.h"
+#include "SearchStats.h"
+using std::vector;
+using std::atomic;
+using std::unique_ptr;
+
+#pragma once
+#ifndef PARALLELBFS_H
+#define PARALLELBFS_H
+
+const int BFS_ALPHA = 14;	//Go bottom up when frontier edges > unvisited edges / ALPHA
+const int BFS_BETA = 24;	//Go back top down when frontier < vertices / BETA
+
+template <typename V, typename E>
+int ParallelBreadthFirst(const CompactGraph<V, E> & graph, int source, int threads, vector<int> & hops, vector<int> & parent,
+	SearchStats * stats = nullptr);	//Hop count and parent of every vertex
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function finds the number of hops from source to every
+*		   vertex, and a parent one hop closer, switching each level
+*		   between top down and bottom up as described above.
+*
+* Precondition:	source is a valid index of graph; the graph is two way,
+*				as bottom up looks for parents along outgoing edges.
+*				threads < 1 uses every hardware thread.
+*
+* Postcondition: hops holds the hop count of every vertex
+*				 (INFINITE_DISTANCE if unreached) and parent its parent
+*				 (NO_VERTEX for source and unreached vertices). The
+*				 number of levels is returned.
+************************************************************************/
+template<typename V, typename E>
+int ParallelBreadthFirst(const CompactGraph<V, E> & graph, int source, int threads, vector<int> & hops, vector<int> & parent,
+	SearchStats * stats)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (threads < 1)
+	{
+		threads = DefaultThreadCount();
+	}
+
+	const int SIZE = graph.GetVertexCount();
+	const int * targets = graph.GetTargets();
+	WorkerPool pool(threads);	//Started once, every level is one short loop
+	unique_ptr<atomic<int>[]> parents(new atomic<int>[SIZE]);	//Parent while searching, NO_VERTEX until reached
+	atomic<int> * owner = parents.get();
+	vector<int> frontier;					//Top down frontier
+	Bitmap current(SIZE);					//Bottom up frontier
+	Bitmap next(SIZE);
+	vector<vector<int>> found(threads);		//Vertices each worker claimed this level, top down
+	vector<long long> reached(threads);		//Number each worker claimed this level
+	vector<long long> examined(threads);	//Edges each worker looked at this level
+	vector<long long> degrees(threads);		//Edges leaving what each worker claimed
+	long long unvisitedEdges = graph.GetEdgeCount() - (graph.GetEdgeEnd(source) - graph.GetEdgeBegin(source));
+	long long frontierEdges = graph.GetEdgeEnd(source) - graph.GetEdgeBegin(source);
+	long long frontierSize = 1;
+	bool bottomUp = false;
+	int level = 0;
+	SearchStats counts;
+	counts.searchSeconds -= StatsClock();
+
+	hops.assign(SIZE, INFINITE_DISTANCE);
+	pool.For(0, SIZE, [&](int, int i)
+	{
+		owner[i].store(NO_VERTEX, std::memory_order_relaxed);
+	});
+	owner[source].store(source, std::memory_order_relaxed);	//Marks it reached, cleared at the end
+	hops[source] = 0;
+	frontier.push_back(source);
+	STATS_ADD(counts.settled, 1);
+
+	while (frontierSize > 0)
+	{
+		//************************** Pick a direction **********************************
+		if (!bottomUp && frontierEdges > unvisitedEdges / BFS_ALPHA && frontierSize >= SIZE / BFS_BETA)
+		{
+			bottomUp = true;
+			current.ClearAll();
+			for (size_t i = 0; i < frontier.size(); i++)
+			{
+				current.Set(frontier[i]);
+			}
+		}
+		else if (bottomUp && frontierSize < SIZE / BFS_BETA)
+		{
+			bottomUp = false;
+			frontier.clear();
+			for (int i = 0; i < SIZE; i++)
+			{
+				if (current.Test(i))
+				{
+					frontier.push_back(i);
+				}
+			}
+		}
+
+		for (int worker = 0; worker < threads; worker++)
+		{
+			found[worker].clear();
+			reached[worker] = 0;
+			examined[worker] = 0;
+			degrees[worker] = 0;
+		}
+
+		//************************** Expand one level **********************************
+		if (bottomUp)
+		{
+			next.ClearAll();
+			uint64_t * nextWords = next.GetWords();
+			pool.ForEachChunk(0, current.GetWordCount(), [&](int worker, int firstWord, int lastWord)
+			{
+				long long claimed = 0;	//Counted here and added once, as the workers' slots share cache lines
+				long long looked = 0;
+				long long degree = 0;
+				for (int word = firstWord; word < lastWord; word++)
+				{
+					uint64_t bits = 0;
+					int last = (word + 1) * 64 < SIZE ? (word + 1) * 64 : SIZE;
+					for (int vertex = word * 64; vertex < last; vertex++)
+					{
+						if (owner[vertex].load(std::memory_order_relaxed) == NO_VERTEX)
+						{
+							for (int edge = graph.GetEdgeBegin(vertex); edge != graph.GetEdgeEnd(vertex); ++edge)
+							{
+								looked++;
+								if (current.Test(targets[edge]))
+								{
+									owner[vertex].store(targets[edge], std::memory_order_relaxed);
+									hops[vertex] = level + 1;
+									bits |= uint64_t(1) << (vertex & 63);
+									claimed++;
+									degree += graph.GetEdgeEnd(vertex) - graph.GetEdgeBegin(vertex);
+									break;
+								}
+							}
+						}
+					}
+					nextWords[word] = bits;	//Only this worker writes this word
+				}
+				reached[worker] += claimed;
+				examined[worker] += looked;
+				degrees[worker] += degree;
+			});
+			current.Swap(next);
+		}
+		else
+		{
+			pool.ForEachChunk(0, static_cast<int>(frontier.size()), [&](int worker, int first, int last)
+			{
+				vector<int> claimed;	//Swapped out of found, so its size isn't written next to other workers'
+				long long looked = 0;
+				long long degree = 0;
+				claimed.swap(found[worker]);
+				for (int i = first; i < last; i++)
+				{
+					int from = frontier[i];
+					for (int edge = graph.GetEdgeBegin(from); edge != graph.GetEdgeEnd(from); ++edge)
+					{
+						int to = targets[edge];
+						int unclaimed = NO_VERTEX;
+						looked++;
+						if (owner[to].load(std::memory_order_relaxed) == NO_VERTEX
+							&& owner[to].compare_exchange_strong(unclaimed, from, std::memory_order_relaxed))
+						{
+							hops[to] = level + 1;
+							claimed.push_back(to);
+							degree += graph.GetEdgeEnd(to) - graph.GetEdgeBegin(to);
+						}
+					}
+				}
+				reached[worker] += static_cast<long long>(claimed.size());
+				examined[worker] += looked;
+				degrees[worker] += degree;
+				claimed.swap(found[worker]);
+			});
+			frontier.clear();
+			for (int worker = 0; worker < threads; worker++)
+			{
+				frontier.insert(frontier.end(), found[worker].begin(), found[worker].end());
+			}
+		}
+
+		frontierSize = 0;
+		frontierEdges = 0;
+		for (int worker = 0; worker < threads; worker++)
+		{
+			frontierSize += reached[worker];
+			frontierEdges += degrees[worker];
+			STATS_ADD(counts.relaxed, examined[worker]);
+		}
+		unvisitedEdges -= frontierEdges;
+		STATS_ADD(counts.settled, frontierSize);
+		level++;
+	}
+
+	parent.resize(SIZE);
+	for (int i = 0; i < SIZE; i++)
+	{
+		parent[i] = i == source ? NO_VERTEX : owner[i].load(std::memory_order_relaxed);
+	}
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.searchSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+	return level;
+}
+#endif
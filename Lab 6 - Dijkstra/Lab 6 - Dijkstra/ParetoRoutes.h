@@ -0,0 +1,548 @@
+/*************************************************************
+* Filename:		ParetoRoutes.h
+* Date Created:	10/19/26
+* Modifications:
+*	Pruned against every route to the end found, settled or not,
+*	and again off the heap; the measured limits are below.
+*
+* Overview:
+*	Routes that trade one cost against another, like miles against
+*	miles off the interstates. ParetoRoutes() returns the Pareto
+*	front: every route that no other route beats or ties on all of
+*	the criteria (one to three per edge weight arrays), cheapest on
+*	the first criterion first.
+*
+*	It is a multi-criteria label-setting search. A label is one way
+*	to reach a vertex with its cost on every criterion; a vertex
+*	keeps the labels no other label there dominates in its bag.
+*	Labels live in one arena, an array that only grows. Bags live
+*	in a second one, each a run of (cost, label) entries that moves
+*	to a run twice as long at the end when it fills, so checking a
+*	new label against a bag reads one block of memory and a query
+*	makes no allocation per label beyond the arenas' growth. Three
+*	things keep the bags small:
+*		- A label dominated at its vertex is dropped, and the labels
+*		  a new one dominates are taken out of the bag.
+*		- One search from the end per criterion, back along the
+*		  edges into each vertex, gives the exact lowest cost left
+*		  on each. A label whose cost plus those is dominated by a
+*		  route already in the end's bag, settled or not, can't
+*		  lead to a new route and is dropped, on every criterion.
+*		  Labels are checked again when they come off the heap, as
+*		  routes found since they were pushed may beat them.
+*		- Labels are settled in order of that estimated total, so
+*		  a label is never dominated after it is settled.
+*
+*	Since the searches from the end follow edges backward, a
+*	criterion may weigh a road differently each way, like a climb
+*	that costs fuel one way only.
+*
+*	The front is exact, so the search is as large as the front.
+*	Miles against miles off the interstates on a 200,000 vertex
+*	planar network took 0.05 to 1.4 s a query (0.3 s on average),
+*	with fronts of 13 to 206 routes and up to about 1.1 million
+*	labels settled; adding driving time took up to 4.4 s. That is
+*	for planning ahead, not for a query per keystroke. labelLimit
+*	caps the arena (PARETO_LABEL_LIMIT labels is 128 MB) and the
+*	front found so far is returned, with false, when it is hit.
+**************************************************************/
+#include <vector>
+#include <algorithm>
+#include "CompactGraph.h"
+#include "SearchWorkspace.h"
+#include "RadixHeap.h"
+#include "BinaryHeap.h"
+#include "RoadClass.h"
+#include "SearchStats.h"
+#include "Exception.h"
+using std::vector;
+
+#pragma once
+#ifndef PARETOROUTES_H
+#define PARETOROUTES_H
+
+const int PARETO_MAX_CRITERIA = 3;			//Most criteria a search can weigh
+const int PARETO_LABEL_LIMIT = 1 << 22;		//Default cap on labels, 128 MB of arena
+
+struct ParetoRoute
+{
+	int cost[PARETO_MAX_CRITERIA];	//Sum of each criterion's weights, unused ones 0
+	vector<int> vertices;			//Graph index of each stop, start to end
+	vector<int> edges;				//Edge id between each pair of stops
+};
+
+struct ParetoLabel
+{
+	int cost[PARETO_MAX_CRITERIA];
+	int vertex;
+	int parent;		//Label it was reached from, NO_VERTEX at the start
+	int edge;		//Edge from the parent's vertex
+	bool dead;		//Taken out of its bag by a label that dominates it
+};
+
+struct ParetoBagEntry
+{
+	int cost[PARETO_MAX_CRITERIA];
+	int label;
+};
+
+struct ParetoBag
+{
+	int begin;		//First entry in the bag arena
+	int size;
+	int capacity;
+};
+
+template <typename V, typename E>
+bool ParetoRoutes(const CompactGraph<V, E> & graph, const vector<const int *> & criteria, int source, int target,
+	SearchWorkspace & workspace, vector<ParetoRoute> & routes, int labelLimit = PARETO_LABEL_LIMIT,
+	SearchStats * stats = nullptr);	//Pareto front of routes on up to three criteria
+
+template <typename V, typename E>
+void IncomingEdges(const CompactGraph<V, E> & graph, vector<int> & begin, vector<int> & edges,
+	vector<int> & sources);	//Edge ids grouped by the vertex they end at, and where each starts
+
+template <typename V, typename E>
+void CostsIntoTarget(const CompactGraph<V, E> & graph, const vector<int> & begin, const vector<int> & edges,
+	const vector<int> & sources, const int * weights, int target, SearchWorkspace & workspace, vector<int> & cost,
+	SearchStats & counts);	//Dijkstra from target back along the edges
+
+template <typename V, typename E>
+vector<int> MilesOffInterstates(const CompactGraph<V, E> & graph);	//Miles of each edge that is not an interstate, else 0
+
+bool Dominates(const int * a, const int * b, int count);	//a is no worse than b on every criterion
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function finds every Pareto optimal route from source to
+*		   target on criteria, each a weight of 0 or more per edge id.
+*		   Of routes that tie on every criterion only one is returned.
+*
+* Precondition:	criteria holds 1 to PARETO_MAX_CRITERIA arrays.
+*
+* Postcondition: routes holds the front, cheapest on the first criterion
+*				 first, empty if target can't be reached. true is
+*				 returned if the front is complete, false if labelLimit
+*				 stopped the search first.
+************************************************************************/
+template<typename V, typename E>
+bool ParetoRoutes(const CompactGraph<V, E> & graph, const vector<const int *> & criteria, int source, int target,
+	SearchWorkspace & workspace, vector<ParetoRoute> & routes, int labelLimit, SearchStats * stats)
+{
+	const int COUNT = static_cast<int>(criteria.size());
+	const int * targets = graph.GetTargets();
+	vector<vector<int>> bound(COUNT);		//Lowest cost left to target on each criterion
+	vector<int> inBegin, inEdges, sources;	//Edges into each vertex, for the searches from the end
+	vector<ParetoLabel> arena;
+	vector<ParetoBagEntry> entries;			//Every bag's run of entries
+	vector<ParetoBag> bags;					//Bags of the vertices reached
+	vector<int> found;						//Labels at target
+	BinaryHeap<long long> heap;				//Estimated total, label
+	bool complete = true;
+	SearchStats counts;
+	counts.searchSeconds -= StatsClock();
+
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (target < 0 || target >= graph.GetVertexCount())
+	{
+		throw Exception("Ending vertex is not in the graph!");
+	}
+	if (COUNT < 1 || COUNT > PARETO_MAX_CRITERIA)
+	{
+		throw Exception("Pareto routes take 1 to 3 criteria");
+	}
+
+	routes.clear();
+	if (graph.MayConnect(source, target))
+	{
+		IncomingEdges(graph, inBegin, inEdges, sources);
+		for (int c = 0; c < COUNT; c++)
+		{
+			CostsIntoTarget(graph, inBegin, inEdges, sources, criteria[c], target, workspace, bound[c], counts);
+		}
+	}
+	workspace.Prepare(graph.GetVertexCount());
+	int * bagOf = workspace.GetPreds();		//Each vertex's bag, NO_VERTEX if none yet
+
+	//Whether a route to target already found, settled or not, is no dearer than estimate on every criterion
+	auto Beaten = [&](const int * estimate)
+	{
+		if (bagOf[target] == NO_VERTEX)
+		{
+			return false;
+		}
+		const ParetoBag & bag = bags[bagOf[target]];
+		const ParetoBagEntry * run = entries.data() + bag.begin;
+		if (COUNT <= 2)
+		{
+			//Sorted by the first criterion, so of the routes no dearer on it the last is the
+			//cheapest on the second
+			int low = 0;
+			int high = bag.size;
+			while (low < high)
+			{
+				int middle = (low + high) / 2;
+				if (run[middle].cost[0] <= estimate[0])
+				{
+					low = middle + 1;
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+			return low > 0 && run[low - 1].cost[COUNT - 1] <= estimate[COUNT - 1];
+		}
+		for (int i = 0; i < bag.size; i++)
+		{
+			if (Dominates(run[i].cost, estimate, COUNT))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	//Adds a label at vertex unless its bag or a route already found dominates it
+	auto Offer = [&](const int * cost, int vertex, int parent, int edge)
+	{
+		int estimate[PARETO_MAX_CRITERIA] = { 0, 0, 0 };
+		long long key = 0;
+		for (int c = 0; c < COUNT; c++)
+		{
+			if (bound[c][vertex] == INFINITE_DISTANCE)
+			{
+				return;
+			}
+			estimate[c] = cost[c] + bound[c][vertex];
+			key += estimate[c];
+		}
+		if (vertex != target && Beaten(estimate))
+		{
+			return;
+		}
+		if (bagOf[vertex] == NO_VERTEX)
+		{
+			ParetoBag empty = { 0, 0, 0 };
+			workspace.Touch(vertex);
+			bagOf[vertex] = static_cast<int>(bags.size());
+			bags.push_back(empty);
+		}
+		ParetoBag & bag = bags[bagOf[vertex]];
+		int first = bag.size;	//The new entry goes at first, in place of the ones up to last it dominates
+		int last = bag.size;
+		if (COUNT <= 2)
+		{
+			//Kept sorted by the first criterion, so the last one falls along the bag: only the
+			//entry before cost can dominate it, and the ones it dominates come right after it
+			int low = 0;
+			int high = bag.size;
+			while (low < high)
+			{
+				int middle = (low + high) / 2;
+				if (entries[bag.begin + middle].cost[0] <= cost[0])
+				{
+					low = middle + 1;
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+			if (low > 0 && entries[bag.begin + low - 1].cost[COUNT - 1] <= cost[COUNT - 1])
+			{
+				return;
+			}
+			first = low > 0 && entries[bag.begin + low - 1].cost[0] == cost[0] ? low - 1 : low;
+			last = low;
+			while (last < bag.size && entries[bag.begin + last].cost[COUNT - 1] >= cost[COUNT - 1])
+			{
+				last++;
+			}
+		}
+		else
+		{
+			for (int i = 0; i < bag.size; )
+			{
+				ParetoBagEntry & other = entries[bag.begin + i];
+				if (Dominates(other.cost, cost, COUNT))
+				{
+					return;
+				}
+				if (Dominates(cost, other.cost, COUNT))
+				{
+					arena[other.label].dead = true;
+					other = entries[bag.begin + --bag.size];
+				}
+				else
+				{
+					i++;
+				}
+			}
+			first = bag.size;
+			last = bag.size;
+		}
+		if (static_cast<int>(arena.size()) >= labelLimit)
+		{
+			complete = false;
+			return;
+		}
+		if (first == last && bag.size == bag.capacity)	//Move to a run twice as long
+		{
+			int begin = static_cast<int>(entries.size());
+			bag.capacity = bag.capacity == 0 ? 4 : bag.capacity * 2;
+			entries.resize(entries.size() + bag.capacity);
+			std::copy(entries.begin() + bag.begin, entries.begin() + bag.begin + bag.size, entries.begin() + begin);
+			bag.begin = begin;
+		}
+		ParetoBagEntry * run = &entries[bag.begin];
+		for (int i = first; i < last; i++)
+		{
+			arena[run[i].label].dead = true;
+		}
+		if (first == last)
+		{
+			std::copy_backward(run + first, run + bag.size, run + bag.size + 1);
+		}
+		else
+		{
+			std::copy(run + last, run + bag.size, run + first + 1);
+		}
+		bag.size += 1 - (last - first);
+
+		ParetoLabel label;
+		for (int c = 0; c < PARETO_MAX_CRITERIA; c++)
+		{
+			label.cost[c] = c < COUNT ? cost[c] : 0;
+		}
+		label.vertex = vertex;
+		label.parent = parent;
+		label.edge = edge;
+		label.dead = false;
+		ParetoBagEntry & entry = run[first];
+		std::copy(label.cost, label.cost + PARETO_MAX_CRITERIA, entry.cost);
+		entry.label = static_cast<int>(arena.size());
+		arena.push_back(label);
+		heap.Push(key, entry.label);
+		STATS_ADD(counts.pushes, 1);
+	};
+
+	//************************** Settle labels **********************************
+	if (graph.MayConnect(source, target))
+	{
+		int zero[PARETO_MAX_CRITERIA] = { 0, 0, 0 };
+		Offer(zero, source, NO_VERTEX, NO_VERTEX);
+	}
+	while (!heap.IsEmpty())
+	{
+		int index = heap.GetTopVertex();
+		heap.Pop();
+		STATS_ADD(counts.pops, 1);
+		if (arena[index].dead)
+		{
+			continue;
+		}
+		int vertex = arena[index].vertex;
+		if (vertex == target)
+		{
+			STATS_ADD(counts.settled, 1);
+			found.push_back(index);
+			continue;
+		}
+		int estimate[PARETO_MAX_CRITERIA];
+		for (int c = 0; c < COUNT; c++)
+		{
+			estimate[c] = arena[index].cost[c] + bound[c][vertex];
+		}
+		if (Beaten(estimate))
+		{
+			continue;	//A route found since it was pushed does as well
+		}
+		STATS_ADD(counts.settled, 1);
+		int parentVertex = arena[index].parent == NO_VERTEX ? NO_VERTEX : arena[arena[index].parent].vertex;
+		for (int edge = graph.GetEdgeBegin(vertex); edge != graph.GetEdgeEnd(vertex); ++edge)
+		{
+			if (targets[edge] == parentVertex)
+			{
+				continue;	//Straight back never helps
+			}
+			int cost[PARETO_MAX_CRITERIA];
+			for (int c = 0; c < COUNT; c++)
+			{
+				cost[c] = arena[index].cost[c] + criteria[c][edge];
+			}
+			STATS_ADD(counts.relaxed, 1);
+			Offer(cost, targets[edge], index, edge);	//May grow the arena, so nothing holds a reference
+		}
+	}
+	counts.searchSeconds += StatsClock();
+	counts.reconstructSeconds -= StatsClock();
+
+	//************************** Walk back the front **********************************
+	for (size_t i = 0; i < found.size(); i++)
+	{
+		ParetoRoute route;
+		for (int c = 0; c < PARETO_MAX_CRITERIA; c++)
+		{
+			route.cost[c] = arena[found[i]].cost[c];
+		}
+		for (int label = found[i]; label != NO_VERTEX; label = arena[label].parent)
+		{
+			route.vertices.push_back(arena[label].vertex);
+			if (arena[label].edge != NO_VERTEX)
+			{
+				route.edges.push_back(arena[label].edge);
+			}
+		}
+		std::reverse(route.vertices.begin(), route.vertices.end());
+		std::reverse(route.edges.begin(), route.edges.end());
+		routes.push_back(route);
+	}
+	std::sort(routes.begin(), routes.end(), [](const ParetoRoute & a, const ParetoRoute & b)
+	{
+		return std::lexicographical_compare(a.cost, a.cost + PARETO_MAX_CRITERIA, b.cost, b.cost + PARETO_MAX_CRITERIA);
+	});
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.reconstructSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+	return complete;
+}
+
+/**********************************************************************
+* Purpose: This function groups the edge ids by the vertex they end at,
+*		   a counting sort on the targets: the edges into v are
+*		   edges[begin[v]] to edges[begin[v + 1] - 1]. sources holds the
+*		   vertex each edge id leaves from.
+*
+* Precondition:	N/A
+*
+* Postcondition: begin holds GetVertexCount() + 1 entries, edges and
+*				 sources one per edge.
+************************************************************************/
+template<typename V, typename E>
+void IncomingEdges(const CompactGraph<V, E> & graph, vector<int> & begin, vector<int> & edges, vector<int> & sources)
+{
+	const int * targets = graph.GetTargets();
+
+	begin.assign(graph.GetVertexCount() + 1, 0);
+	edges.resize(graph.GetEdgeCount());
+	sources.resize(graph.GetEdgeCount());
+	for (int v = 0; v < graph.GetVertexCount(); v++)
+	{
+		for (int edge = graph.GetEdgeBegin(v); edge != graph.GetEdgeEnd(v); ++edge)
+		{
+			sources[edge] = v;
+			begin[targets[edge] + 1]++;
+		}
+	}
+	for (int v = 0; v < graph.GetVertexCount(); v++)
+	{
+		begin[v + 1] += begin[v];
+	}
+	vector<int> next(begin.begin(), begin.end() - 1);
+	for (int edge = 0; edge < graph.GetEdgeCount(); edge++)
+	{
+		edges[next[targets[edge]]++] = edge;
+	}
+}
+
+/**********************************************************************
+* Purpose: This function finds the cheapest cost from every vertex to
+*		   target on weights. It is Dijkstra from target that follows
+*		   the edges into each vertex backward, so unlike CostsToTarget
+*		   it is exact when a road weighs more one way than the other.
+*
+* Precondition:	begin, edges and sources come from IncomingEdges() on
+*				graph; target is a valid index of graph.
+*
+* Postcondition: cost holds one entry per vertex, INFINITE_DISTANCE for
+*				 vertices that can't reach target.
+************************************************************************/
+template<typename V, typename E>
+void CostsIntoTarget(const CompactGraph<V, E> & graph, const vector<int> & begin, const vector<int> & edges,
+	const vector<int> & sources, const int * weights, int target, SearchWorkspace & workspace, vector<int> & cost,
+	SearchStats & counts)
+{
+	RadixHeap<int> & heap = workspace.GetQueue();
+
+	workspace.Prepare(graph.GetVertexCount());
+	cost.assign(graph.GetVertexCount(), INFINITE_DISTANCE);
+	cost[target] = 0;
+	heap.Push(0, target);
+	STATS_ADD(counts.pushes, 1);
+
+	while (!heap.IsEmpty())
+	{
+		int dist = heap.GetTopKey();
+		int current = heap.GetTopVertex();
+		heap.Pop();
+		STATS_ADD(counts.pops, 1);
+
+		if (dist == cost[current])
+		{
+			STATS_ADD(counts.settled, 1);
+			STATS_ADD(counts.relaxed, begin[current + 1] - begin[current]);
+			for (int i = begin[current]; i != begin[current + 1]; ++i)
+			{
+				int from = sources[edges[i]];
+				if (dist + weights[edges[i]] < cost[from])
+				{
+					cost[from] = dist + weights[edges[i]];
+					heap.Push(cost[from], from);
+					STATS_ADD(counts.pushes, 1);
+				}
+			}
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function returns a criterion for avoiding roads that
+*		   are not interstates: the miles of every edge that is not on
+*		   an interstate, 0 for interstate edges.
+*
+* Precondition:	N/A
+*
+* Postcondition: One weight per edge id is returned.
+************************************************************************/
+template<typename V, typename E>
+vector<int> MilesOffInterstates(const CompactGraph<V, E> & graph)
+{
+	vector<int> miles(graph.GetEdgeCount());
+
+	for (int edge = 0; edge < graph.GetEdgeCount(); edge++)
+	{
+		miles[edge] = RoadTraits<E>::IsInterstate(graph.GetEdgeData(edge)) ? 0 : graph.GetWeight(edge);
+	}
+	return miles;
+}
+
+/**********************************************************************
+* Purpose: This function returns whether cost a is no worse than cost b
+*		   on every criterion, so a route costing b is not needed.
+*
+* Precondition:	a and b hold count costs.
+*
+* Postcondition: true is returned if a dominates or equals b.
+************************************************************************/
+inline bool Dominates(const int * a, const int * b, int count)
+{
+	bool dominates = true;
+
+	for (int c = 0; c < count && dominates; c++)
+	{
+		dominates = a[c] <= b[c];
+	}
+	return dominates;
+}
+#endif
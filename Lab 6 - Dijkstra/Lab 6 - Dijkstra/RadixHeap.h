@@ -0,0 +1,301 @@
+/************************************************************************
+* Class: RadixHeap
+*
+* Purpose: This class is a monotone min priority queue of (key, vertex)
+*		   pairs for non-negative integer keys. Entries are kept in one
+*		   bucket per bit of difference from the last key popped, so a
+*		   push is O(1) and every entry is moved at most once per bit.
+*		   It only works when keys are never smaller than the last key
+*		   popped, which is always true in Dijkstra with non-negative
+*		   weights.
+*
+* Manager functions
+*	RadixHeap()
+*		Creates an empty heap.
+*	~RadixHeap()
+*		Clears the heap.
+*	RadixHeap(const RadixHeap<K> & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const RadixHeap<K> & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Push(K key, int vertex)
+*		Adds vertex with priority key.
+*	Pop()
+*		Removes the smallest entry.
+*	GetTopKey() / GetTopVertex()
+*		Returns the smallest entry.
+*	IsEmpty()
+*		Returns whether or not the heap is empty.
+*	Clear()
+*		Removes every entry and starts over from key 0.
+*************************************************************************/
+#include <vector>
+#include <utility>
+#include <climits>
+#include "Exception.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+using std::vector;
+using std::pair;
+using std::make_pair;
+
+#pragma once
+#ifndef RADIXHEAP_H
+#define RADIXHEAP_H
+
+template <typename K>
+class RadixHeap
+{
+public:
+	RadixHeap();
+	~RadixHeap();
+	RadixHeap(const RadixHeap<K> & copy);
+	const RadixHeap<K> & operator=(const RadixHeap<K> & rhs);
+
+	void Push(K key, int vertex);
+	void Pop();
+	K GetTopKey();
+	int GetTopVertex();
+	bool IsEmpty() const;
+	void Clear();
+
+private:
+	static const int BUCKETS = sizeof(K) * CHAR_BIT + 1;	//Bucket 0 is for keys equal to m_last
+
+	int GetBucket(K key) const;
+	void Refill();
+
+	vector<pair<K, int>> m_buckets[BUCKETS];
+	K m_last;		//Last key popped, every key in the heap is >= it
+	int m_size;		//Number of entries
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty heap.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The heap is empty.
+************************************************************************/
+template<typename K>
+inline RadixHeap<K>::RadixHeap() : m_last(0), m_size(0)
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the heap.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: The heap is empty.
+************************************************************************/
+template<typename K>
+inline RadixHeap<K>::~RadixHeap()
+{
+	Clear();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+template<typename K>
+inline RadixHeap<K>::RadixHeap(const RadixHeap<K> & copy) : m_last(0), m_size(0)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+template<typename K>
+inline const RadixHeap<K> & RadixHeap<K>::operator=(const RadixHeap<K> & rhs)
+{
+	if (this != &rhs)
+	{
+		for (int i = 0; i < BUCKETS; i++)
+		{
+			m_buckets[i] = rhs.m_buckets[i];
+		}
+		m_last = rhs.m_last;
+		m_size = rhs.m_size;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function adds vertex with priority key.
+*
+* Precondition:	key is not smaller than the last key popped.
+*
+* Postcondition: The entry is in the heap.
+************************************************************************/
+template<typename K>
+inline void RadixHeap<K>::Push(K key, int vertex)
+{
+	if (key < m_last)
+	{
+		throw Exception("Radix heap keys must not decrease");
+	}
+	m_buckets[GetBucket(key)].push_back(make_pair(key, vertex));
+	m_size++;
+}
+
+/**********************************************************************
+* Purpose: This function removes the smallest entry.
+*
+* Precondition:	N/A
+*
+* Postcondition: The smallest entry is removed; throws if the heap is
+*				 empty.
+************************************************************************/
+template<typename K>
+inline void RadixHeap<K>::Pop()
+{
+	Refill();
+	m_buckets[0].pop_back();
+	m_size--;
+}
+
+/**********************************************************************
+* Purpose: This function returns the smallest key.
+*
+* Precondition:	N/A
+*
+* Postcondition: The smallest key is returned; throws if the heap is
+*				 empty.
+************************************************************************/
+template<typename K>
+inline K RadixHeap<K>::GetTopKey()
+{
+	Refill();
+	return m_buckets[0].back().first;
+}
+
+/**********************************************************************
+* Purpose: This function returns the vertex with the smallest key.
+*
+* Precondition:	N/A
+*
+* Postcondition: The vertex is returned; throws if the heap is empty.
+************************************************************************/
+template<typename K>
+inline int RadixHeap<K>::GetTopVertex()
+{
+	Refill();
+	return m_buckets[0].back().second;
+}
+
+/**********************************************************************
+* Purpose: This function returns whether or not the heap is empty.
+*
+* Precondition:	N/A
+*
+* Postcondition: The empty status is returned.
+************************************************************************/
+template<typename K>
+inline bool RadixHeap<K>::IsEmpty() const
+{
+	return m_size == 0;
+}
+
+/**********************************************************************
+* Purpose: This function removes every entry and starts over from key 0.
+*
+* Precondition:	N/A
+*
+* Postcondition: The heap is empty.
+************************************************************************/
+template<typename K>
+inline void RadixHeap<K>::Clear()
+{
+	for (int i = 0; i < BUCKETS; i++)
+	{
+		m_buckets[i].clear();
+	}
+	m_last = 0;
+	m_size = 0;
+}
+
+/**********************************************************************
+* Purpose: This function returns the bucket a key belongs in, which is
+*		   the position of the highest bit where it differs from m_last.
+*
+* Precondition:	key >= m_last
+*
+* Postcondition: The bucket index is returned.
+************************************************************************/
+template<typename K>
+inline int RadixHeap<K>::GetBucket(K key) const
+{
+	unsigned long long diff = static_cast<unsigned long long>(key) ^ static_cast<unsigned long long>(m_last);
+	if (diff == 0)
+	{
+		return 0;
+	}
+#ifdef _MSC_VER
+	unsigned long high = 0;
+	if ((diff >> 32) != 0)	//_BitScanReverse64 is missing on Win32 builds
+	{
+		_BitScanReverse(&high, static_cast<unsigned long>(diff >> 32));
+		return static_cast<int>(high) + 33;
+	}
+	_BitScanReverse(&high, static_cast<unsigned long>(diff));
+	return static_cast<int>(high) + 1;
+#else
+	return 64 - __builtin_clzll(diff);
+#endif
+}
+
+/**********************************************************************
+* Purpose: This function makes sure bucket 0 holds the smallest entries.
+*		   When it is empty, the first non-empty bucket is emptied and its
+*		   entries are spread out again around its smallest key.
+*
+* Precondition:	N/A
+*
+* Postcondition: Bucket 0 is not empty; throws if the heap is.
+************************************************************************/
+template<typename K>
+inline void RadixHeap<K>::Refill()
+{
+	if (m_size == 0)
+	{
+		throw Exception("Heap is empty");
+	}
+	if (m_buckets[0].empty())
+	{
+		int i = 1;
+		while (m_buckets[i].empty())
+		{
+			i++;
+		}
+
+		K min = m_buckets[i][0].first;
+		for (size_t j = 1; j < m_buckets[i].size(); j++)
+		{
+			if (m_buckets[i][j].first < min)
+			{
+				min = m_buckets[i][j].first;
+			}
+		}
+		m_last = min;
+
+		for (size_t j = 0; j < m_buckets[i].size(); j++)	//Every entry lands in a lower bucket
+		{
+			m_buckets[GetBucket(m_buckets[i][j].first)].push_back(m_buckets[i][j]);
+		}
+		m_buckets[i].clear();
+	}
+}
@@ -0,0 +1,169 @@
+/*************************************************************
+* Filename:		RelaxKernel.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Edge relaxation over the contiguous target / weight arrays of a
+*	CompactGraph. RelaxEdges() handles every edge of one vertex:
+*	candidate = base + weight, and if it beats distance[target] the
+*	distance is lowered and target is written to improved.
+*
+*	There is a scalar version, and an AVX2 version that computes 8
+*	candidates at a time against gathered distances so hubs with many
+*	edges cost a fraction of the scalar loop. GetRelaxKernel()
+*	checks the CPU once and returns the best one it can run.
+**************************************************************/
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define RELAX_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#pragma once
+#ifndef RELAXKERNEL_H
+#define RELAXKERNEL_H
+
+typedef int(*RelaxKernel)(const int * targets, const int * weights, int begin, int end, int base, int * distance, int * improved);
+
+int RelaxEdgesScalar(const int * targets, const int * weights, int begin, int end, int base, int * distance, int * improved);	//One edge at a time
+
+#ifdef RELAX_X86
+int RelaxEdgesAvx2(const int * targets, const int * weights, int begin, int end, int base, int * distance, int * improved);	//8 edges at a time
+bool CpuHasAvx2();	//Whether or not the CPU and OS support AVX2
+#endif
+
+RelaxKernel GetRelaxKernel();	//Best kernel for this CPU
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function relaxes the edges [begin, end) one at a time.
+*
+* Precondition:	improved has room for end - begin entries.
+*
+* Postcondition: distance is lowered where base + weight is smaller, the
+*				 number of targets written to improved is returned.
+************************************************************************/
+inline int RelaxEdgesScalar(const int * targets, const int * weights, int begin, int end, int base, int * distance, int * improved)
+{
+	int count = 0;
+	for (int edge = begin; edge < end; ++edge)
+	{
+		int candidate = base + weights[edge];
+		if (candidate < distance[targets[edge]])
+		{
+			distance[targets[edge]] = candidate;
+			improved[count++] = targets[edge];
+		}
+	}
+	return count;
+}
+
+#ifdef RELAX_X86
+/**********************************************************************
+* Purpose: This function relaxes the edges [begin, end) eight at a time:
+*		   candidates are added in one instruction, the current distances
+*		   are gathered, and only lanes that improved are written back.
+*		   Lanes are rechecked when written, so two edges to the same
+*		   target in one group still keep the smaller distance.
+*
+* Precondition:	improved has room for end - begin entries, CpuHasAvx2().
+*
+* Postcondition: Same as RelaxEdgesScalar.
+************************************************************************/
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+inline int RelaxEdgesAvx2(const int * targets, const int * weights, int begin, int end, int base, int * distance, int * improved)
+{
+	int count = 0;
+	int edge = begin;
+	__m256i vbase = _mm256_set1_epi32(base);
+#ifdef _MSC_VER
+	__declspec(align(32)) int candidates[8];
+#else
+	int candidates[8] __attribute__((aligned(32)));
+#endif
+
+	for (; edge + 8 <= end; edge += 8)
+	{
+		__m256i vtarget = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(targets + edge));
+		__m256i vweight = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + edge));
+		__m256i vcandidate = _mm256_add_epi32(vbase, vweight);
+		__m256i vcurrent = _mm256_i32gather_epi32(distance, vtarget, 4);
+		int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vcurrent, vcandidate)));
+
+		if (mask != 0)
+		{
+			_mm256_store_si256(reinterpret_cast<__m256i *>(candidates), vcandidate);
+			while (mask != 0)
+			{
+#ifdef _MSC_VER
+				unsigned long lane = 0;
+				_BitScanForward(&lane, static_cast<unsigned long>(mask));
+#else
+				int lane = __builtin_ctz(static_cast<unsigned>(mask));
+#endif
+				mask &= mask - 1;	//Clear the lowest lane
+				int to = targets[edge + lane];
+				if (candidates[lane] < distance[to])
+				{
+					distance[to] = candidates[lane];
+					improved[count++] = to;
+				}
+			}
+		}
+	}
+
+	return count + RelaxEdgesScalar(targets, weights, edge, end, base, distance, improved + count);	//Leftover edges
+}
+
+/**********************************************************************
+* Purpose: This function returns whether or not the CPU has AVX2 and the
+*		   operating system saves the 256 bit registers.
+*
+* Precondition:	N/A
+*
+* Postcondition: The support status is returned.
+************************************************************************/
+inline bool CpuHasAvx2()
+{
+#ifdef _MSC_VER
+	int info[4] = { 0 };
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+/**********************************************************************
+* Purpose: This function returns the fastest relax kernel the CPU can run.
+*		   The check is done once and remembered.
+*
+* Precondition:	N/A
+*
+* Postcondition: A kernel is returned.
+************************************************************************/
+inline RelaxKernel GetRelaxKernel()
+{
+#ifdef RELAX_X86
+	static const RelaxKernel kernel = CpuHasAvx2() ? RelaxEdgesAvx2 : RelaxEdgesScalar;
+	return kernel;
+#else
+	return RelaxEdgesScalar;
+#endif
+}
+#endif
@@ -0,0 +1,317 @@
+/*************************************************************
+* Filename:		Reordering.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Vertex orders that put neighbors next to each other in memory.
+*	CompactGraph numbers vertices in the order PopulateGraph() first
+*	saw them in the file, which scatters neighbors; renumbering with
+*	one of these before searching means a search mostly touches
+*	nearby entries of the distance and edge arrays.
+*
+*	Each function returns order, where order[i] is the old index of
+*	the vertex that should become vertex i; pass it to
+*	CompactGraph::Reorder(). SaveOrder() / LoadOrder() keep an order
+*	next to the data file so it only has to be computed once.
+**************************************************************/
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "CompactGraph.h"
+using std::vector;
+using std::queue;
+using std::sort;
+using std::ofstream;
+using std::ifstream;
+using std::istringstream;
+using std::ios;
+using std::getline;
+using std::string;
+using std::pair;
+using std::make_pair;
+
+#pragma once
+#ifndef REORDERING_H
+#define REORDERING_H
+
+template <typename V, typename E>
+vector<int> BreadthFirstOrder(const CompactGraph<V, E> & graph);	//Order vertices are reached by BFS
+
+template <typename V, typename E>
+vector<int> CuthillMcKeeOrder(const CompactGraph<V, E> & graph);	//Reverse Cuthill-McKee order
+
+vector<int> HilbertOrder(const vector<double> & x, const vector<double> & y);	//Order along a Hilbert curve, for graphs with coordinates
+
+template <typename V, typename E>
+void SaveOrder(const CompactGraph<V, E> & graph, const string & filename);	//Writes the vertex data in index order
+
+template <typename V, typename E>
+vector<int> LoadOrder(const CompactGraph<V, E> & graph, const string & filename);	//Reads an order written by SaveOrder
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function numbers the vertices in the order a breadth
+*		   first search reaches them, starting a new search from the
+*		   lowest unvisited index for each disconnected piece.
+*
+* Precondition:	N/A
+*
+* Postcondition: A permutation of the vertices is returned.
+************************************************************************/
+template<typename V, typename E>
+vector<int> BreadthFirstOrder(const CompactGraph<V, E> & graph)
+{
+	const int SIZE = graph.GetVertexCount();
+	vector<int> order;
+	vector<bool> visited(SIZE, false);
+	queue<int> vqueue;
+
+	order.reserve(SIZE);
+	for (int root = 0; root < SIZE; root++)
+	{
+		if (!visited[root])
+		{
+			visited[root] = true;
+			vqueue.push(root);
+			while (!vqueue.empty())
+			{
+				int current = vqueue.front();
+				vqueue.pop();
+				order.push_back(current);
+
+				for (int edge = graph.GetEdgeBegin(current); edge != graph.GetEdgeEnd(current); ++edge)
+				{
+					if (!visited[graph.GetTarget(edge)])
+					{
+						visited[graph.GetTarget(edge)] = true;
+						vqueue.push(graph.GetTarget(edge));
+					}
+				}
+			}
+		}
+	}
+	return order;
+}
+
+/**********************************************************************
+* Purpose: This function numbers the vertices in reverse Cuthill-McKee
+*		   order: a breadth first search from a lowest degree vertex that
+*		   visits neighbors lowest degree first, then reversed. This keeps
+*		   the distance between an edge's two ends (the bandwidth) small.
+*
+* Precondition:	N/A
+*
+* Postcondition: A permutation of the vertices is returned.
+************************************************************************/
+template<typename V, typename E>
+vector<int> CuthillMcKeeOrder(const CompactGraph<V, E> & graph)
+{
+	const int SIZE = graph.GetVertexCount();
+	vector<int> order;
+	vector<bool> visited(SIZE, false);
+	vector<pair<int, int>> roots;		//(degree, vertex), to start each piece at a low degree vertex
+	vector<pair<int, int>> neighbors;
+
+	order.reserve(SIZE);
+	for (int i = 0; i < SIZE; i++)
+	{
+		roots.push_back(make_pair(graph.GetEdgeEnd(i) - graph.GetEdgeBegin(i), i));
+	}
+	sort(roots.begin(), roots.end());
+
+	for (size_t r = 0; r < roots.size(); r++)
+	{
+		int root = roots[r].second;
+		if (!visited[root])
+		{
+			size_t next = order.size();	//The order vector doubles as the queue
+			visited[root] = true;
+			order.push_back(root);
+
+			while (next < order.size())
+			{
+				int current = order[next++];
+				neighbors.clear();
+				for (int edge = graph.GetEdgeBegin(current); edge != graph.GetEdgeEnd(current); ++edge)
+				{
+					int to = graph.GetTarget(edge);
+					if (!visited[to])
+					{
+						visited[to] = true;
+						neighbors.push_back(make_pair(graph.GetEdgeEnd(to) - graph.GetEdgeBegin(to), to));
+					}
+				}
+				sort(neighbors.begin(), neighbors.end());
+				for (size_t i = 0; i < neighbors.size(); i++)
+				{
+					order.push_back(neighbors[i].second);
+				}
+			}
+		}
+	}
+	std::reverse(order.begin(), order.end());
+	return order;
+}
+
+/**********************************************************************
+* Purpose: This function numbers points by their position along a Hilbert
+*		   curve over the bounding box of the coordinates, so vertices
+*		   that are close on the map are close in memory.
+*
+* Precondition:	x and y hold one coordinate per vertex.
+*
+* Postcondition: A permutation of the vertices is returned.
+************************************************************************/
+inline vector<int> HilbertOrder(const vector<double> & x, const vector<double> & y)
+{
+	const unsigned SIDE = 1 << 16;	//Grid the coordinates are snapped to
+	vector<pair<unsigned long long, int>> keys;
+	vector<int> order;
+
+	if (x.size() != y.size())
+	{
+		throw Exception("Every vertex needs an x and a y");
+	}
+	if (x.empty())
+	{
+		return order;
+	}
+
+	double minx = *std::min_element(x.begin(), x.end());
+	double maxx = *std::max_element(x.begin(), x.end());
+	double miny = *std::min_element(y.begin(), y.end());
+	double maxy = *std::max_element(y.begin(), y.end());
+	double scalex = maxx > minx ? (SIDE - 1) / (maxx - minx) : 0;
+	double scaley = maxy > miny ? (SIDE - 1) / (maxy - miny) : 0;
+
+	for (size_t i = 0; i < x.size(); i++)
+	{
+		unsigned px = static_cast<unsigned>((x[i] - minx) * scalex);
+		unsigned py = static_cast<unsigned>((y[i] - miny) * scaley);
+		unsigned long long d = 0;
+
+		for (unsigned s = SIDE / 2; s > 0; s /= 2)	//Walk down the curve one quadrant at a time
+		{
+			unsigned rx = (px & s) > 0 ? 1 : 0;
+			unsigned ry = (py & s) > 0 ? 1 : 0;
+			d += static_cast<unsigned long long>(s) * s * ((3 * rx) ^ ry);
+			if (ry == 0)	//Rotate the quadrant
+			{
+				if (rx == 1)
+				{
+					px = SIDE - 1 - px;
+					py = SIDE - 1 - py;
+				}
+				unsigned swap = px;
+				px = py;
+				py = swap;
+			}
+		}
+		keys.push_back(make_pair(d, static_cast<int>(i)));
+	}
+	sort(keys.begin(), keys.end());
+
+	order.reserve(keys.size());
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		order.push_back(keys[i].second);
+	}
+	return order;
+}
+
+/**********************************************************************
+* Purpose: This function writes the data of every vertex, one per line,
+*		   in index order. Loading it back gives the same numbering.
+*
+* Precondition:	N/A
+*
+* Postcondition: The order is saved to filename.
+************************************************************************/
+template<typename V, typename E>
+void SaveOrder(const CompactGraph<V, E> & graph, const string & filename)
+{
+	ofstream out;
+	out.open(filename.c_str(), ios::out);
+
+	if (!out.is_open())
+	{
+		throw Exception("Error opening file!");
+	}
+	for (int i = 0; i < graph.GetVertexCount(); i++)
+	{
+		out << graph.GetData(i) << '\n';
+	}
+	out.close();
+}
+
+/**********************************************************************
+* Purpose: This function reads an order written by SaveOrder and returns
+*		   it as a permutation of graph's current indices.
+*
+* Precondition:	The file lists every vertex of graph once.
+*
+* Postcondition: The order is returned.
+************************************************************************/
+template<typename V, typename E>
+vector<int> LoadOrder(const CompactGraph<V, E> & graph, const string & filename)
+{
+	ifstream in;
+	string line;
+	vector<int> order;
+
+	in.open(filename.c_str(), ios::in);
+	if (!in.is_open())
+	{
+		throw Exception("Error opening file!");
+	}
+	while (getline(in, line))
+	{
+		if (!line.empty())
+		{
+			V data;
+			istringstream parse(line);
+			parse >> data;
+			order.push_back(graph.GetIndex(data));
+		}
+	}
+	in.close();
+	return order;
+}
+
+/**********************************************************************
+* Purpose: This function reads an order written by SaveOrder for a graph
+*		   keyed by names, which may contain spaces.
+*
+* Precondition:	The file lists every vertex of graph once.
+*
+* Postcondition: The order is returned.
+************************************************************************/
+template<typename E>
+vector<int> LoadOrder(const CompactGraph<string, E> & graph, const string & filename)
+{
+	ifstream in;
+	string line;
+	vector<int> order;
+
+	in.open(filename.c_str(), ios::in);
+	if (!in.is_open())
+	{
+		throw Exception("Error opening file!");
+	}
+	while (getline(in, line))
+	{
+		if (!line.empty())
+		{
+			order.push_back(graph.GetIndex(line));
+		}
+	}
+	in.close();
+	return order;
+}
+#endif
@@ -0,0 +1,70 @@
+/*************************************************************
+* Filename:		RoadClass.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Road classes for the integer keyed graph, Graph<uint32_t,
+*	RoadClass>, and RoadTraits<E>, which tells the algorithms
+*	the class of an edge's road (and whether it is an interstate)
+*	regardless of whether the edge data is the road's name or its
+*	class.
+**************************************************************/
+#include <string>
+using std::string;
+
+#pragma once
+#ifndef ROADCLASS_H
+#define ROADCLASS_H
+
+enum RoadClass
+{
+	ROAD_INTERSTATE,	//I-5
+	ROAD_HIGHWAY,		//Hwy 97, Hwy 140...
+	ROAD_OTHER,			//Named roads (Dead Indian Memorial Road...)
+	ROAD_CLASS_COUNT	//Number of classes, for tables indexed by class
+};
+
+RoadClass ClassifyRoad(const string & name);	//Class of a road from its name
+
+/************************************************************************
+* Class: RoadTraits
+*
+* Purpose: Answers questions about edge data. The general version assumes
+*		   the data is the road's name.
+*************************************************************************/
+template <typename E>
+struct RoadTraits
+{
+	static RoadClass GetClass(const E & road) { return ClassifyRoad(road); }
+	static bool IsInterstate(const E & road) { return ClassifyRoad(road) == ROAD_INTERSTATE; }
+};
+
+template <>
+struct RoadTraits<RoadClass>
+{
+	static RoadClass GetClass(RoadClass road) { return road; }
+	static bool IsInterstate(RoadClass road) { return road == ROAD_INTERSTATE; }
+};
+
+/**********************************************************************
+* Purpose: This function returns the class of a road from its name.
+*
+* Precondition:	N/A
+*
+* Postcondition: The road class is returned.
+************************************************************************/
+inline RoadClass ClassifyRoad(const string & name)
+{
+	RoadClass road = ROAD_OTHER;
+	if (name.compare(0, 2, "I-") == 0)
+	{
+		road = ROAD_INTERSTATE;
+	}
+	else if (name.compare(0, 4, "Hwy ") == 0)
+	{
+		road = ROAD_HIGHWAY;
+	}
+	return road;
+}
+#endif
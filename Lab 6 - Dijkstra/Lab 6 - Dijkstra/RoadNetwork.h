@@ -0,0 +1,764 @@
+/*************************************************************
+* Filename:		RoadNetwork.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Synthetic road networks for scale testing, and the files they
+*	are kept in. A RoadNetwork is a list of two way road segments
+*	between numbered places, each with a road name and its miles,
+*	the same thing one line of new.txt describes.
+*
+*	Three generators are provided, all reproducible from a seed:
+*	a grid of streets, a planar road-like network (a triangulation
+*	of scattered towns, pruned down to road density) and a power
+*	law network where a few hubs have most of the roads. Roads
+*	are named "I-..", "Hwy .." or local names in a realistic mix so
+*	the 65 / 55 mph speed model applies.
+*
+*	Networks are written either as from,to,road,miles text, which
+*	ReadLine() style readers take, or as a compact binary file
+*	that loads without any parsing. ReadRoadFile() takes either.
+**************************************************************/
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include "CompactGraph.h"
+#include "RoadClass.h"
+#include "Exception.h"
+using std::vector;
+using std::string;
+using std::to_string;
+using std::ifstream;
+using std::ofstream;
+using std::ios;
+using std::getline;
+using std::unordered_map;
+
+#pragma once
+#ifndef ROADNETWORK_H
+#define ROADNETWORK_H
+
+struct RoadNetwork
+{
+	vector<string> places;	//Name of each place, empty when they are just numbered
+	vector<string> roads;	//Name of each road
+	vector<int> from;		//One entry per segment
+	vector<int> to;
+	vector<int> road;		//Index into roads
+	vector<int> miles;
+	int count;				//Number of places
+
+	RoadNetwork() : count(0) {}
+};
+
+RoadNetwork GenerateGridNetwork(int vertices, unsigned seed);		//City blocks with highways every few streets
+RoadNetwork GeneratePlanarNetwork(int vertices, unsigned seed);		//Pruned triangulation of scattered towns
+RoadNetwork GeneratePowerLawNetwork(int vertices, int links, unsigned seed);	//Preferential attachment, hubs get the interstates
+
+string GetPlaceName(const RoadNetwork & network, int place);	//Name of a place, numbered or not
+void WriteRoadText(const RoadNetwork & network, const string & filename);	//from,to,road,miles lines
+void WriteRoadBinary(const RoadNetwork & network, const string & filename);	//Binary file
+RoadNetwork ReadRoadFile(const string & filename);	//Reads either format
+
+void BuildRoadGraph(const RoadNetwork & network, CompactGraph<string, string> & graph);	//Names and road names
+void BuildRoadGraph(const RoadNetwork & network, CompactGraph<uint32_t, RoadClass> & graph);	//Place ids and road classes
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+const char ROAD_BINARY_MAGIC[4] = { 'R', 'N', 'E', 'T' };	//First bytes of a binary road file
+const int ROAD_BINARY_VERSION = 1;
+
+/**********************************************************************
+* Purpose: This function returns the next number from a linear
+*		   congruential generator. The standard distributions differ
+*		   between libraries, this does not, so a seed gives the same
+*		   network everywhere.
+*
+* Precondition:	N/A
+*
+* Postcondition: state is advanced and a number in [0, limit) is returned.
+************************************************************************/
+inline unsigned NextRandom(unsigned long long & state, unsigned limit)
+{
+	state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return static_cast<unsigned>((state >> 33) % limit);
+}
+
+/**********************************************************************
+* Purpose: This function returns a random number in [0, 1).
+*
+* Precondition:	N/A
+*
+* Postcondition: state is advanced.
+************************************************************************/
+inline double NextUnit(unsigned long long & state)
+{
+	return NextRandom(state, 1U << 30) / static_cast<double>(1U << 30);
+}
+
+/**********************************************************************
+* Purpose: This function adds a segment to the network. Zero miles is
+*		   kept, every engine handles zero weight edges.
+*
+* Precondition:	road is an index into network.roads.
+*
+* Postcondition: The segment is added; throws if miles is negative.
+************************************************************************/
+inline void AddSegment(RoadNetwork & network, int from, int to, int road, int miles)
+{
+	if (miles < 0)
+	{
+		throw Exception("Miles can't be negative");
+	}
+	network.from.push_back(from);
+	network.to.push_back(to);
+	network.road.push_back(road);
+	network.miles.push_back(miles);
+}
+
+/**********************************************************************
+* Purpose: This function reads the miles field of a road file line, so a
+*		   bad one is an Exception naming the line rather than whatever
+*		   the standard library throws.
+*
+* Precondition:	N/A
+*
+* Postcondition: The miles are returned; throws unless field is a whole
+*				 number from 0 to INT_MAX.
+************************************************************************/
+inline int ParseMiles(const string & field, long long line)
+{
+	const char * text = field.c_str();
+	char * end = nullptr;
+	errno = 0;
+	long miles = strtol(text, &end, 10);
+
+	if (end == text || *end != '\0' || errno == ERANGE || miles > INT_MAX)
+	{
+		throw Exception(("Line " + to_string(line) + ": bad miles").c_str());
+	}
+	if (miles < 0)
+	{
+		throw Exception(("Line " + to_string(line) + ": miles can't be negative").c_str());
+	}
+	return static_cast<int>(miles);
+}
+
+/**********************************************************************
+* Purpose: This function names the roads of the generated networks: a few
+*		   interstates, more highways, then local roads.
+*
+* Precondition:	N/A
+*
+* Postcondition: network.roads holds interstates "I-..", then highways
+*				 "Hwy ..", then locals "County Road ..".
+************************************************************************/
+inline void NameRoads(RoadNetwork & network, int interstates, int highways, int locals)
+{
+	const int NUMBERS[] = { 5, 84, 90, 80, 70, 40, 10, 15, 25, 35, 55, 65, 75, 95 };	//Real interstate numbers first
+	network.roads.clear();
+	for (int i = 0; i < interstates; i++)
+	{
+		network.roads.push_back("I-" + to_string(i < 14 ? NUMBERS[i] : 100 + i));
+	}
+	for (int i = 0; i < highways; i++)
+	{
+		network.roads.push_back("Hwy " + to_string(i + 1));
+	}
+	for (int i = 0; i < locals; i++)
+	{
+		network.roads.push_back("County Road " + to_string(i + 1));
+	}
+}
+
+/**********************************************************************
+* Purpose: This function builds a grid of streets, as square as it can be
+*		   with the vertices given. Every 32nd street is an interstate,
+*		   every 8th a highway, the rest local roads, and each block is
+*		   1 to 3 miles long.
+*
+* Precondition:	vertices >= 1
+*
+* Postcondition: The network is returned.
+************************************************************************/
+inline RoadNetwork GenerateGridNetwork(int vertices, unsigned seed)
+{
+	RoadNetwork network;
+	unsigned long long state = seed;
+	int width = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(vertices))));
+	int height = (vertices + width - 1) / width;
+	int lines = width > height ? width : height;
+
+	int interstates = (lines + 31) / 32 * 2;	//One road per row and per column of each kind
+	int highways = (lines + 7) / 8 * 2;
+	NameRoads(network, interstates, highways, 2 * lines);
+	network.count = vertices;
+
+	for (int v = 0; v < vertices; v++)
+	{
+		int column = v % width;
+		int row = v / width;
+		if (column + 1 < width && v + 1 < vertices)	//East along the row
+		{
+			int road = row % 32 == 0 ? row / 32 * 2 : row % 8 == 0 ? interstates + row / 8 * 2 : interstates + highways + row * 2;
+			AddSegment(network, v, v + 1, road, 1 + NextRandom(state, 3));
+		}
+		if (v + width < vertices)	//South along the column
+		{
+			int road = column % 32 == 0 ? column / 32 * 2 + 1 : column % 8 == 0 ? interstates + column / 8 * 2 + 1 : interstates + highways + column * 2 + 1;
+			AddSegment(network, v, v + width, road, 1 + NextRandom(state, 3));
+		}
+	}
+	return network;
+}
+
+/**********************************************************************
+* Purpose: This function builds a road-like planar network. Towns are
+*		   scattered one per cell of a square lattice and triangulated,
+*		   each cell split along the diagonal the Delaunay circle test
+*		   picks. The triangulation is then pruned to road density:
+*		   a random spanning tree and every interstate and highway
+*		   segment stay, a quarter of the other segments survive.
+*		   Miles are the straight line distance between towns.
+*
+* Precondition:	vertices >= 1
+*
+* Postcondition: The network is returned.
+************************************************************************/
+inline RoadNetwork GeneratePlanarNetwork(int vertices, unsigned seed)
+{
+	const double SPACING = 6.0;	//Miles between lattice points
+	RoadNetwork network;
+	unsigned long long state = seed;
+	int width = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(vertices))));
+	int lines = width;
+	vector<double> x(vertices);
+	vector<double> y(vertices);
+	vector<int> from, to, road;
+
+	int interstates = (lines + 31) / 32 * 2;
+	int highways = (lines + 7) / 8 * 2;
+	NameRoads(network, interstates, highways, 1);
+	int local = interstates + highways;
+	network.count = vertices;
+
+	for (int v = 0; v < vertices; v++)	//Jitter each town inside its cell
+	{
+		x[v] = (v % width + 0.7 * NextUnit(state) - 0.35) * SPACING;
+		y[v] = (v / width + 0.7 * NextUnit(state) - 0.35) * SPACING;
+	}
+
+	for (int v = 0; v < vertices; v++)
+	{
+		int column = v % width;
+		int row = v / width;
+		if (column + 1 < width && v + 1 < vertices)
+		{
+			from.push_back(v);
+			to.push_back(v + 1);
+			road.push_back(row % 32 == 0 ? row / 32 * 2 : row % 8 == 0 ? interstates + row / 8 * 2 : local);
+		}
+		if (v + width < vertices)
+		{
+			from.push_back(v);
+			to.push_back(v + width);
+			road.push_back(column % 32 == 0 ? column / 32 * 2 + 1 : column % 8 == 0 ? interstates + column / 8 * 2 + 1 : local);
+		}
+		if (column + 1 < width && v + width + 1 < vertices)	//Split the cell a, b / c, d along one diagonal
+		{
+			int a = v, b = v + 1, c = v + width, d = v + width + 1;
+			double ax = x[a] - x[d], ay = y[a] - y[d];	//In-circle test of d against a, b, c
+			double bx = x[b] - x[d], by = y[b] - y[d];
+			double cx = x[c] - x[d], cy = y[c] - y[d];
+			double det = (ax * ax + ay * ay) * (bx * cy - cx * by) - (bx * bx + by * by) * (ax * cy - cx * ay)
+				+ (cx * cx + cy * cy) * (ax * by - bx * ay);
+			bool flip = det > 0;	//d is inside the circle through a, b, c, so b-c is not Delaunay
+			from.push_back(flip ? a : b);
+			to.push_back(flip ? d : c);
+			road.push_back(local);
+		}
+	}
+
+	//Random spanning tree: union the segments in a shuffled order
+	const int SEGMENTS = static_cast<int>(from.size());
+	vector<int> shuffled(SEGMENTS);
+	vector<int> parent(vertices);
+	vector<bool> keep(SEGMENTS, false);
+	for (int i = 0; i < SEGMENTS; i++)
+	{
+		shuffled[i] = i;
+	}
+	for (int i = SEGMENTS - 1; i > 0; i--)
+	{
+		int j = static_cast<int>(NextRandom(state, static_cast<unsigned>(i + 1)));
+		int swap = shuffled[i];
+		shuffled[i] = shuffled[j];
+		shuffled[j] = swap;
+	}
+	for (int v = 0; v < vertices; v++)
+	{
+		parent[v] = v;
+	}
+	for (int i = 0; i < SEGMENTS; i++)
+	{
+		int s = shuffled[i];
+		int ra = from[s], rb = to[s];
+		while (parent[ra] != ra)
+		{
+			parent[ra] = parent[parent[ra]];	//Path halving
+			ra = parent[ra];
+		}
+		while (parent[rb] != rb)
+		{
+			parent[rb] = parent[parent[rb]];
+			rb = parent[rb];
+		}
+		if (ra != rb)
+		{
+			parent[ra] = rb;
+			keep[s] = true;
+		}
+	}
+
+	for (int s = 0; s < SEGMENTS; s++)
+	{
+		bool survives = NextRandom(state, 4) == 0;	//Drawn for every segment so the stream does not depend on keep
+		if (keep[s] || road[s] != local || survives)
+		{
+			double dx = x[from[s]] - x[to[s]];
+			double dy = y[from[s]] - y[to[s]];
+			AddSegment(network, from[s], to[s], road[s], std::max(1, static_cast<int>(std::sqrt(dx * dx + dy * dy) + 0.5)));
+		}
+	}
+	return network;
+}
+
+/**********************************************************************
+* Purpose: This function builds a power law network by preferential
+*		   attachment: each new place links to links earlier places,
+*		   picked in proportion to how many roads they already have.
+*		   Segments between the oldest 1% of places (the hubs) are
+*		   interstates, between the oldest 10% highways.
+*
+* Precondition:	vertices >= 1, links >= 1
+*
+* Postcondition: The network is returned.
+************************************************************************/
+inline RoadNetwork GeneratePowerLawNetwork(int vertices, int links, unsigned seed)
+{
+	RoadNetwork network;
+	unsigned long long state = seed;
+	vector<int> ends;	//Both ends of every segment, so picking one is picking by degree
+	int hubs = vertices / 100 > 1 ? vertices / 100 : 1;
+	int towns = vertices / 10 > 1 ? vertices / 10 : 1;
+
+	NameRoads(network, 4, 16, 1);
+	network.count = vertices;
+	ends.reserve(static_cast<size_t>(vertices) * links * 2);
+
+	for (int v = 1; v < vertices; v++)
+	{
+		int picked[16];
+		int count = 0;
+		int tries = links < 16 ? links : 16;
+		for (int l = 0; l < tries; l++)
+		{
+			int target = ends.empty() ? 0 : ends[NextRandom(state, static_cast<unsigned>(ends.size()))];
+			bool duplicate = false;
+			for (int p = 0; p < count; p++)
+			{
+				duplicate = duplicate || picked[p] == target;
+			}
+			if (!duplicate)
+			{
+				picked[count++] = target;
+			}
+		}
+		for (int p = 0; p < count; p++)
+		{
+			int target = picked[p];
+			int newer = v > target ? v : target;	//Both ends must be hubs for an interstate
+			int road = newer < hubs ? static_cast<int>(NextRandom(state, 4))
+				: newer < towns ? 4 + static_cast<int>(NextRandom(state, 16)) : 20;
+			AddSegment(network, target, v, road, 1 + static_cast<int>(NextRandom(state, 60)));
+			ends.push_back(target);
+			ends.push_back(v);
+		}
+	}
+	return network;
+}
+
+/**********************************************************************
+* Purpose: This function returns the name of a place.
+*
+* Precondition:	0 <= place < network.count
+*
+* Postcondition: The stored name is returned, or "Junction <place>" for
+*				 generated networks.
+************************************************************************/
+inline string GetPlaceName(const RoadNetwork & network, int place)
+{
+	return network.places.empty() ? "Junction " + to_string(place) : network.places[place];
+}
+
+/**********************************************************************
+* Purpose: This function writes the network as from,to,road,miles lines,
+*		   the format of new.txt.
+*
+* Precondition:	N/A
+*
+* Postcondition: The network is saved to filename.
+************************************************************************/
+inline void WriteRoadText(const RoadNetwork & network, const string & filename)
+{
+	ofstream out;
+	string line;
+	out.open(filename.c_str(), ios::out | ios::binary);
+
+	if (!out.is_open())
+	{
+		throw Exception("Error opening file!");
+	}
+	for (size_t i = 0; i < network.from.size(); i++)
+	{
+		line = GetPlaceName(network, network.from[i]);
+		line += ',';
+		line += GetPlaceName(network, network.to[i]);
+		line += ',';
+		line += network.roads[network.road[i]];
+		line += ',';
+		line += to_string(network.miles[i]);
+		line += '\n';
+		out.write(line.data(), line.size());
+	}
+	out.close();
+}
+
+/**********************************************************************
+* Purpose: This function writes a 32 bit number, low byte first, so files
+*		   are the same on every machine.
+*
+* Precondition:	out is open.
+*
+* Postcondition: Four bytes are written.
+************************************************************************/
+inline void WriteRoadInt(ofstream & out, int value)
+{
+	uint32_t bits = static_cast<uint32_t>(value);
+	char bytes[4] = { static_cast<char>(bits & 0xFF), static_cast<char>((bits >> 8) & 0xFF),
+		static_cast<char>((bits >> 16) & 0xFF), static_cast<char>((bits >> 24) & 0xFF) };
+	out.write(bytes, 4);
+}
+
+/**********************************************************************
+* Purpose: This function reads a number written by WriteRoadInt.
+*
+* Precondition:	in is open.
+*
+* Postcondition: The number is returned; throws if the file is short.
+************************************************************************/
+inline int ReadRoadInt(ifstream & in)
+{
+	unsigned char bytes[4];
+	if (!in.read(reinterpret_cast<char *>(bytes), 4))
+	{
+		throw Exception("Road file is cut short");
+	}
+	return static_cast<int>(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24));
+}
+
+/**********************************************************************
+* Purpose: This function writes a name as its length then its bytes.
+*
+* Precondition:	out is open.
+*
+* Postcondition: The name is written.
+************************************************************************/
+inline void WriteRoadName(ofstream & out, const string & name)
+{
+	WriteRoadInt(out, static_cast<int>(name.size()));
+	out.write(name.data(), name.size());
+}
+
+/**********************************************************************
+* Purpose: This function reads a name written by WriteRoadName.
+*
+* Precondition:	in is open.
+*
+* Postcondition: The name is returned; throws if the file is short.
+************************************************************************/
+inline string ReadRoadName(ifstream & in)
+{
+	int length = ReadRoadInt(in);
+	string name(length > 0 ? length : 0, '\0');
+	if (length < 0 || (length > 0 && !in.read(&name[0], length)))
+	{
+		throw Exception("Road file is cut short");
+	}
+	return name;
+}
+
+/**********************************************************************
+* Purpose: This function writes the network as a binary file: the magic
+*		   "RNET", version, place count, the road names, the place names
+*		   (none for numbered places), then the from, to, road and miles
+*		   columns. Every number is 32 bits, low byte first.
+*
+* Precondition:	N/A
+*
+* Postcondition: The network is saved to filename.
+************************************************************************/
+inline void WriteRoadBinary(const RoadNetwork & network, const string & filename)
+{
+	ofstream out;
+	out.open(filename.c_str(), ios::out | ios::binary);
+
+	if (!out.is_open())
+	{
+		throw Exception("Error opening file!");
+	}
+	out.write(ROAD_BINARY_MAGIC, 4);
+	WriteRoadInt(out, ROAD_BINARY_VERSION);
+	WriteRoadInt(out, network.count);
+	WriteRoadInt(out, static_cast<int>(network.roads.size()));
+	for (size_t i = 0; i < network.roads.size(); i++)
+	{
+		WriteRoadName(out, network.roads[i]);
+	}
+	WriteRoadInt(out, static_cast<int>(network.places.size()));
+	for (size_t i = 0; i < network.places.size(); i++)
+	{
+		WriteRoadName(out, network.places[i]);
+	}
+
+	const vector<int> * columns[] = { &network.from, &network.to, &network.road, &network.miles };
+	vector<char> buffer;
+	WriteRoadInt(out, static_cast<int>(network.from.size()));
+	for (int c = 0; c < 4; c++)	//A column at a time, through one buffer
+	{
+		buffer.resize(columns[c]->size() * 4);
+		for (size_t i = 0; i < columns[c]->size(); i++)
+		{
+			uint32_t bits = static_cast<uint32_t>((*columns[c])[i]);
+			buffer[i * 4] = static_cast<char>(bits & 0xFF);
+			buffer[i * 4 + 1] = static_cast<char>((bits >> 8) & 0xFF);
+			buffer[i * 4 + 2] = static_cast<char>((bits >> 16) & 0xFF);
+			buffer[i * 4 + 3] = static_cast<char>((bits >> 24) & 0xFF);
+		}
+		out.write(buffer.data(), buffer.size());
+	}
+	out.close();
+}
+
+/**********************************************************************
+* Purpose: This function reads a binary road file.
+*
+* Precondition:	in is open, just past the magic.
+*
+* Postcondition: The network is returned; throws on a bad file.
+************************************************************************/
+inline RoadNetwork ReadRoadBinary(ifstream & in)
+{
+	RoadNetwork network;
+
+	if (ReadRoadInt(in) != ROAD_BINARY_VERSION)
+	{
+		throw Exception("Unknown road file version");
+	}
+	network.count = ReadRoadInt(in);
+	int roads = ReadRoadInt(in);
+	for (int i = 0; i < roads; i++)
+	{
+		network.roads.push_back(ReadRoadName(in));
+	}
+	int places = ReadRoadInt(in);
+	for (int i = 0; i < places; i++)
+	{
+		network.places.push_back(ReadRoadName(in));
+	}
+
+	int segments = ReadRoadInt(in);
+	if (segments < 0 || network.count < 0 || (places != 0 && places != network.count))
+	{
+		throw Exception("Road file is corrupt");
+	}
+	vector<int> * columns[] = { &network.from, &network.to, &network.road, &network.miles };
+	vector<unsigned char> buffer(static_cast<size_t>(segments) * 4);
+	for (int c = 0; c < 4; c++)
+	{
+		if (segments > 0 && !in.read(reinterpret_cast<char *>(buffer.data()), buffer.size()))
+		{
+			throw Exception("Road file is cut short");
+		}
+		columns[c]->resize(segments);
+		for (int i = 0; i < segments; i++)
+		{
+			(*columns[c])[i] = static_cast<int>(buffer[i * 4] | (buffer[i * 4 + 1] << 8) | (buffer[i * 4 + 2] << 16)
+				| (static_cast<uint32_t>(buffer[i * 4 + 3]) << 24));
+		}
+	}
+	for (int i = 0; i < segments; i++)
+	{
+		if (network.from[i] < 0 || network.from[i] >= network.count || network.to[i] < 0 || network.to[i] >= network.count
+			|| network.road[i] < 0 || network.road[i] >= roads || network.miles[i] < 0)
+		{
+			throw Exception("Road file is corrupt");
+		}
+	}
+	return network;
+}
+
+/**********************************************************************
+* Purpose: This function reads from,to,road,miles lines, any number of
+*		   them. Places and roads are numbered in the order first seen.
+*
+* Precondition:	in is open at the start of the file.
+*
+* Postcondition: The network is returned; throws on a malformed line or
+*				 miles that aren't a whole number 0 or more.
+************************************************************************/
+inline RoadNetwork ReadRoadText(ifstream & in)
+{
+	RoadNetwork network;
+	unordered_map<string, int> places;
+	unordered_map<string, int> roads;
+	string line;
+	string fields[4];
+	long long number = 0;	//Line number, for errors
+
+	while (getline(in, line))
+	{
+		number++;
+		if (!line.empty() && line[line.size() - 1] == '\r')
+		{
+			line.erase(line.size() - 1);
+		}
+		if (line.empty())
+		{
+			continue;
+		}
+
+		size_t start = 0;
+		for (int f = 0; f < 3; f++)	//Seperate line by commas
+		{
+			size_t pos = line.find(',', start);
+			if (pos == string::npos)
+			{
+				throw Exception("Road line needs from,to,road,miles");
+			}
+			fields[f] = line.substr(start, pos - start);
+			start = pos + 1;
+		}
+		fields[3] = line.substr(start);
+
+		int ids[2];
+		for (int f = 0; f < 2; f++)
+		{
+			unordered_map<string, int>::iterator found = places.find(fields[f]);
+			if (found == places.end())
+			{
+				found = places.insert(std::make_pair(fields[f], network.count++)).first;
+				network.places.push_back(fields[f]);
+			}
+			ids[f] = found->second;
+		}
+		unordered_map<string, int>::iterator road = roads.find(fields[2]);
+		if (road == roads.end())
+		{
+			road = roads.insert(std::make_pair(fields[2], static_cast<int>(network.roads.size()))).first;
+			network.roads.push_back(fields[2]);
+		}
+		AddSegment(network, ids[0], ids[1], road->second, ParseMiles(fields[3], number));
+	}
+	return network;
+}
+
+/**********************************************************************
+* Purpose: This function reads a road file in either format, telling
+*		   them apart by the binary magic.
+*
+* Precondition:	N/A
+*
+* Postcondition: The network is returned.
+************************************************************************/
+inline RoadNetwork ReadRoadFile(const string & filename)
+{
+	ifstream in;
+	char magic[4] = { 0 };
+	in.open(filename.c_str(), ios::in | ios::binary);
+
+	if (!in.is_open())
+	{
+		throw Exception("Error opening file!");
+	}
+	if (in.read(magic, 4) && std::equal(magic, magic + 4, ROAD_BINARY_MAGIC))
+	{
+		return ReadRoadBinary(in);
+	}
+	in.clear();
+	in.seekg(0);
+	return ReadRoadText(in);
+}
+
+/**********************************************************************
+* Purpose: This function builds a compact graph keyed by place names
+*		   with road names on the edges, as PopulateGraph() would, but
+*		   without the O(n) per edge cost of Graph.
+*
+* Precondition:	N/A
+*
+* Postcondition: graph holds the network.
+************************************************************************/
+inline void BuildRoadGraph(const RoadNetwork & network, CompactGraph<string, string> & graph)
+{
+	vector<string> names(network.count);
+	vector<string> roads(network.from.size());
+
+	for (int i = 0; i < network.count; i++)
+	{
+		names[i] = GetPlaceName(network, i);
+	}
+	for (size_t i = 0; i < network.road.size(); i++)
+	{
+		roads[i] = network.roads[network.road[i]];
+	}
+	graph.Build(names, network.from, network.to, roads, network.miles);
+}
+
+/**********************************************************************
+* Purpose: This function builds a compact graph keyed by place number
+*		   with the road class on the edges.
+*
+* Precondition:	N/A
+*
+* Postcondition: graph holds the network.
+************************************************************************/
+inline void BuildRoadGraph(const RoadNetwork & network, CompactGraph<uint32_t, RoadClass> & graph)
+{
+	vector<uint32_t> ids(network.count);
+	vector<RoadClass> classes(network.roads.size());
+	vector<RoadClass> roads(network.from.size());
+
+	for (int i = 0; i < network.count; i++)
+	{
+		ids[i] = static_cast<uint32_t>(i);
+	}
+	for (size_t i = 0; i < network.roads.size(); i++)
+	{
+		classes[i] = ClassifyRoad(network.roads[i]);
+	}
+	for (size_t i = 0; i < network.road.size(); i++)
+	{
+		roads[i] = classes[network.road[i]];
+	}
+	graph.Build(ids, network.from, network.to, roads, network.miles);
+}
+#endif
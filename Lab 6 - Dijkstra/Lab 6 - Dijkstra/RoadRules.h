@@ -0,0 +1,237 @@
+/************************************************************************
+* Class: RoadRules
+*
+* Purpose: This class holds the roads one query may not use: roads by
+*		   name ("avoid Hwy 101") and whole road classes ("no local
+*		   roads", or "interstates only"). Compile() turns the rules into
+*		   a Bitmap with one bit per edge id, set for every edge the
+*		   rules block, which a MaskedGraph then skips. The rules and the
+*		   mask belong to the query; the graph is never changed or
+*		   copied, so any number of queries with different rules can
+*		   share it.
+*
+* Manager functions
+*	RoadRules()
+*		Creates rules that allow every road.
+*	~RoadRules()
+*		Clears the rules.
+*	RoadRules(const RoadRules<E> & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const RoadRules<E> & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	AvoidRoad(const E & road)
+*		Blocks every edge of one road.
+*	AvoidClass(RoadClass road)
+*		Blocks every road of a class.
+*	OnlyClass(RoadClass road)
+*		Blocks every road not of a class.
+*	Clear()
+*		Allows every road again.
+*	IsBlocked(const E & road)
+*		Returns whether the rules block a road.
+*	Compile(const CompactGraph<V, E> & graph, Bitmap & mask)
+*		Sets the bit of every edge of graph the rules block.
+*************************************************************************/
+#include <vector>
+#include <algorithm>
+#include "CompactGraph.h"
+#include "RoadClass.h"
+#include "Bitmap.h"
+using std::vector;
+
+#pragma once
+#ifndef ROADRULES_H
+#define ROADRULES_H
+
+template <typename E>
+class RoadRules
+{
+public:
+	RoadRules();
+	~RoadRules();
+	RoadRules(const RoadRules<E> & copy);
+	const RoadRules<E> & operator=(const RoadRules<E> & rhs);
+
+	void AvoidRoad(const E & road);
+	void AvoidClass(RoadClass road);
+	void OnlyClass(RoadClass road);
+	void Clear();
+	bool IsBlocked(const E & road) const;
+	template <typename V>
+	int Compile(const CompactGraph<V, E> & graph, Bitmap & mask) const;
+
+private:
+	vector<E> m_roads;						//Roads blocked by name
+	bool m_classes[ROAD_CLASS_COUNT];		//Road classes blocked
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates rules that allow every road.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: No road is blocked.
+************************************************************************/
+template<typename E>
+inline RoadRules<E>::RoadRules()
+{
+	Clear();
+}
+
+/**********************************************************************
+* Purpose: This function clears the rules.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are empty.
+************************************************************************/
+template<typename E>
+inline RoadRules<E>::~RoadRules()
+{
+	m_roads.clear();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+template<typename E>
+inline RoadRules<E>::RoadRules(const RoadRules<E> & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+template<typename E>
+inline const RoadRules<E> & RoadRules<E>::operator=(const RoadRules<E> & rhs)
+{
+	if (this != &rhs)
+	{
+		m_roads = rhs.m_roads;
+		std::copy(rhs.m_classes, rhs.m_classes + ROAD_CLASS_COUNT, m_classes);
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function blocks every edge of one road.
+*
+* Precondition:	N/A
+*
+* Postcondition: road is blocked.
+************************************************************************/
+template<typename E>
+inline void RoadRules<E>::AvoidRoad(const E & road)
+{
+	if (std::find(m_roads.begin(), m_roads.end(), road) == m_roads.end())
+	{
+		m_roads.push_back(road);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function blocks every road of a class.
+*
+* Precondition:	road is below ROAD_CLASS_COUNT.
+*
+* Postcondition: The class is blocked.
+************************************************************************/
+template<typename E>
+inline void RoadRules<E>::AvoidClass(RoadClass road)
+{
+	m_classes[road] = true;
+}
+
+/**********************************************************************
+* Purpose: This function blocks every road that is not of a class, for
+*		   queries like "interstates only".
+*
+* Precondition:	road is below ROAD_CLASS_COUNT.
+*
+* Postcondition: Every other class is blocked.
+************************************************************************/
+template<typename E>
+inline void RoadRules<E>::OnlyClass(RoadClass road)
+{
+	for (int i = 0; i < ROAD_CLASS_COUNT; i++)
+	{
+		if (i != road)
+		{
+			m_classes[i] = true;
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function allows every road again.
+*
+* Precondition:	N/A
+*
+* Postcondition: No road is blocked.
+************************************************************************/
+template<typename E>
+inline void RoadRules<E>::Clear()
+{
+	m_roads.clear();
+	std::fill(m_classes, m_classes + ROAD_CLASS_COUNT, false);
+}
+
+/**********************************************************************
+* Purpose: This function returns whether the rules block a road.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if road is blocked by name or class.
+************************************************************************/
+template<typename E>
+inline bool RoadRules<E>::IsBlocked(const E & road) const
+{
+	return m_classes[RoadTraits<E>::GetClass(road)] || std::find(m_roads.begin(), m_roads.end(), road) != m_roads.end();
+}
+
+/**********************************************************************
+* Purpose: This function compiles the rules for graph: mask gets one bit
+*		   per edge id, set if the edge's road is blocked. Both edges of
+*		   a road are blocked, since they carry the same data. Runs of
+*		   edges with the same road, which Build() and ReadRoadFile()
+*		   tend to give, are decided once.
+*
+* Precondition:	N/A
+*
+* Postcondition: mask is sized for graph and the number of edges blocked
+*				 is returned.
+************************************************************************/
+template<typename E>
+template<typename V>
+int RoadRules<E>::Compile(const CompactGraph<V, E> & graph, Bitmap & mask) const
+{
+	int blocked = 0;
+	bool last = false;	//Whether the previous edge's road is blocked
+
+	mask.Resize(graph.GetEdgeCount());
+	for (int edge = 0; edge < graph.GetEdgeCount(); edge++)
+	{
+		if (edge == 0 || !(graph.GetEdgeData(edge) == graph.GetEdgeData(edge - 1)))
+		{
+			last = IsBlocked(graph.GetEdgeData(edge));
+		}
+		if (last)
+		{
+			mask.Set(edge);
+			blocked++;
+		}
+	}
+	return blocked;
+}
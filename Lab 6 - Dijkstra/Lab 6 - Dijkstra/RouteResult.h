@@ -0,0 +1,414 @@
+/*************************************************************
+* Filename:		RouteResult.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	The answer to a route query, kept apart from how it is shown.
+*	A RouteResult holds the distance, the estimated minutes and the
+*	path (as graph indices and as vertex data). FindRoute() fills
+*	one from a CompactGraph; DistanceAndPath() in methods.h fills
+*	one from a Graph. Minutes come from a TravelTimeModel. A route
+*	on an integer id graph gets its place names back from the
+*	NameTable through NameRoute(), as the last step before it is
+*	written.
+*
+*	Results are written by one of the serializers below, each one
+*	record per call, ending in '\n' rather than endl so nothing is
+*	flushed until the stream's buffer fills:
+*		WriteRouteText	- the human readable report
+*		WriteRouteJson	- one JSON object per line (JSON lines)
+*		WriteRouteCsv	- one CSV row, after WriteRouteCsvHeader
+*		WriteRouteBinary - a little endian record of 32 bit numbers:
+*			distance (-1 if unreachable), seconds, stop count,
+*			then the index of each stop
+**************************************************************/
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include "CompactGraph.h"
+#include "ShortestPaths.h"
+#include "TravelTimeModel.h"
+#include "SearchStats.h"
+#include "NameTable.h"
+using std::vector;
+using std::string;
+using std::ostream;
+
+#pragma once
+#ifndef ROUTERESULT_H
+#define ROUTERESULT_H
+
+template <typename V>
+struct RouteResult
+{
+	V start;
+	V end;
+	int distance;			//Miles, INFINITE_DISTANCE if end can't be reached
+	double minutes;			//Estimated driving time
+	vector<int> path;		//Graph index of each stop, start to end
+	vector<V> stops;		//Data of each stop, start to end
+
+	RouteResult() : start(), end(), distance(INFINITE_DISTANCE), minutes(0) {}
+	bool IsReachable() const { return distance != INFINITE_DISTANCE; }
+};
+
+template <typename V, typename E>
+RouteResult<V> FindRoute(const CompactGraph<V, E> & graph, const V & start, const V & end, SearchStats * stats = nullptr,
+	const TravelTimeModel & model = TravelTimeModel());	//Shortest route and its time
+
+template <typename E>
+RouteResult<string> FindNamedRoute(const CompactGraph<uint32_t, E> & graph, const NameTable & names, const string & start,
+	const string & end, SearchStats * stats = nullptr);	//FindRoute() on an id graph, by name
+
+RouteResult<string> NameRoute(const RouteResult<uint32_t> & route, const NameTable & names);	//Ids replaced by their names
+
+template <typename V>
+void WriteRouteText(ostream & out, const RouteResult<V> & result);		//Distance, path and time for people
+
+template <typename V>
+void WriteRouteJson(ostream & out, const RouteResult<V> & result);		//One JSON line
+
+void WriteRouteCsvHeader(ostream & out);	//Column names for WriteRouteCsv
+
+template <typename V>
+void WriteRouteCsv(ostream & out, const RouteResult<V> & result);		//One CSV row
+
+template <typename V>
+void WriteRouteBinary(ostream & out, const RouteResult<V> & result);	//One binary record
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function finds the shortest route from start to end and
+*		   estimates its time with model. Between two stops the time is
+*		   taken from the shortest edge joining them, the one the route
+*		   uses.
+*
+* Precondition:	N/A
+*
+* Postcondition: The result is returned; throws if start or end is not
+*				 in the graph.
+************************************************************************/
+template<typename V, typename E>
+RouteResult<V> FindRoute(const CompactGraph<V, E> & graph, const V & start, const V & end, SearchStats * stats,
+	const TravelTimeModel & model)
+{
+	RouteResult<V> result;
+	result.start = start;
+	result.end = end;
+	result.distance = ShortestRoute(graph, start, end, result.path, stats);
+
+	result.stops.reserve(result.path.size());
+	for (size_t i = 0; i < result.path.size(); i++)
+	{
+		result.stops.push_back(graph.GetData(result.path[i]));
+	}
+	for (size_t i = 0; i + 1 < result.path.size(); i++)
+	{
+		int best = NO_VERTEX;
+		for (int edge = graph.GetEdgeBegin(result.path[i]); edge != graph.GetEdgeEnd(result.path[i]); ++edge)
+		{
+			if (graph.GetTarget(edge) == result.path[i + 1] && (best == NO_VERTEX || graph.GetWeight(edge) < graph.GetWeight(best)))
+			{
+				best = edge;
+			}
+		}
+		result.minutes += model.GetMinutes(graph.GetEdgeData(best), graph.GetWeight(best));
+	}
+	return result;
+}
+
+/**********************************************************************
+* Purpose: This function finds the shortest route between two places on
+*		   an integer id graph, looking the names up in names on the way
+*		   in and out.
+*
+* Precondition:	graph's ids are the ids of names.
+*
+* Postcondition: The named result is returned; throws if start or end is
+*				 not in the graph, as FindRoute() does.
+************************************************************************/
+template<typename E>
+RouteResult<string> FindNamedRoute(const CompactGraph<uint32_t, E> & graph, const NameTable & names, const string & start,
+	const string & end, SearchStats * stats)
+{
+	return NameRoute(FindRoute(graph, names.Find(start), names.Find(end), stats), names);
+}
+
+/**********************************************************************
+* Purpose: This function gives a route found on an integer id graph its
+*		   place names. Graph indices are left as they are.
+*
+* Precondition:	Every id in route is in names.
+*
+* Postcondition: The named route is returned.
+************************************************************************/
+inline RouteResult<string> NameRoute(const RouteResult<uint32_t> & route, const NameTable & names)
+{
+	RouteResult<string> named;
+	named.start = names.GetName(route.start);
+	named.end = names.GetName(route.end);
+	named.distance = route.distance;
+	named.minutes = route.minutes;
+	named.path = route.path;
+	named.stops.reserve(route.stops.size());
+	for (size_t i = 0; i < route.stops.size(); i++)
+	{
+		named.stops.push_back(names.GetName(route.stops[i]));
+	}
+	return named;
+}
+
+/**********************************************************************
+* Purpose: This function writes the distance, the path one stop per line
+*		   and the estimated time, the report Dijkstra() prints.
+*
+* Precondition:	N/A
+*
+* Postcondition: The report is written to out, not flushed.
+************************************************************************/
+template<typename V>
+void WriteRouteText(ostream & out, const RouteResult<V> & result)
+{
+	if (!result.IsReachable())
+	{
+		out << "\nThere is no route from " << result.start << " to " << result.end << "\n\n";
+		return;
+	}
+
+	out << "\nDistance: " << result.distance << '\n';	//Prints total distance
+	out << "Path: " << '\n';
+	for (size_t i = 0; i < result.stops.size(); i++)
+	{
+		out << result.stops[i] << (i + 1 < result.stops.size() ? " to \n" : "\n");
+	}
+	out << '\n';
+	out << "Estimated time: " << result.minutes << " minutes" << '\n';
+	out << "or about " << result.minutes / 60 << " hours" << "\n\n";
+}
+
+/**********************************************************************
+* Purpose: These functions write one value as JSON: names are quoted and
+*		   escaped, anything else (integer ids) is written as is.
+*
+* Precondition:	N/A
+*
+* Postcondition: The value is written to out.
+************************************************************************/
+template<typename V>
+void WriteJsonValue(ostream & out, const V & value)
+{
+	out << value;
+}
+
+inline void WriteJsonValue(ostream & out, const string & value)
+{
+	out << '"';
+	for (size_t i = 0; i < value.size(); i++)
+	{
+		char c = value[i];
+		if (c == '"' || c == '\\')
+		{
+			out << '\\' << c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)	//Control characters as \u00XX
+		{
+			const char HEX[] = "0123456789abcdef";
+			out << "\\u00" << HEX[(c >> 4) & 0xF] << HEX[c & 0xF];
+		}
+		else
+		{
+			out << c;
+		}
+	}
+	out << '"';
+}
+
+/**********************************************************************
+* Purpose: This function writes the result as one JSON object on its own
+*		   line: start, end, reachable, distance, minutes and path.
+*		   Distance is null when there is no route.
+*
+* Precondition:	N/A
+*
+* Postcondition: The line is written to out, not flushed.
+************************************************************************/
+template<typename V>
+void WriteRouteJson(ostream & out, const RouteResult<V> & result)
+{
+	out << "{\"start\":";
+	WriteJsonValue(out, result.start);
+	out << ",\"end\":";
+	WriteJsonValue(out, result.end);
+	out << ",\"reachable\":" << (result.IsReachable() ? "true" : "false") << ",\"distance\":";
+	if (result.IsReachable())
+	{
+		out << result.distance;
+	}
+	else
+	{
+		out << "null";
+	}
+	out << ",\"minutes\":" << result.minutes << ",\"path\":[";
+	for (size_t i = 0; i < result.stops.size(); i++)
+	{
+		if (i > 0)
+		{
+			out << ',';
+		}
+		WriteJsonValue(out, result.stops[i]);
+	}
+	out << "]}\n";
+}
+
+/**********************************************************************
+* Purpose: These functions write one CSV field. Names are quoted when
+*		   they hold a comma, quote or line break; anything else (integer
+*		   ids) is written as is.
+*
+* Precondition:	N/A
+*
+* Postcondition: The field is written to out.
+************************************************************************/
+template<typename V>
+void WriteCsvField(ostream & out, const V & value)
+{
+	out << value;
+}
+
+inline void WriteCsvField(ostream & out, const string & value)
+{
+	if (value.find_first_of(",\"\r\n") == string::npos)
+	{
+		out << value;
+		return;
+	}
+	out << '"';
+	for (size_t i = 0; i < value.size(); i++)
+	{
+		if (value[i] == '"')
+		{
+			out << '"';	//Quotes are doubled
+		}
+		out << value[i];
+	}
+	out << '"';
+}
+
+/**********************************************************************
+* Purpose: These functions write the stops of a path as one CSV field,
+*		   joined by '|'. The joined text is only built when a name
+*		   needs quoting, otherwise the stops go straight to out.
+*
+* Precondition:	N/A
+*
+* Postcondition: The field is written to out.
+************************************************************************/
+template<typename V>
+void WriteCsvPath(ostream & out, const vector<V> & stops)
+{
+	for (size_t i = 0; i < stops.size(); i++)
+	{
+		out << (i > 0 ? "|" : "") << stops[i];
+	}
+}
+
+inline void WriteCsvPath(ostream & out, const vector<string> & stops)
+{
+	bool quote = false;
+	for (size_t i = 0; !quote && i < stops.size(); i++)
+	{
+		quote = stops[i].find_first_of(",\"\r\n") != string::npos;
+	}
+	if (!quote)
+	{
+		for (size_t i = 0; i < stops.size(); i++)
+		{
+			out << (i > 0 ? "|" : "") << stops[i];
+		}
+		return;
+	}
+
+	string path;
+	for (size_t i = 0; i < stops.size(); i++)
+	{
+		path += (i > 0 ? "|" : "") + stops[i];
+	}
+	WriteCsvField(out, path);
+}
+
+/**********************************************************************
+* Purpose: This function writes the CSV column names.
+*
+* Precondition:	N/A
+*
+* Postcondition: The header row is written to out.
+************************************************************************/
+inline void WriteRouteCsvHeader(ostream & out)
+{
+	out << "start,end,distance,minutes,path\n";
+}
+
+/**********************************************************************
+* Purpose: This function writes the result as one CSV row. The path is a
+*		   single field with the stops joined by '|', and distance is
+*		   empty when there is no route.
+*
+* Precondition:	N/A
+*
+* Postcondition: The row is written to out, not flushed.
+************************************************************************/
+template<typename V>
+void WriteRouteCsv(ostream & out, const RouteResult<V> & result)
+{
+	WriteCsvField(out, result.start);
+	out << ',';
+	WriteCsvField(out, result.end);
+	out << ',';
+	if (result.IsReachable())
+	{
+		out << result.distance;
+	}
+	out << ',' << result.minutes << ',';
+	WriteCsvPath(out, result.stops);
+	out << '\n';
+}
+
+/**********************************************************************
+* Purpose: This function writes the result as a binary record of 32 bit
+*		   little endian numbers: distance (-1 if unreachable), time in
+*		   whole seconds, stop count, then the graph index of each stop.
+*		   The record is packed in a small buffer that is written out
+*		   whenever it fills.
+*
+* Precondition:	N/A
+*
+* Postcondition: The record is written to out, not flushed.
+************************************************************************/
+template<typename V>
+void WriteRouteBinary(ostream & out, const RouteResult<V> & result)
+{
+	char record[256];
+	size_t at = 0;
+	int header[3] = { result.IsReachable() ? result.distance : -1, static_cast<int>(result.minutes * 60 + 0.5),
+		static_cast<int>(result.path.size()) };
+
+	for (size_t i = 0; i < 3 + result.path.size(); i++)
+	{
+		uint32_t bits = static_cast<uint32_t>(i < 3 ? header[i] : result.path[i - 3]);
+		record[at++] = static_cast<char>(bits & 0xFF);
+		record[at++] = static_cast<char>((bits >> 8) & 0xFF);
+		record[at++] = static_cast<char>((bits >> 16) & 0xFF);
+		record[at++] = static_cast<char>((bits >> 24) & 0xFF);
+		if (at == sizeof(record))
+		{
+			out.write(record, at);
+			at = 0;
+		}
+	}
+	out.write(record, at);
+}
+#endif
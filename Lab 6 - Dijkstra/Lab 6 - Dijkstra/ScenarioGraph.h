@@ -0,0 +1,566 @@
+/************************************************************************
+* Class: ScenarioGraph
+*
+* Purpose: This class is a what-if view of a CompactGraph: roads closed,
+*		   roads made longer or shorter and roads added, without touching
+*		   or copying the base. The base is held as a CompactGraph copy,
+*		   which only shares its arrays (see CopyOnWrite), so it stays
+*		   alive as long as a scenario uses it and a scenario costs
+*		   memory for its changes alone. Searches read it through
+*		   ForEachEdge(), which CompactGraph has too; vertices with no
+*		   changes go straight to the base's arrays.
+*
+*		   Like Graph::AddEdge, every change applies to both directions
+*		   of a road. Edge ids below GetBaseEdgeCount() are the base's,
+*		   added edges are numbered after them. A scenario is read only
+*		   while it is searched, so any number of threads can search it.
+*
+* Manager functions
+*	ScenarioGraph()
+*		Creates a scenario over an empty graph.
+*	ScenarioGraph(const CompactGraph<V, E> & base)
+*		Creates a scenario with no changes over base.
+*	~ScenarioGraph()
+*		Clears the changes.
+*	ScenarioGraph(const ScenarioGraph<V, E> & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const ScenarioGraph<V, E> & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	RemoveEdge(int from, int to)
+*		Closes the road between two vertices.
+*	SetWeight(int from, int to, Weight weight)
+*		Gives the road between two vertices a new weight.
+*	AddEdge(int from, int to, E data, Weight weight)
+*		Adds a road between two vertices.
+*	RemoveRoad(const E & road) / AdjustRoad(const E & road, Weight change)
+*		Closes, or changes the weight of, every edge with data road.
+*	ForEachEdge(int index, Visit visit)
+*		Calls visit(edge, target, weight) for every open edge of index.
+*	GetVertexCount() / GetEdgeCount() / GetBaseEdgeCount()
+*		Returns the vertices, the edge ids in use and the base's edges.
+*	GetTarget(int edge) / GetWeight(int edge) / GetEdgeData(int edge)
+*		Returns an edge as the scenario has it; closed edges weigh
+*		CLOSED_EDGE.
+*	GetIndex(const V & data) / FindIndex(const V & data) / GetData(int index)
+*		Same as on the base.
+*	GetBase()
+*		Returns the base graph.
+*	GetChangeCount()
+*		Returns the number of edges changed or added.
+*************************************************************************/
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "CompactGraph.h"
+#include "Exception.h"
+using std::vector;
+using std::unordered_map;
+using std::unordered_set;
+
+#pragma once
+#ifndef SCENARIOGRAPH_H
+#define SCENARIOGRAPH_H
+
+const int CLOSED_EDGE = -1;	//Weight of an edge a scenario removed
+
+template <typename V, typename E>
+class ScenarioGraph
+{
+public:
+	typedef typename CompactGraph<V, E>::Weight Weight;
+
+	ScenarioGraph();
+	ScenarioGraph(const CompactGraph<V, E> & base);
+	~ScenarioGraph();
+	ScenarioGraph(const ScenarioGraph<V, E> & copy);
+	const ScenarioGraph<V, E> & operator=(const ScenarioGraph<V, E> & rhs);
+
+	void RemoveEdge(int from, int to);
+	void SetWeight(int from, int to, Weight weight);
+	void AddEdge(int from, int to, E data, Weight weight);
+	int RemoveRoad(const E & road);
+	int AdjustRoad(const E & road, Weight change);
+	template <typename Visit>
+	void ForEachEdge(int index, Visit visit) const;
+	int GetVertexCount() const;
+	int GetEdgeCount() const;
+	int GetBaseEdgeCount() const;
+	int GetTarget(int edge) const;
+	Weight GetWeight(int edge) const;
+	const E & GetEdgeData(int edge) const;
+	int GetIndex(const V & data) const;
+	int FindIndex(const V & data) const;
+	const V & GetData(int index) const;
+	const CompactGraph<V, E> & GetBase() const;
+	int GetChangeCount() const;
+
+private:
+	struct AddedEdge
+	{
+		int target;
+		Weight weight;
+		E data;
+	};
+
+	CompactGraph<V, E> m_base;					//Shares the base's arrays
+	unordered_map<int, Weight> m_changed;		//Base edge id to its new weight, CLOSED_EDGE if removed
+	vector<AddedEdge> m_added;					//Added edge k has id GetBaseEdgeCount() + k
+	unordered_map<int, vector<int>> m_addedFrom;	//Vertex to the added edges leaving it
+	unordered_set<int> m_touched;				//Vertices with a changed or added edge
+
+	void CheckVertex(int index) const;
+	void ChangeEdge(int from, int edge, Weight weight);
+	int ChangeBetween(int from, int to, Weight weight);
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates a scenario over an empty graph.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: There are no vertices and no changes.
+************************************************************************/
+template<typename V, typename E>
+inline ScenarioGraph<V, E>::ScenarioGraph()
+{
+}
+
+/**********************************************************************
+* Purpose: This function creates a scenario over base. Only base's
+*		   arrays are shared, so changing base afterwards (a rebuild, a
+*		   SetWeight) does not change the scenario.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The scenario is base, with no changes.
+************************************************************************/
+template<typename V, typename E>
+inline ScenarioGraph<V, E>::ScenarioGraph(const CompactGraph<V, E> & base) : m_base(base)
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the changes.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are empty.
+************************************************************************/
+template<typename V, typename E>
+inline ScenarioGraph<V, E>::~ScenarioGraph()
+{
+	m_changed.clear();
+	m_added.clear();
+	m_addedFrom.clear();
+	m_touched.clear();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+template<typename V, typename E>
+inline ScenarioGraph<V, E>::ScenarioGraph(const ScenarioGraph<V, E> & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members. The base
+*		   is shared and the changes copied, so a copy can branch off
+*		   into a scenario of its own.
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+template<typename V, typename E>
+inline const ScenarioGraph<V, E> & ScenarioGraph<V, E>::operator=(const ScenarioGraph<V, E> & rhs)
+{
+	if (this != &rhs)
+	{
+		m_base = rhs.m_base;
+		m_changed = rhs.m_changed;
+		m_added = rhs.m_added;
+		m_addedFrom = rhs.m_addedFrom;
+		m_touched = rhs.m_touched;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function closes the road between from and to, both ways,
+*		   including any parallel road and any road the scenario added.
+*
+* Precondition:	from and to are valid vertices.
+*
+* Postcondition: No open edge joins from and to.
+************************************************************************/
+template<typename V, typename E>
+inline void ScenarioGraph<V, E>::RemoveEdge(int from, int to)
+{
+	CheckVertex(from);
+	CheckVertex(to);
+	if (ChangeBetween(from, to, CLOSED_EDGE) + ChangeBetween(to, from, CLOSED_EDGE) == 0)
+	{
+		throw Exception("Edge is not in the graph");
+	}
+}
+
+/**********************************************************************
+* Purpose: This function gives every road between from and to a new
+*		   weight, both ways. Closed roads are opened again.
+*
+* Precondition:	from and to are valid vertices, weight is 0 or more.
+*
+* Postcondition: Every edge joining from and to has weight weight.
+************************************************************************/
+template<typename V, typename E>
+inline void ScenarioGraph<V, E>::SetWeight(int from, int to, Weight weight)
+{
+	CheckVertex(from);
+	CheckVertex(to);
+	if (weight < 0)
+	{
+		throw Exception("Weight must be 0 or more");
+	}
+	if (ChangeBetween(from, to, weight) + ChangeBetween(to, from, weight) == 0)
+	{
+		throw Exception("Edge is not in the graph");
+	}
+}
+
+/**********************************************************************
+* Purpose: This function adds a road between from and to, as an edge
+*		   each way.
+*
+* Precondition:	from and to are valid vertices, weight is 0 or more.
+*
+* Postcondition: The two edges are numbered after the existing ones.
+************************************************************************/
+template<typename V, typename E>
+inline void ScenarioGraph<V, E>::AddEdge(int from, int to, E data, Weight weight)
+{
+	if (from < 0 || from >= GetVertexCount() || to < 0 || to >= GetVertexCount())
+	{
+		throw Exception("Unable to add edge; vertex was not found!");
+	}
+	if (weight < 0)
+	{
+		throw Exception("Weight must be 0 or more");
+	}
+
+	AddedEdge added = { to, weight, data };
+	m_addedFrom[from].push_back(static_cast<int>(m_added.size()));
+	m_added.push_back(added);
+	m_touched.insert(from);
+
+	added.target = from;
+	m_addedFrom[to].push_back(static_cast<int>(m_added.size()));
+	m_added.push_back(added);
+	m_touched.insert(to);
+}
+
+/**********************************************************************
+* Purpose: This function closes every edge whose data is road, such as
+*		   every stretch of one highway. It looks at every edge once.
+*
+* Precondition:	N/A
+*
+* Postcondition: The edges are closed; the number closed is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::RemoveRoad(const E & road)
+{
+	int count = 0;
+	for (int from = 0; from < GetVertexCount(); from++)
+	{
+		for (int edge = m_base.GetEdgeBegin(from); edge != m_base.GetEdgeEnd(from); ++edge)
+		{
+			if (m_base.GetEdgeData(edge) == road)
+			{
+				ChangeEdge(from, edge, CLOSED_EDGE);
+				count++;
+			}
+		}
+	}
+	for (size_t k = 0; k < m_added.size(); k++)
+	{
+		if (m_added[k].data == road)
+		{
+			m_added[k].weight = CLOSED_EDGE;
+			count++;
+		}
+	}
+	return count;
+}
+
+/**********************************************************************
+* Purpose: This function adds change to the weight of every open edge
+*		   whose data is road, stopping at 0, so "Hwy 42 is 10 miles
+*		   shorter" is AdjustRoad("42", -10).
+*
+* Precondition:	N/A
+*
+* Postcondition: The edges are changed; the number changed is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::AdjustRoad(const E & road, Weight change)
+{
+	int count = 0;
+	for (int from = 0; from < GetVertexCount(); from++)
+	{
+		for (int edge = m_base.GetEdgeBegin(from); edge != m_base.GetEdgeEnd(from); ++edge)
+		{
+			Weight weight = GetWeight(edge);
+			if (weight != CLOSED_EDGE && m_base.GetEdgeData(edge) == road)
+			{
+				ChangeEdge(from, edge, weight + change > 0 ? weight + change : 0);
+				count++;
+			}
+		}
+	}
+	for (size_t k = 0; k < m_added.size(); k++)
+	{
+		if (m_added[k].weight != CLOSED_EDGE && m_added[k].data == road)
+		{
+			m_added[k].weight = m_added[k].weight + change > 0 ? m_added[k].weight + change : 0;
+			count++;
+		}
+	}
+	return count;
+}
+
+/**********************************************************************
+* Purpose: This function calls visit(edge, target, weight) for every open
+*		   edge leaving index, in the base's order followed by added
+*		   edges. A vertex without changes costs one hash lookup over
+*		   walking the base's arrays.
+*
+* Precondition:	index is a valid vertex.
+*
+* Postcondition: visit was called once per open edge.
+************************************************************************/
+template<typename V, typename E>
+template<typename Visit>
+inline void ScenarioGraph<V, E>::ForEachEdge(int index, Visit visit) const
+{
+	if (m_touched.find(index) == m_touched.end())
+	{
+		m_base.ForEachEdge(index, visit);
+		return;
+	}
+
+	for (int edge = m_base.GetEdgeBegin(index); edge != m_base.GetEdgeEnd(index); ++edge)
+	{
+		Weight weight = GetWeight(edge);
+		if (weight != CLOSED_EDGE)
+		{
+			visit(edge, m_base.GetTarget(edge), weight);
+		}
+	}
+
+	typename unordered_map<int, vector<int>>::const_iterator added = m_addedFrom.find(index);
+	if (added != m_addedFrom.end())
+	{
+		for (size_t i = 0; i < added->second.size(); i++)
+		{
+			const AddedEdge & edge = m_added[added->second[i]];
+			if (edge.weight != CLOSED_EDGE)
+			{
+				visit(GetBaseEdgeCount() + added->second[i], edge.target, edge.weight);
+			}
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: These functions return the number of vertices, of edge ids in
+*		   use (closed ones included) and of edges in the base.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::GetVertexCount() const
+{
+	return m_base.GetVertexCount();
+}
+
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::GetEdgeCount() const
+{
+	return m_base.GetEdgeCount() + static_cast<int>(m_added.size());
+}
+
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::GetBaseEdgeCount() const
+{
+	return m_base.GetEdgeCount();
+}
+
+/**********************************************************************
+* Purpose: These functions return the target, weight and data of an
+*		   edge as the scenario has it.
+*
+* Precondition:	edge is below GetEdgeCount().
+*
+* Postcondition: The value is returned; a closed edge weighs CLOSED_EDGE.
+************************************************************************/
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::GetTarget(int edge) const
+{
+	return edge < GetBaseEdgeCount() ? m_base.GetTarget(edge) : m_added[edge - GetBaseEdgeCount()].target;
+}
+
+template<typename V, typename E>
+inline typename ScenarioGraph<V, E>::Weight ScenarioGraph<V, E>::GetWeight(int edge) const
+{
+	if (edge >= GetBaseEdgeCount())
+	{
+		return m_added[edge - GetBaseEdgeCount()].weight;
+	}
+	typename unordered_map<int, Weight>::const_iterator changed = m_changed.find(edge);
+	return changed == m_changed.end() ? m_base.GetWeight(edge) : changed->second;
+}
+
+template<typename V, typename E>
+inline const E & ScenarioGraph<V, E>::GetEdgeData(int edge) const
+{
+	return edge < GetBaseEdgeCount() ? m_base.GetEdgeData(edge) : m_added[edge - GetBaseEdgeCount()].data;
+}
+
+/**********************************************************************
+* Purpose: These functions look vertices up in the base; a scenario
+*		   never adds or removes vertices.
+*
+* Precondition:	See CompactGraph.
+*
+* Postcondition: See CompactGraph.
+************************************************************************/
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::GetIndex(const V & data) const
+{
+	return m_base.GetIndex(data);
+}
+
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::FindIndex(const V & data) const
+{
+	return m_base.FindIndex(data);
+}
+
+template<typename V, typename E>
+inline const V & ScenarioGraph<V, E>::GetData(int index) const
+{
+	return m_base.GetData(index);
+}
+
+/**********************************************************************
+* Purpose: This function returns the base graph.
+*
+* Precondition:	N/A
+*
+* Postcondition: The base is returned.
+************************************************************************/
+template<typename V, typename E>
+inline const CompactGraph<V, E> & ScenarioGraph<V, E>::GetBase() const
+{
+	return m_base;
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of base edges changed plus
+*		   the number of edges added, which is what the scenario's
+*		   memory grows with.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::GetChangeCount() const
+{
+	return static_cast<int>(m_changed.size() + m_added.size());
+}
+
+/**********************************************************************
+* Purpose: This function checks that index is a vertex.
+*
+* Precondition:	N/A
+*
+* Postcondition: Throws if it is not.
+************************************************************************/
+template<typename V, typename E>
+inline void ScenarioGraph<V, E>::CheckVertex(int index) const
+{
+	if (index < 0 || index >= GetVertexCount())
+	{
+		throw Exception("Unable to change edge; vertex was not found!");
+	}
+}
+
+/**********************************************************************
+* Purpose: This function gives base edge edge, leaving from, a new
+*		   weight. Setting it back to the base's weight drops the change.
+*
+* Precondition:	edge leaves from.
+*
+* Postcondition: The edge has the weight in this scenario.
+************************************************************************/
+template<typename V, typename E>
+inline void ScenarioGraph<V, E>::ChangeEdge(int from, int edge, Weight weight)
+{
+	if (weight == m_base.GetWeight(edge))
+	{
+		m_changed.erase(edge);
+	}
+	else
+	{
+		m_changed[edge] = weight;
+	}
+	m_touched.insert(from);	//Kept even if the change was dropped; it is only a hint
+}
+
+/**********************************************************************
+* Purpose: This function gives every edge from from to to, base and
+*		   added, a new weight.
+*
+* Precondition:	from and to are valid vertices.
+*
+* Postcondition: The number of edges changed is returned.
+************************************************************************/
+template<typename V, typename E>
+inline int ScenarioGraph<V, E>::ChangeBetween(int from, int to, Weight weight)
+{
+	int count = 0;
+	for (int edge = m_base.GetEdgeBegin(from); edge != m_base.GetEdgeEnd(from); ++edge)
+	{
+		if (m_base.GetTarget(edge) == to)
+		{
+			ChangeEdge(from, edge, weight);
+			count++;
+		}
+	}
+
+	typename unordered_map<int, vector<int>>::iterator added = m_addedFrom.find(from);
+	if (added != m_addedFrom.end())
+	{
+		for (size_t i = 0; i < added->second.size(); i++)
+		{
+			if (m_added[added->second[i]].target == to)
+			{
+				m_added[added->second[i]].weight = weight;
+				count++;
+			}
+		}
+	}
+	return count;
+}
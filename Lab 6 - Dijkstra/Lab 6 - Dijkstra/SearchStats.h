@@ -0,0 +1,144 @@
+/*************************************************************
+* Filename:		SearchStats.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Counters for what a search did: vertices settled, edges
+*	relaxed, queue pushes and pops, decrease-keys, and the wall
+*	time of each phase (looking up the start and end, searching,
+*	rebuilding the path). The engines take an optional SearchStats
+*	and add one query to it, so the same object gives per query
+*	numbers or, left to collect many queries, aggregates.
+*
+*	Counting is on unless ROUTING_STATS is defined to 0, which
+*	compiles every counter, timer and trace write out of the
+*	engines. The engines keep their counts in locals and only
+*	touch the caller's SearchStats once per query.
+*
+*	The engines can also be given a trace stream. Every push and
+*	settle is written as a line "push,vertex,distance" or
+*	"settle,vertex,distance", which is enough to replay the
+*	frontier offline.
+**************************************************************/
+#include <iostream>
+#include <chrono>
+using std::ostream;
+
+#ifndef ROUTING_STATS
+#define ROUTING_STATS 1
+#endif
+
+#pragma once
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#if ROUTING_STATS
+#define STATS_ADD(counter, amount) ((counter) += (amount))
+#else
+#define STATS_ADD(counter, amount) ((void)sizeof(amount))	//Not evaluated, but still counts as a use
+#endif
+
+struct SearchStats
+{
+	long long queries;
+	long long settled;			//Vertices taken off the queue and expanded
+	long long relaxed;			//Edges looked at from settled vertices
+	long long pushes;			//Queue insertions, decrease-keys included
+	long long pops;				//Queue removals, stale entries included
+	long long decreaseKeys;		//Improvements to a vertex that was already reached
+	double lookupSeconds;		//Finding the start and end
+	double searchSeconds;		//The search itself
+	double reconstructSeconds;	//Predecessors and path
+
+	SearchStats() { Clear(); }
+	void Clear();
+	void Add(const SearchStats & other);
+};
+
+double StatsClock();	//Seconds, for phase timers
+ostream & operator<<(ostream & out, const SearchStats & stats);	//Totals and per query averages
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function sets every counter to zero.
+*
+* Precondition:	N/A
+*
+* Postcondition: The stats are empty.
+************************************************************************/
+inline void SearchStats::Clear()
+{
+	queries = 0;
+	settled = 0;
+	relaxed = 0;
+	pushes = 0;
+	pops = 0;
+	decreaseKeys = 0;
+	lookupSeconds = 0;
+	searchSeconds = 0;
+	reconstructSeconds = 0;
+}
+
+/**********************************************************************
+* Purpose: This function adds other's counters to these.
+*
+* Precondition:	N/A
+*
+* Postcondition: The stats hold the sum of both.
+************************************************************************/
+inline void SearchStats::Add(const SearchStats & other)
+{
+	queries += other.queries;
+	settled += other.settled;
+	relaxed += other.relaxed;
+	pushes += other.pushes;
+	pops += other.pops;
+	decreaseKeys += other.decreaseKeys;
+	lookupSeconds += other.lookupSeconds;
+	searchSeconds += other.searchSeconds;
+	reconstructSeconds += other.reconstructSeconds;
+}
+
+/**********************************************************************
+* Purpose: This function returns a time in seconds for the phase timers.
+*		   With ROUTING_STATS off it returns 0, so timers cost nothing.
+*
+* Precondition:	N/A
+*
+* Postcondition: The time is returned.
+************************************************************************/
+inline double StatsClock()
+{
+#if ROUTING_STATS
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+	return 0;
+#endif
+}
+
+/**********************************************************************
+* Purpose: This function prints the counters, with per query averages
+*		   when there was more than one query.
+*
+* Precondition:	N/A
+*
+* Postcondition: The stats are written to out.
+************************************************************************/
+inline ostream & operator<<(ostream & out, const SearchStats & stats)
+{
+	double queries = stats.queries > 0 ? static_cast<double>(stats.queries) : 1;
+
+	out << "queries " << stats.queries << ", settled " << stats.settled << ", relaxed " << stats.relaxed
+		<< ", pushes " << stats.pushes << ", pops " << stats.pops << ", decrease-keys " << stats.decreaseKeys
+		<< ", lookup " << stats.lookupSeconds * 1e6 << " us, search " << stats.searchSeconds * 1e6
+		<< " us, reconstruct " << stats.reconstructSeconds * 1e6 << " us";
+	if (stats.queries > 1)
+	{
+		out << " (per query: settled " << stats.settled / queries << ", relaxed " << stats.relaxed / queries
+			<< ", pushes " << stats.pushes / queries << ", search " << stats.searchSeconds * 1e6 / queries << " us)";
+	}
+	return out;
+}
+#endif
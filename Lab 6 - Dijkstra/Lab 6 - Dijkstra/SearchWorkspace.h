@@ -0,0 +1,230 @@
+/************************************************************************
+* Class: SearchWorkspace
+*
+* Purpose: This class holds the per vertex arrays and the queue of a
+*		   search so they can be reused from one query to the next.
+*		   Only the vertices a search touched are reset afterwards, so a
+*		   search that stays local (a bounded or point to point query)
+*		   costs time for what it touched, not for the whole graph.
+*		   Give each thread its own workspace.
+*
+* Manager functions
+*	SearchWorkspace()
+*		Creates an empty workspace.
+*	~SearchWorkspace()
+*		Clears all of the arrays.
+*	SearchWorkspace(const SearchWorkspace & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const SearchWorkspace & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Prepare(int vertices)
+*		Resets what the last search touched and sizes the arrays.
+*	Touch(int vertex)
+*		Records that vertex is being changed, so it is reset later.
+*	Reset()
+*		Puts every touched vertex back to unreached.
+*	GetDistances() / GetPreds() / GetDone()
+*		Returns the raw arrays, for tight loops.
+*	GetTouched()
+*		Returns the vertices touched since the last reset.
+*	GetQueue()
+*		Returns the queue, emptied by Prepare().
+*************************************************************************/
+#include <vector>
+#include "CompactGraph.h"
+#include "RadixHeap.h"
+using std::vector;
+
+#pragma once
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+class SearchWorkspace
+{
+public:
+	SearchWorkspace();
+	~SearchWorkspace();
+	SearchWorkspace(const SearchWorkspace & copy);
+	SearchWorkspace & operator=(const SearchWorkspace & rhs);
+
+	void Prepare(int vertices);
+	void Touch(int vertex);
+	void Reset();
+	int * GetDistances();
+	int * GetPreds();
+	char * GetDone();
+	const vector<int> & GetTouched() const;
+	RadixHeap<int> & GetQueue();
+
+private:
+	vector<int> m_distance;		//INFINITE_DISTANCE when untouched
+	vector<int> m_pred;			//NO_VERTEX when untouched
+	vector<char> m_done;		//Set once a vertex is settled
+	vector<int> m_touched;		//Vertices to reset
+	RadixHeap<int> m_queue;
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty workspace.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The arrays are empty.
+************************************************************************/
+inline SearchWorkspace::SearchWorkspace()
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears all of the arrays.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: The arrays are empty.
+************************************************************************/
+inline SearchWorkspace::~SearchWorkspace()
+{
+	m_distance.clear();
+	m_pred.clear();
+	m_done.clear();
+	m_touched.clear();
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to copy the workspace.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: This is a copy of copy.
+************************************************************************/
+inline SearchWorkspace::SearchWorkspace(const SearchWorkspace & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function copies the arrays of rhs. The queue is not
+*		   copied, it is empty between searches.
+*
+* Precondition:	N/A
+*
+* Postcondition: This is a copy of rhs.
+************************************************************************/
+inline SearchWorkspace & SearchWorkspace::operator=(const SearchWorkspace & rhs)
+{
+	if (this != &rhs)
+	{
+		m_distance = rhs.m_distance;
+		m_pred = rhs.m_pred;
+		m_done = rhs.m_done;
+		m_touched = rhs.m_touched;
+		m_queue.Clear();
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function gets the workspace ready for a search of a graph
+*		   with vertices vertices: the last search is undone and the queue
+*		   emptied. The arrays are only reallocated if the size changed.
+*
+* Precondition:	N/A
+*
+* Postcondition: Every vertex is unreached and unsettled.
+************************************************************************/
+inline void SearchWorkspace::Prepare(int vertices)
+{
+	if (static_cast<int>(m_distance.size()) != vertices)
+	{
+		m_distance.assign(vertices, INFINITE_DISTANCE);
+		m_pred.assign(vertices, NO_VERTEX);
+		m_done.assign(vertices, 0);
+		m_touched.clear();
+	}
+	else
+	{
+		Reset();
+	}
+	m_queue.Clear();
+}
+
+/**********************************************************************
+* Purpose: This function records that vertex is about to change.
+*
+* Precondition:	vertex is untouched since the last reset (its distance
+*				is INFINITE_DISTANCE), or it will be listed twice.
+*
+* Postcondition: vertex will be reset by Reset().
+************************************************************************/
+inline void SearchWorkspace::Touch(int vertex)
+{
+	m_touched.push_back(vertex);
+}
+
+/**********************************************************************
+* Purpose: This function puts every touched vertex back to unreached.
+*
+* Precondition:	N/A
+*
+* Postcondition: No vertex is touched.
+************************************************************************/
+inline void SearchWorkspace::Reset()
+{
+	for (size_t i = 0; i < m_touched.size(); i++)
+	{
+		m_distance[m_touched[i]] = INFINITE_DISTANCE;
+		m_pred[m_touched[i]] = NO_VERTEX;
+		m_done[m_touched[i]] = 0;
+	}
+	m_touched.clear();
+}
+
+/**********************************************************************
+* Purpose: These functions return the raw arrays.
+*
+* Precondition:	Prepare() was called.
+*
+* Postcondition: The array is returned.
+************************************************************************/
+inline int * SearchWorkspace::GetDistances()
+{
+	return m_distance.data();
+}
+
+inline int * SearchWorkspace::GetPreds()
+{
+	return m_pred.data();
+}
+
+inline char * SearchWorkspace::GetDone()
+{
+	return m_done.data();
+}
+
+/**********************************************************************
+* Purpose: This function returns the vertices touched since the last
+*		   reset.
+*
+* Precondition:	N/A
+*
+* Postcondition: The list is returned.
+************************************************************************/
+inline const vector<int> & SearchWorkspace::GetTouched() const
+{
+	return m_touched;
+}
+
+/**********************************************************************
+* Purpose: This function returns the workspace's queue.
+*
+* Precondition:	N/A
+*
+* Postcondition: The queue is returned.
+************************************************************************/
+inline RadixHeap<int> & SearchWorkspace::GetQueue()
+{
+	return m_queue;
+}
@@ -0,0 +1,379 @@
+/*************************************************************
+* Filename:		ShortestPaths.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Single source shortest path engine that runs on a CompactGraph.
+*	Unlike Dijkstra() in methods.h it does not prompt or print, it
+*	fills a distance and predecessor array for every vertex, so it
+*	can be used for full graph runs (isochrones, precomputation).
+*	Unreached vertices are left at INFINITE_DISTANCE / NO_VERTEX.
+*
+*	The priority queue is picked at compile time from the weight
+*	type: integer weights (miles) get a RadixHeap, anything else a
+*	BinaryHeap. ShortestPathsWith<Queue>() forces a particular one.
+*	Edges are relaxed with the kernel GetRelaxKernel() picks (AVX2
+*	when the CPU has it).
+*
+*	ShortestRoute() is the point to point query on top: it looks up
+*	the start and end, searches, and walks the path back; when the
+*	graph holds its components (LabelComponents() in Components.h)
+*	a start and end that are apart are answered without a search. Every
+*	function takes an optional SearchStats to count into and a
+*	trace stream (see SearchStats.h).
+*
+*	ShortestPathsOver() and ShortestRouteOver() run on anything with
+*	GetVertexCount() and ForEachEdge(): a CompactGraph, or a
+*	ScenarioGraph with roads closed, changed or added. They search
+*	in a SearchWorkspace and can stop once a target is settled.
+**************************************************************/
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "CompactGraph.h"
+#include "BinaryHeap.h"
+#include "RadixHeap.h"
+#include "RelaxKernel.h"
+#include "SearchStats.h"
+#include "SearchWorkspace.h"
+using std::vector;
+using std::ostream;
+
+#pragma once
+#ifndef SHORTESTPATHS_H
+#define SHORTESTPATHS_H
+
+/************************************************************************
+* Class: QueueSelector
+*
+* Purpose: Picks the priority queue for a weight type W. Monotone integer
+*		   queues beat comparison heaps when weights are integers, so the
+*		   specialization below swaps in a RadixHeap for them.
+*************************************************************************/
+template <typename W, bool Integral = std::is_integral<W>::value>
+struct QueueSelector
+{
+	typedef BinaryHeap<W> Type;
+};
+
+template <typename W>
+struct QueueSelector<W, true>
+{
+	typedef RadixHeap<W> Type;
+};
+
+template <typename V, typename E>
+void ShortestPaths(const CompactGraph<V, E> & graph, int source, vector<int> & distance, vector<int> & pred,
+	SearchStats * stats = nullptr, ostream * trace = nullptr);	//Sequential distances to every vertex
+
+template <typename Queue, typename V, typename E>
+void ShortestPathsWith(const CompactGraph<V, E> & graph, int source, vector<int> & distance, vector<int> & pred,
+	SearchStats * stats = nullptr, ostream * trace = nullptr);	//Same, with the given queue
+
+template <typename V, typename E>
+int ShortestRoute(const CompactGraph<V, E> & graph, const V & start, const V & end, vector<int> & path,
+	SearchStats * stats = nullptr, ostream * trace = nullptr);	//Distance and path from start to end
+
+template <typename Adjacency>
+void ShortestPathsOver(const Adjacency & graph, int source, SearchWorkspace & workspace, int target = NO_VERTEX,
+	SearchStats * stats = nullptr);	//Distances through ForEachEdge, into workspace
+
+template <typename Adjacency>
+int ShortestRouteOver(const Adjacency & graph, int source, int target, SearchWorkspace & workspace, vector<int> & path,
+	SearchStats * stats = nullptr);	//Distance and path through ForEachEdge
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function calculates the minimum distance from source to
+*		   every vertex of the graph, with the queue QueueSelector picks
+*		   for the graph's weight type.
+*
+* Precondition:	source is a valid index of graph.
+*
+* Postcondition: distance and pred hold one entry per vertex.
+************************************************************************/
+template<typename V, typename E>
+void ShortestPaths(const CompactGraph<V, E> & graph, int source, vector<int> & distance, vector<int> & pred,
+	SearchStats * stats, ostream * trace)
+{
+	ShortestPathsWith<typename QueueSelector<typename CompactGraph<V, E>::Weight>::Type>(graph, source, distance, pred, stats, trace);
+}
+
+/**********************************************************************
+* Purpose: This function calculates the minimum distance from source to
+*		   every vertex of the graph with a Queue (BinaryHeap, RadixHeap).
+*
+* Precondition:	source is a valid index of graph.
+*
+* Postcondition: distance and pred hold one entry per vertex; pred is the
+*				 vertex that last lowered each distance, so the tree
+*				 holds with zero weight edges too. One query is added
+*				 to stats, and pushes / settles written to trace, when
+*				 they are given.
+************************************************************************/
+template<typename Queue, typename V, typename E>
+void ShortestPathsWith(const CompactGraph<V, E> & graph, int source, vector<int> & distance, vector<int> & pred,
+	SearchStats * stats, ostream * trace)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+
+	const int * targets = graph.GetTargets();
+	const int * weights = graph.GetWeights();
+	RelaxKernel relax = GetRelaxKernel();
+	vector<int> improved;	//Targets the kernel lowered, never more than one vertex's edges
+	vector<char> done(graph.GetVertexCount(), 0);	//Parallel edges can queue a vertex twice at the same distance
+	Queue heap;
+	int most = 1;
+	SearchStats counts;		//Counted in a local, *stats is only touched once
+	counts.searchSeconds -= StatsClock();	//Phase timers start negative and add the end time
+
+	for (int i = 0; i < graph.GetVertexCount(); i++)
+	{
+		if (graph.GetEdgeEnd(i) - graph.GetEdgeBegin(i) > most)
+		{
+			most = graph.GetEdgeEnd(i) - graph.GetEdgeBegin(i);
+		}
+	}
+	improved.resize(most);
+
+	distance.assign(graph.GetVertexCount(), INFINITE_DISTANCE);
+	pred.assign(graph.GetVertexCount(), NO_VERTEX);
+	distance[source] = 0;	//Distance from the starting point is always 0
+	heap.Push(0, source);
+	STATS_ADD(counts.pushes, 1);
+
+	while (!heap.IsEmpty())
+	{
+		int dist = heap.GetTopKey();
+		int current = heap.GetTopVertex();
+		heap.Pop();
+		STATS_ADD(counts.pops, 1);
+
+		if (dist == distance[current] && !done[current])	//Skip entries that were improved after being pushed
+		{
+			done[current] = 1;
+			int count = relax(targets, weights, graph.GetEdgeBegin(current), graph.GetEdgeEnd(current), dist, &distance[0], &improved[0]);
+			STATS_ADD(counts.settled, 1);
+			STATS_ADD(counts.relaxed, graph.GetEdgeEnd(current) - graph.GetEdgeBegin(current));
+			STATS_ADD(counts.pushes, count);
+#if ROUTING_STATS
+			if (trace != nullptr)
+			{
+				*trace << "settle," << current << ',' << dist << '\n';
+				for (int i = 0; i < count; i++)
+				{
+					*trace << "push," << improved[i] << ',' << distance[improved[i]] << '\n';
+				}
+			}
+#endif
+			for (int i = 0; i < count; i++)
+			{
+				pred[improved[i]] = current;	//Every edge the kernel saw leaves current
+				heap.Push(distance[improved[i]], improved[i]);
+			}
+		}
+	}
+	counts.searchSeconds += StatsClock();
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		long long reached = 0;
+		for (size_t i = 0; i < distance.size(); i++)
+		{
+			reached += distance[i] != INFINITE_DISTANCE ? 1 : 0;
+		}
+		counts.queries = 1;
+		counts.decreaseKeys = counts.pushes - reached;	//The first push of each reached vertex is an insert
+		stats->Add(counts);
+	}
+#endif
+}
+
+/**********************************************************************
+* Purpose: This function finds the shortest route from start to end:
+*		   it looks both up, searches from start, and walks the
+*		   predecessors back from end.
+*
+* Precondition:	N/A
+*
+* Postcondition: path holds the indices from start to end (empty if end
+*				 can't be reached) and the distance is returned,
+*				 INFINITE_DISTANCE if end can't be reached.
+************************************************************************/
+template<typename V, typename E>
+int ShortestRoute(const CompactGraph<V, E> & graph, const V & start, const V & end, vector<int> & path,
+	SearchStats * stats, ostream * trace)
+{
+	SearchStats counts;
+	counts.lookupSeconds -= StatsClock();
+	int source = graph.FindIndex(start);
+	int target = graph.FindIndex(end);
+	counts.lookupSeconds += StatsClock();
+
+	if (source == NO_VERTEX)
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (target == NO_VERTEX)
+	{
+		throw Exception("Ending vertex is not in the graph!");
+	}
+
+	path.clear();
+	if (!graph.MayConnect(source, target))
+	{
+#if ROUTING_STATS
+		if (stats != nullptr)
+		{
+			counts.queries = 1;
+			stats->Add(counts);
+		}
+#endif
+		return INFINITE_DISTANCE;	//Different components, nothing to search
+	}
+
+	vector<int> distance;
+	vector<int> pred;
+	ShortestPaths(graph, source, distance, pred, stats != nullptr ? &counts : nullptr, trace);
+
+	counts.reconstructSeconds -= StatsClock();
+	if (distance[target] != INFINITE_DISTANCE)
+	{
+		for (int vertex = target; vertex != NO_VERTEX; vertex = pred[vertex])
+		{
+			path.push_back(vertex);
+		}
+		std::reverse(path.begin(), path.end());
+	}
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.reconstructSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+	return distance[target];
+}
+
+/**********************************************************************
+* Purpose: This function runs Dijkstra from source over any graph with
+*		   GetVertexCount() and ForEachEdge(int, visit(edge, target,
+*		   weight)), so the same search answers the base graph and every
+*		   scenario over it. With a target it stops once the target is
+*		   settled.
+*
+* Precondition:	source is a valid vertex of graph, weights are 0 or more.
+*
+* Postcondition: The workspace holds the distance and predecessor of
+*				 every vertex reached, until its next Prepare(); every
+*				 distance is final if target is NO_VERTEX, and the
+*				 target's is if it was reached.
+************************************************************************/
+template<typename Adjacency>
+void ShortestPathsOver(const Adjacency & graph, int source, SearchWorkspace & workspace, int target, SearchStats * stats)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+
+	workspace.Prepare(graph.GetVertexCount());
+	int * distance = workspace.GetDistances();
+	int * pred = workspace.GetPreds();
+	char * done = workspace.GetDone();
+	RadixHeap<int> & heap = workspace.GetQueue();
+	SearchStats counts;
+	counts.searchSeconds -= StatsClock();
+
+	workspace.Touch(source);
+	distance[source] = 0;
+	heap.Push(0, source);
+	STATS_ADD(counts.pushes, 1);
+
+	while (!heap.IsEmpty())
+	{
+		int dist = heap.GetTopKey();
+		int current = heap.GetTopVertex();
+		heap.Pop();
+		STATS_ADD(counts.pops, 1);
+		if (dist != distance[current] || done[current])
+		{
+			continue;	//Improved after it was pushed
+		}
+		done[current] = 1;
+		STATS_ADD(counts.settled, 1);
+		if (current == target)
+		{
+			break;
+		}
+
+		graph.ForEachEdge(current, [&](int, int to, int weight)
+		{
+			int cost = dist + weight;
+			STATS_ADD(counts.relaxed, 1);
+			if (cost < distance[to])
+			{
+				if (distance[to] == INFINITE_DISTANCE)
+				{
+					workspace.Touch(to);
+				}
+				distance[to] = cost;
+				pred[to] = current;
+				heap.Push(cost, to);
+				STATS_ADD(counts.pushes, 1);
+			}
+		});
+	}
+	heap.Clear();
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.searchSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+}
+
+/**********************************************************************
+* Purpose: This function finds the shortest route from source to target
+*		   over any graph with ForEachEdge(), stopping the search as soon
+*		   as target is settled.
+*
+* Precondition:	N/A
+*
+* Postcondition: path holds the indices from source to target (empty if
+*				 target can't be reached) and the distance is returned,
+*				 INFINITE_DISTANCE if target can't be reached.
+************************************************************************/
+template<typename Adjacency>
+int ShortestRouteOver(const Adjacency & graph, int source, int target, SearchWorkspace & workspace, vector<int> & path,
+	SearchStats * stats)
+{
+	if (target < 0 || target >= graph.GetVertexCount())
+	{
+		throw Exception("Ending vertex is not in the graph!");
+	}
+
+	ShortestPathsOver(graph, source, workspace, target, stats);
+	path.clear();
+	if (workspace.GetDistances()[target] == INFINITE_DISTANCE)
+	{
+		return INFINITE_DISTANCE;
+	}
+	for (int at = target; at != NO_VERTEX; at = workspace.GetPreds()[at])
+	{
+		path.push_back(at);
+	}
+	std::reverse(path.begin(), path.end());
+	return workspace.GetDistances()[target];
+}
+#endif
@@ -0,0 +1,210 @@
+/************************************************************************
+* Class: TravelTimeModel
+*
+* Purpose: This class turns miles of road into driving time, with a speed
+*		   for each road class. By default interstates are 65 mph and
+*		   everything else 55 mph, the speeds Dijkstra() has always used,
+*		   but each class can be set (a loaded truck, a winter profile).
+*		   Searches by time use EdgeSeconds(), a whole second cost for
+*		   every edge of a CompactGraph.
+*
+* Manager functions
+*	TravelTimeModel()
+*		Sets the default speeds.
+*	TravelTimeModel(double interstate, double highway, double other)
+*		Sets the speed of each class in mph.
+*	~TravelTimeModel()
+*		N/A
+*	TravelTimeModel(const TravelTimeModel & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const TravelTimeModel & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	SetSpeed(RoadClass road, double mph) / GetSpeed(RoadClass road)
+*		Sets / returns the speed on a road class.
+*	GetMinutes(const E & road, int miles)
+*		Returns the minutes it takes to drive miles on road.
+*	GetSeconds(const E & road, int miles)
+*		Same, rounded to whole seconds.
+*	EdgeSeconds(const CompactGraph<V, E> & graph)
+*		Returns GetSeconds() of every edge, by edge id.
+*************************************************************************/
+#include <vector>
+#include "CompactGraph.h"
+#include "RoadClass.h"
+#include "Exception.h"
+using std::vector;
+
+#pragma once
+#ifndef TRAVELTIMEMODEL_H
+#define TRAVELTIMEMODEL_H
+
+class TravelTimeModel
+{
+public:
+	TravelTimeModel();
+	TravelTimeModel(double interstate, double highway, double other);
+	~TravelTimeModel();
+	TravelTimeModel(const TravelTimeModel & copy);
+	TravelTimeModel & operator=(const TravelTimeModel & rhs);
+
+	void SetSpeed(RoadClass road, double mph);
+	double GetSpeed(RoadClass road) const;
+	template <typename E>
+	double GetMinutes(const E & road, int miles) const;
+	template <typename E>
+	int GetSeconds(const E & road, int miles) const;
+	template <typename V, typename E>
+	vector<int> EdgeSeconds(const CompactGraph<V, E> & graph) const;
+
+private:
+	double m_mph[ROAD_CLASS_COUNT];	//Speed of each road class
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function sets the speeds Dijkstra() has always used:
+*		   65 mph on interstates, 55 mph on everything else.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: The default speeds are set.
+************************************************************************/
+inline TravelTimeModel::TravelTimeModel()
+{
+	m_mph[ROAD_INTERSTATE] = 65;
+	m_mph[ROAD_HIGHWAY] = 55;
+	m_mph[ROAD_OTHER] = 55;
+}
+
+/**********************************************************************
+* Purpose: This function sets the speed of each road class.
+*
+* Precondition:	members were unassigned, every speed is above 0.
+*
+* Postcondition: The speeds are set.
+************************************************************************/
+inline TravelTimeModel::TravelTimeModel(double interstate, double highway, double other)
+{
+	SetSpeed(ROAD_INTERSTATE, interstate);
+	SetSpeed(ROAD_HIGHWAY, highway);
+	SetSpeed(ROAD_OTHER, other);
+}
+
+/**********************************************************************
+* Purpose: N/A
+*
+* Precondition:	N/A
+*
+* Postcondition: N/A
+************************************************************************/
+inline TravelTimeModel::~TravelTimeModel()
+{
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to copy the speeds.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: This has the speeds of copy.
+************************************************************************/
+inline TravelTimeModel::TravelTimeModel(const TravelTimeModel & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function copies the speeds of rhs.
+*
+* Precondition:	N/A
+*
+* Postcondition: This has the speeds of rhs.
+************************************************************************/
+inline TravelTimeModel & TravelTimeModel::operator=(const TravelTimeModel & rhs)
+{
+	if (this != &rhs)
+	{
+		for (int i = 0; i < ROAD_CLASS_COUNT; i++)
+		{
+			m_mph[i] = rhs.m_mph[i];
+		}
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function sets the speed on a road class.
+*
+* Precondition:	N/A
+*
+* Postcondition: The speed is set; throws if mph is not above 0.
+************************************************************************/
+inline void TravelTimeModel::SetSpeed(RoadClass road, double mph)
+{
+	if (!(mph > 0))
+	{
+		throw Exception("Speed must be above 0");
+	}
+	m_mph[road] = mph;
+}
+
+/**********************************************************************
+* Purpose: This function returns the speed on a road class.
+*
+* Precondition:	N/A
+*
+* Postcondition: The speed in mph is returned.
+************************************************************************/
+inline double TravelTimeModel::GetSpeed(RoadClass road) const
+{
+	return m_mph[road];
+}
+
+/**********************************************************************
+* Purpose: This function returns the minutes it takes to drive miles on
+*		   road, at the speed of the road's class.
+*
+* Precondition:	N/A
+*
+* Postcondition: The minutes are returned.
+************************************************************************/
+template<typename E>
+double TravelTimeModel::GetMinutes(const E & road, int miles) const
+{
+	return miles / m_mph[RoadTraits<E>::GetClass(road)] * 60;
+}
+
+/**********************************************************************
+* Purpose: This function returns GetMinutes() rounded to whole seconds,
+*		   the unit the searches add up.
+*
+* Precondition:	N/A
+*
+* Postcondition: The seconds are returned.
+************************************************************************/
+template<typename E>
+int TravelTimeModel::GetSeconds(const E & road, int miles) const
+{
+	return static_cast<int>(GetMinutes(road, miles) * 60 + 0.5);
+}
+
+/**********************************************************************
+* Purpose: This function returns the driving time of every edge of graph
+*		   in seconds, by edge id, to search by time instead of miles.
+*
+* Precondition:	N/A
+*
+* Postcondition: One cost per edge is returned.
+************************************************************************/
+template<typename V, typename E>
+vector<int> TravelTimeModel::EdgeSeconds(const CompactGraph<V, E> & graph) const
+{
+	vector<int> seconds(graph.GetEdgeCount());
+	for (int edge = 0; edge < graph.GetEdgeCount(); edge++)
+	{
+		seconds[edge] = GetSeconds(graph.GetEdgeData(edge), graph.GetWeight(edge));
+	}
+	return seconds;
+}
@@ -0,0 +1,623 @@
+/************************************************************************
+* Class: TurnTable
+*
+* Purpose: This class holds what it costs to turn from one road onto
+*		   another at a junction of a CompactGraph, and which turns are
+*		   not allowed at all. Turns are set by (incoming road, via
+*		   vertex, outgoing road), and every pair of edges at the via
+*		   vertex with those roads gets the cost. A turn that was never
+*		   set is free, except a U-turn back along the same road, which
+*		   costs GetUTurnCost().
+*
+*		   Turns are stored per via vertex, in one array like the
+*		   edges of a CompactGraph: the place of the incoming road and
+*		   of the outgoing road among the vertex's edges, and the cost,
+*		   8 bytes a turn. A vertex without turns costs one offset, so
+*		   a search only looks any further at junctions that have some.
+*
+*		   Route() searches edges instead of vertices where turns are
+*		   set: the distance of an edge is the cheapest way to arrive
+*		   along it, so the cost of the next turn is known when it is
+*		   relaxed. The edges of the CompactGraph are searched as they
+*		   are, never copied into a line graph, and junctions without
+*		   turns are searched as plain vertices.
+*
+* Manager functions
+*	TurnTable()
+*		Creates an empty table.
+*	~TurnTable()
+*		Clears the turns.
+*	TurnTable(const TurnTable & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const TurnTable & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	Build(const CompactGraph<V, E> & graph)
+*		Matches every edge with its reverse and removes every turn.
+*	SetTurn(const CompactGraph<V, E> & graph, int via, const E & from, const E & to, int cost)
+*		Sets the cost of turning from one road onto another at via.
+*	Read(const CompactGraph<string, string> & graph, const string & filename)
+*		Sets the turns listed in a file.
+*	Compile()
+*		Stores the turns set since the last Compile().
+*	SetUTurnCost(int cost) / GetUTurnCost()
+*		Sets / returns the cost of a U-turn that was not set.
+*	GetTurnCost(int via, int in, int out)
+*		Returns the cost of going from edge in onto edge out at via.
+*	GetTurnCount()
+*		Returns the number of turns stored.
+*	Route(const CompactGraph<V, E> & graph, const int * weights, int source, int target,
+*		  SearchWorkspace & workspace, vector<int> & path, vector<int> & edges, SearchStats * stats)
+*		Finds the cheapest route, turns included.
+*************************************************************************/
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "CompactGraph.h"
+#include "SearchWorkspace.h"
+#include "SearchStats.h"
+#include "Exception.h"
+using std::vector;
+using std::string;
+using std::ifstream;
+using std::getline;
+
+#pragma once
+#ifndef TURNTABLE_H
+#define TURNTABLE_H
+
+const int TURN_FORBIDDEN = -1;	//Cost of a turn that may not be taken
+
+class TurnTable
+{
+public:
+	TurnTable();
+	~TurnTable();
+	TurnTable(const TurnTable & copy);
+	TurnTable & operator=(const TurnTable & rhs);
+
+	template <typename V, typename E>
+	void Build(const CompactGraph<V, E> & graph);
+	template <typename V, typename E>
+	int SetTurn(const CompactGraph<V, E> & graph, int via, const E & from, const E & to, int cost);
+	int Read(const CompactGraph<string, string> & graph, const string & filename);
+	void Compile();
+	void SetUTurnCost(int cost);
+	int GetUTurnCost() const;
+	int GetTurnCost(int via, int in, int out) const;
+	int GetTurnCount() const;
+	template <typename V, typename E>
+	int Route(const CompactGraph<V, E> & graph, const int * weights, int source, int target, SearchWorkspace & workspace,
+		vector<int> & path, vector<int> & edges, SearchStats * stats = nullptr) const;
+
+private:
+	struct Turn
+	{
+		uint16_t in;	//Place of the incoming road's reverse edge among the via vertex's edges
+		uint16_t out;	//Place of the outgoing edge among the via vertex's edges
+		int cost;
+	};
+	struct PendingTurn
+	{
+		int via;
+		Turn turn;
+	};
+
+	vector<int> m_reverse;				//Edge id to the edge going back along the same road, NO_VERTEX if none
+	vector<int> m_edgeBegin;			//First edge id of each vertex, as in the graph
+	vector<int> m_turnBegin;			//Turns at vertex v are m_turns[begin[v] to begin[v + 1])
+	vector<Turn> m_turns;				//Sorted by incoming then outgoing place
+	vector<PendingTurn> m_pending;		//Set since the last Compile(), later ones win
+	int m_uTurnCost;
+
+	bool FindTurn(int via, int in, int out, int & cost) const;
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates an empty table.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: There are no turns; U-turns are free.
+************************************************************************/
+inline TurnTable::TurnTable() : m_uTurnCost(0)
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the turns.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are empty.
+************************************************************************/
+inline TurnTable::~TurnTable()
+{
+	m_reverse.clear();
+	m_edgeBegin.clear();
+	m_turnBegin.clear();
+	m_turns.clear();
+	m_pending.clear();
+	m_uTurnCost = 0;
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+inline TurnTable::TurnTable(const TurnTable & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+inline TurnTable & TurnTable::operator=(const TurnTable & rhs)
+{
+	if (this != &rhs)
+	{
+		m_reverse = rhs.m_reverse;
+		m_edgeBegin = rhs.m_edgeBegin;
+		m_turnBegin = rhs.m_turnBegin;
+		m_turns = rhs.m_turns;
+		m_pending = rhs.m_pending;
+		m_uTurnCost = rhs.m_uTurnCost;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function matches every edge of graph with the edge going
+*		   back along the same road, which is how an incoming road is
+*		   found among the edges of the vertex it arrives at. Parallel
+*		   roads are matched by road and weight.
+*
+* Precondition:	N/A
+*
+* Postcondition: The table fits graph and has no turns.
+************************************************************************/
+template<typename V, typename E>
+void TurnTable::Build(const CompactGraph<V, E> & graph)
+{
+	const int SIZE = graph.GetVertexCount();
+	const int * targets = graph.GetTargets();
+	const int * weights = graph.GetWeights();
+
+	m_reverse.assign(graph.GetEdgeCount(), NO_VERTEX);
+	m_edgeBegin.resize(SIZE + 1);
+	for (int v = 0; v < SIZE; v++)
+	{
+		m_edgeBegin[v] = graph.GetEdgeBegin(v);
+	}
+	m_edgeBegin[SIZE] = graph.GetEdgeCount();
+
+	for (int v = 0; v < SIZE; v++)
+	{
+		for (int edge = graph.GetEdgeBegin(v); edge != graph.GetEdgeEnd(v); ++edge)
+		{
+			int to = targets[edge];
+			for (int back = graph.GetEdgeBegin(to); back != graph.GetEdgeEnd(to) && m_reverse[edge] == NO_VERTEX; ++back)
+			{
+				if (targets[back] == v && m_reverse[back] == NO_VERTEX && back != edge && weights[back] == weights[edge]
+					&& graph.GetEdgeData(back) == graph.GetEdgeData(edge))
+				{
+					m_reverse[edge] = back;
+					m_reverse[back] = edge;
+				}
+			}
+		}
+	}
+
+	m_turnBegin.assign(SIZE + 1, 0);
+	m_turns.clear();
+	m_pending.clear();
+}
+
+/**********************************************************************
+* Purpose: This function sets the cost of turning from road from onto
+*		   road to at via, for every pair of via's edges on those roads.
+*		   from and to may be the same road, which sets the cost of
+*		   going straight on, or of a U-turn onto the same edge.
+*
+* Precondition:	Build() was called for graph; cost is 0 or more, or
+*				TURN_FORBIDDEN.
+*
+* Postcondition: The turns are set once Compile() is called; the number
+*				 of edge pairs they cover is returned.
+************************************************************************/
+template<typename V, typename E>
+int TurnTable::SetTurn(const CompactGraph<V, E> & graph, int via, const E & from, const E & to, int cost)
+{
+	int count = 0;
+
+	if (via < 0 || via >= graph.GetVertexCount() || m_edgeBegin.size() != static_cast<size_t>(graph.GetVertexCount() + 1))
+	{
+		throw Exception("Turn is not at a vertex of the graph");
+	}
+	if (cost < 0 && cost != TURN_FORBIDDEN)
+	{
+		throw Exception("Turn costs must be 0 or more");
+	}
+	if (graph.GetEdgeEnd(via) - graph.GetEdgeBegin(via) > UINT16_MAX)
+	{
+		throw Exception("Too many roads meet to hold turns");
+	}
+
+	for (int in = graph.GetEdgeBegin(via); in != graph.GetEdgeEnd(via); ++in)	//The reverse of each incoming edge
+	{
+		if (!(graph.GetEdgeData(in) == from))
+		{
+			continue;
+		}
+		for (int out = graph.GetEdgeBegin(via); out != graph.GetEdgeEnd(via); ++out)
+		{
+			if (graph.GetEdgeData(out) == to)
+			{
+				PendingTurn pending;
+				pending.via = via;
+				pending.turn.in = static_cast<uint16_t>(in - graph.GetEdgeBegin(via));
+				pending.turn.out = static_cast<uint16_t>(out - graph.GetEdgeBegin(via));
+				pending.turn.cost = cost;
+				m_pending.push_back(pending);
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+/**********************************************************************
+* Purpose: This function sets the turns listed in filename, one per line
+*		   as "from road,via,to road,cost", the same comma separated
+*		   form as the road file. A cost of "no" forbids the turn.
+*
+* Precondition:	Build() was called for graph.
+*
+* Postcondition: The turns are set and compiled; the number of lines
+*				 read is returned. Throws if the file can't be opened or
+*				 names a place that is not in graph.
+************************************************************************/
+inline int TurnTable::Read(const CompactGraph<string, string> & graph, const string & filename)
+{
+	ifstream in(filename.c_str());
+	string line;
+	int count = 0;
+
+	if (!in.is_open())
+	{
+		throw Exception("Error opening file!");
+	}
+	while (getline(in, line))
+	{
+		size_t first = line.find(',');
+		size_t second = first == string::npos ? string::npos : line.find(',', first + 1);
+		size_t third = second == string::npos ? string::npos : line.find(',', second + 1);
+		if (third == string::npos)
+		{
+			continue;	//Blank or not a turn
+		}
+
+		int via = graph.FindIndex(line.substr(first + 1, second - first - 1));
+		if (via == NO_VERTEX)
+		{
+			throw Exception("Turn file names a place not in the graph");
+		}
+		string cost = line.substr(third + 1);
+		SetTurn(graph, via, line.substr(0, first), line.substr(second + 1, third - second - 1),
+			cost == "no" ? TURN_FORBIDDEN : atoi(cost.c_str()));
+		count++;
+	}
+	Compile();
+	return count;
+}
+
+/**********************************************************************
+* Purpose: This function stores the turns set since the last Compile(),
+*		   merging them with the ones stored. A turn set twice keeps the
+*		   cost it was set to last.
+*
+* Precondition:	Build() was called.
+*
+* Postcondition: Every turn set is stored, sorted by via vertex, then by
+*				 incoming and outgoing place.
+************************************************************************/
+inline void TurnTable::Compile()
+{
+	const int SIZE = static_cast<int>(m_turnBegin.size()) - 1;
+	vector<PendingTurn> all;
+
+	if (m_pending.empty())
+	{
+		return;
+	}
+	all.reserve(m_turns.size() + m_pending.size());
+	for (int v = 0; v < SIZE; v++)	//Stored turns come before every pending one
+	{
+		for (int i = m_turnBegin[v]; i < m_turnBegin[v + 1]; i++)
+		{
+			PendingTurn stored;
+			stored.via = v;
+			stored.turn = m_turns[i];
+			all.push_back(stored);
+		}
+	}
+	all.insert(all.end(), m_pending.begin(), m_pending.end());
+	std::stable_sort(all.begin(), all.end(), [](const PendingTurn & a, const PendingTurn & b)
+	{
+		if (a.via != b.via)
+		{
+			return a.via < b.via;
+		}
+		return a.turn.in != b.turn.in ? a.turn.in < b.turn.in : a.turn.out < b.turn.out;
+	});
+
+	m_turns.clear();
+	m_turnBegin.assign(SIZE + 1, 0);
+	for (size_t i = 0; i < all.size(); i++)
+	{
+		bool sameAsNext = i + 1 < all.size() && all[i + 1].via == all[i].via && all[i + 1].turn.in == all[i].turn.in
+			&& all[i + 1].turn.out == all[i].turn.out;
+		if (!sameAsNext)	//The last of equal turns was set last
+		{
+			m_turns.push_back(all[i].turn);
+			m_turnBegin[all[i].via + 1]++;
+		}
+	}
+	for (int v = 0; v < SIZE; v++)
+	{
+		m_turnBegin[v + 1] += m_turnBegin[v];
+	}
+	m_pending.clear();
+	m_pending.shrink_to_fit();
+}
+
+/**********************************************************************
+* Purpose: This function sets the cost of a U-turn that was not set with
+*		   SetTurn(). TURN_FORBIDDEN keeps routes from doubling back.
+*
+* Precondition:	cost is 0 or more, or TURN_FORBIDDEN.
+*
+* Postcondition: The cost is set.
+************************************************************************/
+inline void TurnTable::SetUTurnCost(int cost)
+{
+	if (cost < 0 && cost != TURN_FORBIDDEN)
+	{
+		throw Exception("Turn costs must be 0 or more");
+	}
+	m_uTurnCost = cost;
+}
+
+/**********************************************************************
+* Purpose: This function returns the cost of a U-turn that was not set.
+*
+* Precondition:	N/A
+*
+* Postcondition: The cost is returned.
+************************************************************************/
+inline int TurnTable::GetUTurnCost() const
+{
+	return m_uTurnCost;
+}
+
+/**********************************************************************
+* Purpose: This function returns the cost of arriving at via along edge
+*		   in and leaving along edge out.
+*
+* Precondition:	in ends at via, out starts at via, Compile() was called.
+*
+* Postcondition: The cost, or TURN_FORBIDDEN, is returned.
+************************************************************************/
+inline int TurnTable::GetTurnCost(int via, int in, int out) const
+{
+	int cost = 0;
+
+	if (m_turnBegin[via] == m_turnBegin[via + 1] || !FindTurn(via, in, out, cost))
+	{
+		cost = out == m_reverse[in] ? m_uTurnCost : 0;
+	}
+	return cost;
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of turns stored.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int TurnTable::GetTurnCount() const
+{
+	return static_cast<int>(m_turns.size());
+}
+
+/**********************************************************************
+* Purpose: This function finds the cheapest route from source to target
+*		   with the cost of every turn added. At a junction with turns
+*		   where a route goes next depends on the edge it came in on, so
+*		   there the search keeps one state per incoming edge; every
+*		   other vertex has one state, as in Dijkstra, which keeps a
+*		   table with few turns close to the speed of a plain search.
+*		   States are vertex v for v, and GetVertexCount() + e for edge
+*		   e into a junction with turns. The first state at target to be
+*		   settled ends the search.
+*
+* Precondition:	Build() and Compile() were called for graph; weights
+*				holds a weight of 0 or more per edge id.
+*
+* Postcondition: path holds the vertices and edges the edge ids from
+*				 source to target (both empty if there is no route) and
+*				 the cost is returned, INFINITE_DISTANCE if there is no
+*				 route.
+************************************************************************/
+template<typename V, typename E>
+int TurnTable::Route(const CompactGraph<V, E> & graph, const int * weights, int source, int target, SearchWorkspace & workspace,
+	vector<int> & path, vector<int> & edges, SearchStats * stats) const
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (target < 0 || target >= graph.GetVertexCount())
+	{
+		throw Exception("Ending vertex is not in the graph!");
+	}
+	if (m_reverse.size() != static_cast<size_t>(graph.GetEdgeCount()) || !m_pending.empty())
+	{
+		throw Exception("Turn table is not built and compiled for the graph");
+	}
+
+	const int SIZE = graph.GetVertexCount();
+	const int * targets = graph.GetTargets();
+	const int * turnBegin = m_turnBegin.data();
+	const bool EVERY = m_uTurnCost != 0;	//A U-turn can cost anywhere, so every vertex has turns
+	int found = NO_VERTEX;	//State the route ends in
+	int cost = INFINITE_DISTANCE;
+	SearchStats counts;
+	counts.searchSeconds -= StatsClock();
+
+	path.clear();
+	edges.clear();
+	workspace.Prepare(SIZE + graph.GetEdgeCount());
+	int * distance = workspace.GetDistances();
+	int * pred = workspace.GetPreds();
+	char * done = workspace.GetDone();
+	RadixHeap<int> & heap = workspace.GetQueue();
+
+	if (source == target || graph.MayConnect(source, target))
+	{
+		workspace.Touch(source);
+		distance[source] = 0;
+		heap.Push(0, source);
+		STATS_ADD(counts.pushes, 1);
+	}
+
+	//************************** Search the states **********************************
+	while (!heap.IsEmpty())
+	{
+		int dist = heap.GetTopKey();
+		int state = heap.GetTopVertex();
+		heap.Pop();
+		STATS_ADD(counts.pops, 1);
+		if (dist != distance[state] || done[state])
+		{
+			continue;
+		}
+		done[state] = 1;
+		STATS_ADD(counts.settled, 1);
+
+		int in = state < SIZE ? NO_VERTEX : state - SIZE;	//Edge arrived along, if it matters here
+		int via = in == NO_VERTEX ? state : targets[in];
+		if (via == target)
+		{
+			found = state;
+			cost = dist;
+			break;
+		}
+		for (int out = graph.GetEdgeBegin(via); out != graph.GetEdgeEnd(via); ++out)
+		{
+			int turn = in == NO_VERTEX ? 0 : GetTurnCost(via, in, out);
+			STATS_ADD(counts.relaxed, 1);
+			if (turn == TURN_FORBIDDEN)
+			{
+				continue;
+			}
+			int to = targets[out];
+			int next = dist + turn + weights[out];
+			int reached = EVERY || turnBegin[to] != turnBegin[to + 1] ? SIZE + out : to;
+			if (next < distance[reached])
+			{
+				if (distance[reached] == INFINITE_DISTANCE)
+				{
+					workspace.Touch(reached);
+				}
+				distance[reached] = next;
+				pred[reached] = state;
+				heap.Push(next, reached);
+				STATS_ADD(counts.pushes, 1);
+			}
+		}
+	}
+	heap.Clear();
+	counts.searchSeconds += StatsClock();
+	counts.reconstructSeconds -= StatsClock();
+
+	//************************** Walk back the states **********************************
+	for (int state = found; state != NO_VERTEX && pred[state] != NO_VERTEX; state = pred[state])
+	{
+		int from = pred[state];
+		int in = from < SIZE ? NO_VERTEX : from - SIZE;
+		int via = in == NO_VERTEX ? from : targets[in];
+		int edge = state - SIZE;
+		for (int out = graph.GetEdgeBegin(via); out != graph.GetEdgeEnd(via) && edge < 0; ++out)	//Which edge reached a vertex state
+		{
+			int turn = in == NO_VERTEX ? 0 : GetTurnCost(via, in, out);
+			if (targets[out] == state && turn != TURN_FORBIDDEN && distance[from] + turn + weights[out] == distance[state])
+			{
+				edge = out;
+			}
+		}
+		edges.push_back(edge);
+	}
+	if (cost != INFINITE_DISTANCE)
+	{
+		std::reverse(edges.begin(), edges.end());
+		path.push_back(source);
+		for (size_t i = 0; i < edges.size(); i++)
+		{
+			path.push_back(targets[edges[i]]);
+		}
+	}
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.reconstructSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+	return cost;
+}
+
+/**********************************************************************
+* Purpose: This function looks up the turn from edge in onto edge out at
+*		   via among the turns stored there.
+*
+* Precondition:	in ends at via, out starts at via.
+*
+* Postcondition: true is returned and cost set if the turn was set.
+************************************************************************/
+inline bool TurnTable::FindTurn(int via, int in, int out, int & cost) const
+{
+	int back = m_reverse[in];
+	bool found = false;
+
+	if (back != NO_VERTEX)
+	{
+		uint16_t inPlace = static_cast<uint16_t>(back - m_edgeBegin[via]);
+		uint16_t outPlace = static_cast<uint16_t>(out - m_edgeBegin[via]);
+		for (int i = m_turnBegin[via]; i < m_turnBegin[via + 1] && !found; i++)
+		{
+			if (m_turns[i].in == inPlace && m_turns[i].out == outPlace)
+			{
+				cost = m_turns[i].cost;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
@@ -0,0 +1,386 @@
+/************************************************************************
+* Class: VehicleProfiles
+*
+* Purpose: This class holds named weight columns (profiles) for the
+*		   edges of one CompactGraph: miles, and the driving time of a
+*		   car, a truck or a bus, each from its own TravelTimeModel. The
+*		   graph's vertices and adjacency are shared by every profile;
+*		   a profile is one contiguous array of 4 bytes per edge, by
+*		   edge id, so it costs no more memory than its weights, and a
+*		   query picks one by id for free: the engines that take a
+*		   weight array (CellOverlay, TurnTable, KShortestRoutes,
+*		   ReachableWithin...) take GetWeights(profile), and
+*		   GetView(graph, profile) gives the ForEachEdge engines the
+*		   graph with the profile's weights.
+*
+*		   A column's address never changes once it is added, so a
+*		   CellOverlay customized for it, or a query running on it,
+*		   stays valid while other profiles are added.
+*
+* Manager functions
+*	VehicleProfiles()
+*		Creates a set with no profiles.
+*	~VehicleProfiles()
+*		Clears the profiles.
+*	VehicleProfiles(const VehicleProfiles & copy)
+*		Calls op= to handle the assignment of the copy.
+*	operator=(const VehicleProfiles & rhs)
+*		Sets this to rhs, and all of its data members
+*
+* Methods:
+*	AddProfile(const string & name, const int * weights, int count)
+*		Adds a profile with a copy of count weights.
+*	AddProfile(const string & name, const CompactGraph<V, E> & graph, const TravelTimeModel & model)
+*		Adds a profile of the seconds model takes on each edge.
+*	AddDefaultProfiles(const CompactGraph<V, E> & graph)
+*		Adds "miles", "car", "truck" and "bus".
+*	FindProfile(const string & name) / GetProfile(const string & name)
+*		Returns the id of a profile, NO_VERTEX or a throw if it is missing.
+*	GetName(int profile) / GetWeights(int profile)
+*		Returns a profile's name or its weight column.
+*	GetProfileCount() / GetEdgeCount()
+*		Returns the number of profiles and of weights in each.
+*	GetView(const CompactGraph<V, E> & graph, int profile)
+*		Returns graph with the profile's weights, for ForEachEdge engines.
+*	Route(const CompactGraph<V, E> & graph, int profile, int source, int target, ...)
+*		Finds the cheapest route for a profile.
+*************************************************************************/
+#include <vector>
+#include <string>
+#include "CompactGraph.h"
+#include "TravelTimeModel.h"
+#include "ShortestPaths.h"
+#include "SearchWorkspace.h"
+#include "SearchStats.h"
+#include "Exception.h"
+using std::vector;
+using std::string;
+
+#pragma once
+#ifndef VEHICLEPROFILES_H
+#define VEHICLEPROFILES_H
+
+class VehicleProfiles
+{
+public:
+	/************************************************************************
+	* Class: View
+	*
+	* Purpose: A CompactGraph read with one profile's weights. It only
+	*		   points to the graph and the column.
+	*************************************************************************/
+	template <typename V, typename E>
+	class View
+	{
+	public:
+		View(const CompactGraph<V, E> & graph, const int * weights) : m_graph(&graph), m_weights(weights) {}
+		int GetVertexCount() const { return m_graph->GetVertexCount(); }
+		template <typename Visit>
+		void ForEachEdge(int index, Visit visit) const
+		{
+			const int * targets = m_graph->GetTargets();
+			for (int edge = m_graph->GetEdgeBegin(index); edge != m_graph->GetEdgeEnd(index); ++edge)
+			{
+				visit(edge, targets[edge], m_weights[edge]);
+			}
+		}
+
+	private:
+		const CompactGraph<V, E> * m_graph;	//Vertices and adjacency
+		const int * m_weights;				//Weight of each edge id
+	};
+
+	VehicleProfiles();
+	~VehicleProfiles();
+	VehicleProfiles(const VehicleProfiles & copy);
+	VehicleProfiles & operator=(const VehicleProfiles & rhs);
+
+	int AddProfile(const string & name, const int * weights, int count);
+	template <typename V, typename E>
+	int AddProfile(const string & name, const CompactGraph<V, E> & graph, const TravelTimeModel & model);
+	template <typename V, typename E>
+	void AddDefaultProfiles(const CompactGraph<V, E> & graph);
+	int FindProfile(const string & name) const;
+	int GetProfile(const string & name) const;
+	const string & GetName(int profile) const;
+	const int * GetWeights(int profile) const;
+	int GetProfileCount() const;
+	int GetEdgeCount() const;
+	template <typename V, typename E>
+	View<V, E> GetView(const CompactGraph<V, E> & graph, int profile) const;
+	template <typename V, typename E>
+	int Route(const CompactGraph<V, E> & graph, int profile, int source, int target, SearchWorkspace & workspace,
+		vector<int> & path, vector<int> & edges, SearchStats * stats = nullptr) const;
+
+private:
+	vector<string> m_names;				//Name of each profile
+	vector<vector<int>> m_columns;		//Weights of each profile, by edge id
+	int m_edgeCount;					//Weights in every column, NO_VERTEX before the first
+};
+#endif
+
+/**********************************************************************
+* Purpose: This function creates a set with no profiles.
+*
+* Precondition:	members were unassigned.
+*
+* Postcondition: There are no profiles.
+************************************************************************/
+inline VehicleProfiles::VehicleProfiles()
+	: m_edgeCount(NO_VERTEX)
+{
+}
+
+/**********************************************************************
+* Purpose: This function clears the profiles.
+*
+* Precondition:	members may be assigned.
+*
+* Postcondition: members are empty.
+************************************************************************/
+inline VehicleProfiles::~VehicleProfiles()
+{
+	m_names.clear();
+	m_columns.clear();
+	m_edgeCount = NO_VERTEX;
+}
+
+/**********************************************************************
+* Purpose: This function calls op= to handle the assignment of the copy.
+*
+* Precondition:	copy's members were unassigned.
+*
+* Postcondition: copy's members are assigned.
+************************************************************************/
+inline VehicleProfiles::VehicleProfiles(const VehicleProfiles & copy)
+{
+	*this = copy;
+}
+
+/**********************************************************************
+* Purpose: This function sets this's members to rhs's members
+*
+* Precondition:	rhs members were unassigned.
+*
+* Postcondition: rhs members are assigned.
+************************************************************************/
+inline VehicleProfiles & VehicleProfiles::operator=(const VehicleProfiles & rhs)
+{
+	if (this != &rhs)
+	{
+		m_names = rhs.m_names;
+		m_columns = rhs.m_columns;
+		m_edgeCount = rhs.m_edgeCount;
+	}
+	return *this;
+}
+
+/**********************************************************************
+* Purpose: This function adds a profile with a copy of count weights,
+*		   one per edge id.
+*
+* Precondition:	Every weight is 0 or more.
+*
+* Postcondition: The profile's id is returned; throws if the name is
+*				 taken or count doesn't match the other profiles.
+************************************************************************/
+inline int VehicleProfiles::AddProfile(const string & name, const int * weights, int count)
+{
+	if (FindProfile(name) != NO_VERTEX)
+	{
+		throw Exception("There is already a profile with that name");
+	}
+	if (count < 0 || (m_edgeCount != NO_VERTEX && count != m_edgeCount))
+	{
+		throw Exception("Profile does not match the graph");
+	}
+
+	m_edgeCount = count;
+	m_names.push_back(name);
+	m_columns.push_back(vector<int>(weights, weights + count));
+	return static_cast<int>(m_columns.size()) - 1;
+}
+
+/**********************************************************************
+* Purpose: This function adds a profile of the seconds model takes to
+*		   drive each edge of graph.
+*
+* Precondition:	N/A
+*
+* Postcondition: The profile's id is returned; throws as AddProfile().
+************************************************************************/
+template<typename V, typename E>
+int VehicleProfiles::AddProfile(const string & name, const CompactGraph<V, E> & graph, const TravelTimeModel & model)
+{
+	vector<int> seconds = model.EdgeSeconds(graph);
+	return AddProfile(name, seconds.data(), static_cast<int>(seconds.size()));
+}
+
+/**********************************************************************
+* Purpose: This function adds the profiles the program routes with:
+*		   "miles", the graph's own weights, and the driving time of a
+*		   "car" (65 mph on interstates, 55 elsewhere, as Dijkstra() has
+*		   always assumed), a "truck" (60, 55, 45) and a "bus"
+*		   (60, 50, 40), in seconds.
+*
+* Precondition:	None of the names are taken.
+*
+* Postcondition: The four profiles are added.
+************************************************************************/
+template<typename V, typename E>
+void VehicleProfiles::AddDefaultProfiles(const CompactGraph<V, E> & graph)
+{
+	AddProfile("miles", graph.GetWeights(), graph.GetEdgeCount());
+	AddProfile("car", graph, TravelTimeModel());
+	AddProfile("truck", graph, TravelTimeModel(60, 55, 45));
+	AddProfile("bus", graph, TravelTimeModel(60, 50, 40));
+}
+
+/**********************************************************************
+* Purpose: This function returns the id of a profile.
+*
+* Precondition:	N/A
+*
+* Postcondition: The id is returned, NO_VERTEX if there is no profile
+*				 with that name.
+************************************************************************/
+inline int VehicleProfiles::FindProfile(const string & name) const
+{
+	for (size_t i = 0; i < m_names.size(); i++)
+	{
+		if (m_names[i] == name)
+		{
+			return static_cast<int>(i);
+		}
+	}
+	return NO_VERTEX;
+}
+
+/**********************************************************************
+* Purpose: This function returns the id of a profile that must exist.
+*
+* Precondition:	N/A
+*
+* Postcondition: The id is returned; throws if there is no profile with
+*				 that name.
+************************************************************************/
+inline int VehicleProfiles::GetProfile(const string & name) const
+{
+	int profile = FindProfile(name);
+	if (profile == NO_VERTEX)
+	{
+		throw Exception("There is no such profile");
+	}
+	return profile;
+}
+
+/**********************************************************************
+* Purpose: This function returns the name of a profile.
+*
+* Precondition:	profile is below GetProfileCount().
+*
+* Postcondition: The name is returned.
+************************************************************************/
+inline const string & VehicleProfiles::GetName(int profile) const
+{
+	return m_names[profile];
+}
+
+/**********************************************************************
+* Purpose: This function returns the weight column of a profile, for
+*		   the engines that take a weight array.
+*
+* Precondition:	profile is below GetProfileCount().
+*
+* Postcondition: GetEdgeCount() weights are returned, by edge id.
+************************************************************************/
+inline const int * VehicleProfiles::GetWeights(int profile) const
+{
+	return m_columns[profile].data();
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of profiles.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned.
+************************************************************************/
+inline int VehicleProfiles::GetProfileCount() const
+{
+	return static_cast<int>(m_columns.size());
+}
+
+/**********************************************************************
+* Purpose: This function returns the number of weights in each profile.
+*
+* Precondition:	N/A
+*
+* Postcondition: The count is returned, 0 if there are no profiles.
+************************************************************************/
+inline int VehicleProfiles::GetEdgeCount() const
+{
+	return m_edgeCount == NO_VERTEX ? 0 : m_edgeCount;
+}
+
+/**********************************************************************
+* Purpose: This function returns graph read with a profile's weights,
+*		   which ShortestRouteOver() and the other ForEachEdge engines
+*		   search like the graph itself.
+*
+* Precondition:	profile is below GetProfileCount(); graph outlives the
+*				view.
+*
+* Postcondition: The view is returned; throws if the profile was not
+*				 made for a graph of this many edges.
+************************************************************************/
+template<typename V, typename E>
+VehicleProfiles::View<V, E> VehicleProfiles::GetView(const CompactGraph<V, E> & graph, int profile) const
+{
+	if (profile < 0 || profile >= GetProfileCount())
+	{
+		throw Exception("There is no such profile");
+	}
+	if (graph.GetEdgeCount() != m_edgeCount)
+	{
+		throw Exception("Profile does not match the graph");
+	}
+	return View<V, E>(graph, GetWeights(profile));
+}
+
+/**********************************************************************
+* Purpose: This function finds the cheapest route from source to target
+*		   by a profile's weights, stopping once target is settled.
+*		   Between two stops the edge cheapest for the profile is used.
+*
+* Precondition:	profile is below GetProfileCount().
+*
+* Postcondition: path holds the stops and edges the edge ids between
+*				 them (both empty if target can't be reached), and the
+*				 cost in the profile's unit is returned, or
+*				 INFINITE_DISTANCE.
+************************************************************************/
+template<typename V, typename E>
+int VehicleProfiles::Route(const CompactGraph<V, E> & graph, int profile, int source, int target, SearchWorkspace & workspace,
+	vector<int> & path, vector<int> & edges, SearchStats * stats) const
+{
+	View<V, E> view = GetView(graph, profile);
+	const int * weights = GetWeights(profile);
+	const int * targets = graph.GetTargets();
+	int cost = ShortestRouteOver(view, source, target, workspace, path, stats);
+
+	edges.clear();
+	for (size_t i = 1; i < path.size(); i++)
+	{
+		int best = NO_VERTEX;
+		for (int edge = graph.GetEdgeBegin(path[i - 1]); edge != graph.GetEdgeEnd(path[i - 1]); ++edge)
+		{
+			if (targets[edge] == path[i] && (best == NO_VERTEX || weights[edge] < weights[best]))
+			{
+				best = edge;
+			}
+		}
+		edges.push_back(best);
+	}
+	return cost;
+}
@@ -42,10 +42,11 @@ public:
 	Vertex(const Vertex<V, E> & copy);
 	const Vertex<V, E> & operator=(const Vertex<V, E> & rhs);
 
-	V GetData();
+	const V & GetData() const;
 	bool GetProcessed();
 	void SetProcessed(bool process);
 	list<Edge<V, E>> & GetEdges();
+	const list<Edge<V, E>> & GetEdges() const;
 
 private:
 	V m_data;
@@ -135,7 +136,7 @@ inline const Vertex<V, E>& Vertex<V, E>::operator=(const Vertex<V, E>& rhs)
 * Postcondition: data of the vertex is returned.
 ************************************************************************/
 template<typename V, typename E>
-inline V Vertex<V, E>::GetData()
+inline const V & Vertex<V, E>::GetData() const
 {
 	return m_data;
 }
@@ -178,3 +179,9 @@ inline list<Edge<V, E>> & Vertex<V, E>::GetEdges()
 {
 	return m_edges;
 }
+
+template<typename V, typename E>
+inline const list<Edge<V, E>> & Vertex<V, E>::GetEdges() const
+{
+	return m_edges;
+}
@@ -0,0 +1,126 @@
+/*************************************************************
+* Filename:		VertexKey.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Everything the algorithms need to know about the vertex data
+*	type V, so they don't assume it is a string.
+*
+*	KeyTraits<V>::None() is the "no vertex" value used in
+*	predecessor arrays ("-1" for strings, the largest value for
+*	integer ids).
+*
+*	IndexMap<V> maps vertex data to a 0..n-1 index. Strings go
+*	through a map; integer ids are expected to be dense (see
+*	NameTable) and are looked up in a plain array.
+**************************************************************/
+#include <vector>
+#include <map>
+#include <string>
+#include <limits>
+#include <type_traits>
+using std::vector;
+using std::map;
+using std::string;
+using std::numeric_limits;
+
+#pragma once
+#ifndef VERTEXKEY_H
+#define VERTEXKEY_H
+
+/************************************************************************
+* Class: KeyTraits
+*
+* Purpose: Gives the sentinel value for a vertex data type.
+*************************************************************************/
+template <typename V, bool Integral = std::is_integral<V>::value>
+struct KeyTraits
+{
+	static V None() { return V(); }
+};
+
+template <typename V>
+struct KeyTraits<V, true>
+{
+	static V None() { return numeric_limits<V>::max(); }
+};
+
+template <>
+struct KeyTraits<string, false>
+{
+	static string None() { return "-1"; }
+};
+
+/************************************************************************
+* Class: IndexMap
+*
+* Purpose: Maps vertex data to its index. The general version uses a map.
+*
+* Methods:
+*	Set(const V & key, int index)
+*		Stores the index of key.
+*	Find(const V & key)
+*		Returns the index of key, or -1 if it isn't there.
+*	Clear()
+*		Removes every key.
+*************************************************************************/
+template <typename V, bool Integral = std::is_integral<V>::value>
+class IndexMap
+{
+public:
+	void Set(const V & key, int index)
+	{
+		m_index[key] = index;
+	}
+
+	int Find(const V & key) const
+	{
+		typename map<V, int>::const_iterator found = m_index.find(key);
+		return found == m_index.end() ? -1 : found->second;
+	}
+
+	void Clear()
+	{
+		m_index.clear();
+	}
+
+private:
+	map<V, int> m_index;
+};
+
+/************************************************************************
+* Class: IndexMap (integer ids)
+*
+* Purpose: Maps dense integer ids to their index with a single array read,
+*		   so integer keyed graphs never search or compare strings.
+*************************************************************************/
+template <typename V>
+class IndexMap<V, true>
+{
+public:
+	void Set(const V & key, int index)
+	{
+		size_t slot = static_cast<size_t>(key);
+		if (slot >= m_index.size())
+		{
+			m_index.resize(slot + 1, -1);
+		}
+		m_index[slot] = index;
+	}
+
+	int Find(const V & key) const
+	{
+		size_t slot = static_cast<size_t>(key);
+		return slot < m_index.size() ? m_index[slot] : -1;
+	}
+
+	void Clear()
+	{
+		m_index.clear();
+	}
+
+private:
+	vector<int> m_index;	//Id to index, -1 for ids that aren't in the graph
+};
+#endif
@@ -0,0 +1,318 @@
+/*************************************************************
+* Filename:		Visitor.h
+* Date Created:	10/19/26
+* Modifications:
+*
+* Overview:
+*	Traversals and a shortest path search on a CompactGraph that
+*	call back into a visitor at each step, so callers can stop
+*	early, count, or filter edges without changing the search.
+*	The visitor is a template parameter, so every call is known
+*	at compile time and inlined; nothing goes through a function
+*	pointer and vertices are passed as indices, not copied data.
+*
+*	A visitor has these four events, which SearchVisitor gives
+*	empty defaults for:
+*		Discover(vertex, cost)		- vertex is reached the first time
+*		ExamineEdge(from, edge)		- edge is about to be followed;
+*									  return false to skip it
+*		Relax(from, edge, to, cost)	- edge gave to a better cost
+*									  (a tree edge, for the traversals)
+*		Finish(vertex, cost)		- every edge of vertex was examined;
+*									  return false to stop the search
+*	cost is the hop count for VisitBreadthFirst(), the depth in the
+*	tree for VisitDepthFirst() and the distance for
+*	VisitShortestPaths().
+*
+*	MakeVisitor(discover, examine, relax, finish) builds a visitor
+*	out of four lambdas; IgnoreEvent() fills the ones not needed.
+*	Events that can return false may also return nothing, which
+*	means keep going.
+**************************************************************/
+#include <vector>
+#include <type_traits>
+#include <utility>
+#include "CompactGraph.h"
+#include "SearchWorkspace.h"
+#include "Bitmap.h"
+#include "Exception.h"
+using std::vector;
+
+#pragma once
+#ifndef VISITOR_H
+#define VISITOR_H
+
+/************************************************************************
+* Class: SearchVisitor
+*
+* Purpose: A visitor that does nothing at every event. Derive from it and
+*		   hide the events you need.
+*************************************************************************/
+struct SearchVisitor
+{
+	void Discover(int, int) {}
+	bool ExamineEdge(int, int) { return true; }
+	void Relax(int, int, int, int) {}
+	bool Finish(int, int) { return true; }
+};
+
+/************************************************************************
+* Class: IgnoreEvent
+*
+* Purpose: Placeholder for an event MakeVisitor() should not handle.
+*************************************************************************/
+struct IgnoreEvent
+{
+	template <typename... Args>
+	void operator()(Args...) const {}
+};
+
+/************************************************************************
+* Class: LambdaVisitor
+*
+* Purpose: A visitor that forwards each event to a callable. Events that
+*		   can stop or skip treat a callable returning void as true.
+*************************************************************************/
+template <typename OnDiscover, typename OnExamine, typename OnRelax, typename OnFinish>
+class LambdaVisitor
+{
+public:
+	LambdaVisitor(OnDiscover discover, OnExamine examine, OnRelax relax, OnFinish finish)
+		: m_discover(discover), m_examine(examine), m_relax(relax), m_finish(finish) {}
+
+	void Discover(int vertex, int cost) { m_discover(vertex, cost); }
+	bool ExamineEdge(int from, int edge) { return Call(m_examine, from, edge); }
+	void Relax(int from, int edge, int to, int cost) { m_relax(from, edge, to, cost); }
+	bool Finish(int vertex, int cost) { return Call(m_finish, vertex, cost); }
+
+private:
+	template <typename F>
+	static bool Call(F & f, int first, int second)
+	{
+		return Result(f, first, second, typename std::is_void<decltype(f(first, second))>::type());
+	}
+	template <typename F>
+	static bool Result(F & f, int first, int second, std::true_type) { f(first, second); return true; }
+	template <typename F>
+	static bool Result(F & f, int first, int second, std::false_type) { return f(first, second); }
+
+	OnDiscover m_discover;
+	OnExamine m_examine;
+	OnRelax m_relax;
+	OnFinish m_finish;
+};
+
+template <typename Discover, typename Examine, typename Relax, typename Finish>
+LambdaVisitor<Discover, Examine, Relax, Finish> MakeVisitor(Discover discover, Examine examine, Relax relax,
+	Finish finish);	//Visitor from four callables
+
+template <typename V, typename E, typename Visitor>
+void VisitBreadthFirst(const CompactGraph<V, E> & graph, int source, Visitor && visitor);	//Breadth first from source
+
+template <typename V, typename E, typename Visitor>
+void VisitDepthFirst(const CompactGraph<V, E> & graph, int source, Visitor && visitor);	//Depth first from source
+
+template <typename V, typename E, typename Visitor>
+void VisitShortestPaths(const CompactGraph<V, E> & graph, const int * weights, int source, SearchWorkspace & workspace,
+	Visitor && visitor);	//Dijkstra from source
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************************
+* Purpose: This function builds a visitor from four callables, taking
+*		   (vertex, cost), (from, edge), (from, edge, to, cost) and
+*		   (vertex, cost).
+*
+* Precondition:	N/A
+*
+* Postcondition: The visitor is returned.
+************************************************************************/
+template<typename Discover, typename Examine, typename Relax, typename Finish>
+LambdaVisitor<Discover, Examine, Relax, Finish> MakeVisitor(Discover discover, Examine examine, Relax relax, Finish finish)
+{
+	return LambdaVisitor<Discover, Examine, Relax, Finish>(discover, examine, relax, finish);
+}
+
+/**********************************************************************
+* Purpose: This function visits what source can reach, breadth first.
+*		   A vertex is discovered when it is queued, so it is queued
+*		   once, and finished when it comes off the queue.
+*
+* Precondition:	source is a valid index of graph.
+*
+* Postcondition: The visitor saw every reachable vertex, or the search
+*				 stopped when Finish returned false.
+************************************************************************/
+template<typename V, typename E, typename Visitor>
+void VisitBreadthFirst(const CompactGraph<V, E> & graph, int source, Visitor && visitor)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+
+	const int * targets = graph.GetTargets();
+	Bitmap seen(graph.GetVertexCount());
+	vector<int> queue;
+	vector<int> hops;
+
+	seen.Set(source);
+	queue.push_back(source);
+	hops.push_back(0);
+	visitor.Discover(source, 0);
+	for (size_t next = 0; next < queue.size(); next++)
+	{
+		int from = queue[next];
+		for (int edge = graph.GetEdgeBegin(from); edge != graph.GetEdgeEnd(from); ++edge)
+		{
+			int to = targets[edge];
+			if (visitor.ExamineEdge(from, edge) && !seen.Test(to))
+			{
+				seen.Set(to);
+				queue.push_back(to);
+				hops.push_back(hops[next] + 1);
+				visitor.Relax(from, edge, to, hops[next] + 1);
+				visitor.Discover(to, hops[next] + 1);
+			}
+		}
+		if (!visitor.Finish(from, hops[next]))
+		{
+			return;
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function visits what source can reach, depth first. A
+*		   vertex is discovered when the walk first gets to it and
+*		   finished when the walk backs out of it, so every vertex below
+*		   it in the tree finishes first.
+*
+* Precondition:	source is a valid index of graph.
+*
+* Postcondition: The visitor saw every reachable vertex, or the search
+*				 stopped when Finish returned false.
+************************************************************************/
+template<typename V, typename E, typename Visitor>
+void VisitDepthFirst(const CompactGraph<V, E> & graph, int source, Visitor && visitor)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+
+	const int * targets = graph.GetTargets();
+	Bitmap seen(graph.GetVertexCount());
+	vector<std::pair<int, int> > path;	//Vertex and its next edge to follow, source to current
+
+	seen.Set(source);
+	path.push_back(std::make_pair(source, graph.GetEdgeBegin(source)));
+	visitor.Discover(source, 0);
+	while (!path.empty())
+	{
+		int from = path.back().first;
+		int depth = static_cast<int>(path.size()) - 1;
+		int & edge = path.back().second;
+
+		while (edge != graph.GetEdgeEnd(from) && !(visitor.ExamineEdge(from, edge) && !seen.Test(targets[edge])))
+		{
+			++edge;
+		}
+		if (edge == graph.GetEdgeEnd(from))
+		{
+			path.pop_back();
+			if (!visitor.Finish(from, depth))
+			{
+				return;
+			}
+		}
+		else
+		{
+			int to = targets[edge];
+			seen.Set(to);
+			visitor.Relax(from, edge, to, depth + 1);
+			visitor.Discover(to, depth + 1);
+			++edge;
+			path.push_back(std::make_pair(to, graph.GetEdgeBegin(to)));	//edge may dangle after this
+		}
+	}
+}
+
+/**********************************************************************
+* Purpose: This function runs Dijkstra from source with costs from
+*		   weights, in workspace, calling the visitor at each step. A
+*		   vertex is finished when it is settled, with its final
+*		   distance, so stopping at Finish(target) is a point to point
+*		   query.
+*
+* Precondition:	source is a valid index of graph, weights holds one cost
+*				of 0 or more per edge id.
+*
+* Postcondition: The workspace holds the distances and predecessors of
+*				 every vertex reached, until its next Prepare().
+************************************************************************/
+template<typename V, typename E, typename Visitor>
+void VisitShortestPaths(const CompactGraph<V, E> & graph, const int * weights, int source, SearchWorkspace & workspace,
+	Visitor && visitor)
+{
+	if (source < 0 || source >= graph.GetVertexCount())
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+
+	const int * targets = graph.GetTargets();
+	workspace.Prepare(graph.GetVertexCount());
+	int * distance = workspace.GetDistances();
+	int * pred = workspace.GetPreds();
+	char * done = workspace.GetDone();
+	RadixHeap<int> & heap = workspace.GetQueue();
+
+	workspace.Touch(source);
+	distance[source] = 0;
+	heap.Push(0, source);
+	visitor.Discover(source, 0);
+
+	while (!heap.IsEmpty())
+	{
+		int dist = heap.GetTopKey();
+		int current = heap.GetTopVertex();
+		heap.Pop();
+		if (dist != distance[current] || done[current])
+		{
+			continue;	//Improved after it was pushed
+		}
+		done[current] = 1;
+
+		for (int edge = graph.GetEdgeBegin(current); edge != graph.GetEdgeEnd(current); ++edge)
+		{
+			if (!visitor.ExamineEdge(current, edge))
+			{
+				continue;
+			}
+			int to = targets[edge];
+			int cost = dist + weights[edge];
+			if (cost < distance[to])
+			{
+				bool first = distance[to] == INFINITE_DISTANCE;
+				if (first)
+				{
+					workspace.Touch(to);
+				}
+				distance[to] = cost;
+				pred[to] = current;
+				heap.Push(cost, to);
+				visitor.Relax(current, edge, to, cost);
+				if (first)
+				{
+					visitor.Discover(to, cost);
+				}
+			}
+		}
+		if (!visitor.Finish(current, dist))
+		{
+			break;
+		}
+	}
+	heap.Clear();
+}
+#endif
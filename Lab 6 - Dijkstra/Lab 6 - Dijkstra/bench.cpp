@@ -0,0 +1,1172 @@
+/***********************************************************
+* Filename:				bench.cpp
+* Date Created:			10/19/26
+* Last Mod Date:		10/19/26
+*
+* Overview:
+*	Times the graph build and query paths on reproducible graphs
+*	generated from a fixed seed, one suite per function below.
+*	The tests target checks that the engines are right; this only
+*	times them and counts their work.
+*		- Build: file ingest by name and by place id, InsertVertex,
+*		  AddEdge, Graph copies, DepthFirst / BreadthFirst,
+*		  Dijkstra() and CompactGraph::Build, on the random graph.
+*		- Engines: both heaps, delta stepping on 1, 2, 4, ... threads
+*		  with its speedup over the radix heap, and a what-if copy
+*		  of the CompactGraph that changes one weight.
+*		- Reachability: isochrones reaching about 1% of the graph,
+*		  components, ParallelBreadthFirst and the visitor hooks.
+*		- Scenarios: closing ten roads, and searching around them.
+*		- Alternatives: Yen's algorithm and the penalty method.
+*		- Landmarks: sixteen ALT landmarks picked both ways, and
+*		  the ALT route next to a Dijkstra that stops at target.
+*	The suites from here on run on a planar road network (the
+*	random graph has no small cuts to partition along), numbered
+*	cell by cell:
+*		- Orders: one query set on the network as loaded, shuffled,
+*		  and reordered breadth first, by Cuthill-McKee and along a
+*		  Hilbert curve, per settled vertex.
+*		- Overlay: the multilevel partition, its customization and
+*		  the CellOverlay route.
+*		- Turns: routes with no turns and with turns set.
+*		- Pareto: fronts on two and three criteria, and how many
+*		  routes each two criteria front holds.
+*		- Road rules: "no highways" and "interstates only where
+*		  possible".
+*		- Vehicle profiles: building the car profile, and routing
+*		  car and truck.
+*		- External: an ExternalGraph file searched warm, with and
+*		  without prefetching.
+*		- Compressed: the varint coded adjacency, and its bytes per
+*		  edge next to the CompactGraph's.
+*		- Output: the route serializers into a null stream.
+*	With --input a road file from the generate tool replaces both
+*	graphs, and Build only times reading it and the CompactGraph.
+*
+* Input:
+*	new.txt in the working directory, and the options
+*	--vertices N, --edges M, --seed S, --min-time seconds,
+*	--input road file, --json file, --label text and --trace file
+*	(the frontier of the first ShortestPaths query).
+*
+* Output:
+*	ns/op, ops/s, allocations and bytes per op for every
+*	benchmark, the speedup of each parallel run over its
+*	sequential baseline, the Pareto front sizes and the peak RSS.
+*	With --json the same results are also written as JSON, to diff
+*	runs across commits. Then the search counters of each engine
+*	over the query set.
+************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include "methods.h"
+#include "ShortestPaths.h"
+#include "DeltaStepping.h"
+#include "RoadNetwork.h"
+#include "RouteResult.h"
+#include "Isochrone.h"
+#include "AlternativeRoutes.h"
+#include "Components.h"
+#include "ParallelBfs.h"
+#include "Visitor.h"
+#include "ScenarioGraph.h"
+#include "Landmarks.h"
+#include "CellOverlay.h"
+#include "TravelTimeModel.h"
+#include "TurnTable.h"
+#include "ParetoRoutes.h"
+#include "RoadRules.h"
+#include "MaskedGraph.h"
+#include "VehicleProfiles.h"
+#include "ExternalGraph.h"
+#include "CompressedGraph.h"
+#include "Reordering.h"
+#include "Benchmark.h"
+using std::mt19937;
+using std::ofstream;
+using std::streambuf;
+using std::to_string;
+
+/************************************************************************
+* Class: NullBuffer
+*
+* Purpose: A stream buffer that throws away everything written to it, so
+*		   Dijkstra()'s printing can be silenced while it is timed.
+*************************************************************************/
+class NullBuffer : public streambuf
+{
+protected:
+	int overflow(int c) { return c; }
+	std::streamsize xsputn(const char *, std::streamsize count) { return count; }
+};
+
+void GenerateGraph(Graph<string, string> & graph, int vertices, int edges, unsigned seed);	//Seeded random road graph
+
+struct BenchCounters	//Search counters over each suite's query set, for the summary
+{
+	SearchStats heap, radix, step, yen, penalty, bfs, p2p, alt, crp, turn, pareto, mask, profile, external, compressed;
+	double compactBytes;		//Adjacency bytes per edge
+	double compressedBytes;
+	int paretoQueries;			//Two criteria fronts, how many routes they held and how many labelLimit cut short
+	int paretoRoutes;
+	int paretoLargest;
+	int paretoIncomplete;
+
+	BenchCounters() : compactBytes(0), compressedBytes(0), paretoQueries(0), paretoRoutes(0), paretoLargest(0),
+		paretoIncomplete(0) {}
+};
+
+struct BenchRoads	//The road network the later suites share
+{
+	CompactGraph<string, string> graph;
+	vector<int> sources;	//Query starts; each query ends at the next one
+	vector<int> miles;		//Weights by edge id, once numbered cell by cell
+	vector<int> seconds;
+};
+
+void BenchBuild(BenchmarkSuite & suite, int vertices, int edges, unsigned seed, mt19937 & rng,
+	CompactGraph<string, string> & compact, vector<int> & sources);	//Graph, traversals and Dijkstra() on the random graph
+void BenchRoadFile(BenchmarkSuite & suite, const string & input, mt19937 & rng, CompactGraph<string, string> & compact,
+	vector<int> & sources, int & vertices, int & edges);	//Reading and building a road file instead
+void BenchEngines(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	BenchCounters & counters);	//Single source engines and a what-if copy
+void BenchReachability(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	BenchCounters & counters);	//Isochrones, components and traversals
+void BenchScenarios(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	mt19937 & rng);	//Ten roads closed
+void BenchAlternatives(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	BenchCounters & counters);	//Four routes by Yen and by penalty
+void BenchLandmarks(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	BenchCounters & counters);	//ALT against a search to target
+void BenchReordering(BenchmarkSuite & suite, const BenchRoads & roads, bool lattice);	//One query set on each vertex order
+void BenchOverlay(BenchmarkSuite & suite, BenchRoads & roads, BenchCounters & counters);	//Partition, customize, CellOverlay
+void BenchTurns(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters);	//Routes without and with turns
+void BenchPareto(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters);	//Fronts on two and three criteria
+void BenchRoadRules(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters);	//Masked routes
+void BenchProfiles(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters);	//Car, truck and bus
+void BenchExternal(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters);	//Memory mapped file
+void BenchCompressed(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters);	//Varint coded adjacency
+void BenchOutput(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources);	//Route serializers
+
+//Every allocation in the program is counted for the allocs/op column
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"	//GCC sees through the replacement to malloc / free
+#endif
+void * operator new(size_t size)
+{
+	CountAllocation(size);
+	void * memory = malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void * memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void * memory, size_t) noexcept
+{
+	free(memory);
+}
+
+
+int main(int argc, char * argv[])
+{
+	int vertices = 2000;
+	int edges = -1;
+	unsigned seed = 42;
+	double min_time = 0.2;
+	string json;
+	string input;
+	string trace;
+	string label = "local";
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		string option = argv[i];
+		if (option == "--vertices")
+		{
+			vertices = atoi(argv[i + 1]);
+		}
+		else if (option == "--edges")
+		{
+			edges = atoi(argv[i + 1]);
+		}
+		else if (option == "--seed")
+		{
+			seed = static_cast<unsigned>(strtoul(argv[i + 1], nullptr, 10));
+		}
+		else if (option == "--min-time")
+		{
+			min_time = atof(argv[i + 1]);
+		}
+		else if (option == "--json")
+		{
+			json = argv[i + 1];
+		}
+		else if (option == "--input")
+		{
+			input = argv[i + 1];
+		}
+		else if (option == "--trace")
+		{
+			trace = argv[i + 1];
+		}
+		else if (option == "--label")
+		{
+			label = argv[i + 1];
+		}
+	}
+	if (vertices < 2)
+	{
+		vertices = 2;
+	}
+	if (edges < vertices - 1)
+	{
+		edges = vertices * 3;
+	}
+
+	BenchmarkSuite suite(min_time);
+	BenchCounters counters;
+
+	try
+	{
+		CompactGraph<string, string> compact;
+		vector<int> sources;	//Indices into compact
+		BenchRoads roads;
+		mt19937 rng(seed);
+
+		if (input.empty())
+		{
+			BenchBuild(suite, vertices, edges, seed, rng, compact, sources);
+		}
+		else
+		{
+			BenchRoadFile(suite, input, rng, compact, sources, vertices, edges);
+		}
+		BenchEngines(suite, compact, sources, counters);
+		BenchReachability(suite, compact, sources, counters);
+		BenchScenarios(suite, compact, sources, rng);
+		BenchAlternatives(suite, compact, sources, counters);
+		BenchLandmarks(suite, compact, sources, counters);
+
+		if (input.empty())
+		{
+			BuildRoadGraph(GeneratePlanarNetwork(vertices, seed), roads.graph);
+		}
+		else
+		{
+			roads.graph = compact;
+		}
+		for (int i = 0; i < 16; i++)
+		{
+			roads.sources.push_back(static_cast<int>(rng() % roads.graph.GetVertexCount()));
+		}
+		BenchReordering(suite, roads, input.empty());
+		BenchOverlay(suite, roads, counters);
+		BenchTurns(suite, roads, counters);
+		BenchPareto(suite, roads, counters);
+		BenchRoadRules(suite, roads, counters);
+		BenchProfiles(suite, roads, counters);
+		BenchExternal(suite, roads, counters);
+		BenchCompressed(suite, roads, counters);
+		BenchOutput(suite, compact, sources);
+
+		if (!trace.empty())
+		{
+			vector<int> distance, pred;
+			ofstream out(trace.c_str());
+			ShortestPaths(compact, sources[0], distance, pred, nullptr, &out);
+		}
+	}
+	catch (Exception & ex)
+	{
+		cout << ex << endl;
+		return 1;
+	}
+
+	cout << "Vertices: " << vertices << ", edges: " << edges << ", seed: " << seed << "\n";
+	suite.Print(cout);
+	cout << "Adjacency bytes per edge: CompactGraph " << counters.compactBytes << ", CompressedGraph " << counters.compressedBytes << "\n";
+	cout << "Pareto fronts, miles and off interstates: " << counters.paretoRoutes << " routes over " << counters.paretoQueries
+		<< " queries, largest " << counters.paretoLargest << ", " << counters.paretoIncomplete << " cut short by the label limit\n";
+#if ROUTING_STATS
+	cout << "binary heap:   " << counters.heap << "\n";
+	cout << "radix heap:    " << counters.radix << "\n";
+	cout << "delta stepping: " << counters.step << "\n";
+	cout << "yen k=4:       " << counters.yen << "\n";
+	cout << "penalty 4:     " << counters.penalty << "\n";
+	cout << "parallel bfs:  " << counters.bfs << "\n";
+	cout << "to target:     " << counters.p2p << "\n";
+	cout << "alt 16 avoid:  " << counters.alt << "\n";
+	cout << "cell overlay:  " << counters.crp << "\n";
+	cout << "turns:         " << counters.turn << "\n";
+	cout << "pareto 2:      " << counters.pareto << "\n";
+	cout << "no highways:   " << counters.mask << "\n";
+	cout << "profiles:      " << counters.profile << "\n";
+	cout << "external:      " << counters.external << "\n";
+	cout << "compressed:    " << counters.compressed << "\n";
+#endif
+
+	if (!json.empty())
+	{
+		ofstream out(json.c_str());
+		suite.WriteJson(out, label, seed);
+	}
+	return 0;
+}
+
+/**********************************************************************
+* Purpose: This function times building the random graph and the paths
+*		   that only scale on it: file ingest into the string graph and
+*		   into the id graph the console routes on, InsertVertex, AddEdge,
+*		   Graph copies and moves, DepthFirst / BreadthFirst, Dijkstra()
+*		   and CompactGraph::Build.
+*
+* Precondition:	vertices >= 2, edges >= vertices - 1.
+*
+* Postcondition: compact holds the random graph and sources 16 query
+*				 starts in it.
+************************************************************************/
+void BenchBuild(BenchmarkSuite & suite, int vertices, int edges, unsigned seed, mt19937 & rng,
+	CompactGraph<string, string> & compact, vector<int> & sources)
+{
+	suite.Run("ingest/ReadLine+PopulateGraph", 47, []()
+	{
+		Graph<string, string> file_graph;
+		string edgeInfo[47][4];
+		ReadLine(edgeInfo);
+		PopulateGraph(edgeInfo, file_graph);
+	});
+	suite.Run("ingest/ReadLine+PopulateGraph ids", 47, []()
+	{
+		Graph<uint32_t, RoadClass> id_graph;
+		NameTable names;
+		string edgeInfo[47][4];
+		ReadLine(edgeInfo);
+		PopulateGraph(edgeInfo, names, id_graph);
+	});
+
+	suite.Run("graph/InsertVertex", vertices, [&]()
+	{
+		Graph<string, string> vertex_graph;
+		for (int i = 0; i < vertices; i++)
+		{
+			vertex_graph.InsertVertex("v" + to_string(i));
+		}
+	});
+
+	Graph<string, string> vertex_only;
+	for (int i = 0; i < vertices; i++)
+	{
+		vertex_only.InsertVertex("v" + to_string(i));
+	}
+	Graph<string, string> edge_graph;
+	suite.Run("graph/AddEdge", edges, [&]()
+	{
+		edge_graph = vertex_only;
+	}, [&]()
+	{
+		GenerateGraph(edge_graph, vertices, edges, seed);
+	});
+
+	Graph<string, string> graph;
+	graph = vertex_only;
+	GenerateGraph(graph, vertices, edges, seed);
+
+	Graph<string, string> copy;
+	suite.Run("graph/operator=", graph.GetCount(), [&]()
+	{
+		copy = graph;
+	});
+	suite.Run("graph/move", graph.GetCount(), [&]()
+	{
+		Graph<string, string> moved(std::move(copy));
+		copy = std::move(moved);
+	});
+
+	suite.Run("traverse/DepthFirst", graph.GetCount(), [&]()
+	{
+		graph.DepthFirst([](const string &) {});
+	});
+	suite.Run("traverse/BreadthFirst", graph.GetCount(), [&]()
+	{
+		graph.BreadthFirst([](const string &) {});
+	});
+
+	vector<int> targets;
+	for (int i = 0; i < 16; i++)
+	{
+		sources.push_back(static_cast<int>(rng() % vertices));
+		targets.push_back(static_cast<int>((sources.back() + 1 + rng() % (vertices - 1)) % vertices));
+	}
+
+	NullBuffer null_buffer;
+	streambuf * console = cout.rdbuf(&null_buffer);	//Dijkstra() prints its route
+	int next = 0;
+	suite.Run("query/Dijkstra", 1, [&]()
+	{
+		Dijkstra(graph, "v" + to_string(sources[next]), "v" + to_string(targets[next]));
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	cout.rdbuf(console);
+
+	suite.Run("graph/CompactGraph::Build", graph.GetCount(), [&]()
+	{
+		CompactGraph<string, string> built(graph);
+	});
+	compact.Build(graph);
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		sources[i] = compact.GetIndex("v" + to_string(sources[i]));
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times reading a road file from the generate
+*		   tool and building its CompactGraph, in place of BenchBuild().
+*
+* Precondition:	N/A
+*
+* Postcondition: compact holds the network, sources 16 query starts in
+*				 it, and vertices and edges its size; throws if the file
+*				 can't be read or has no places.
+************************************************************************/
+void BenchRoadFile(BenchmarkSuite & suite, const string & input, mt19937 & rng, CompactGraph<string, string> & compact,
+	vector<int> & sources, int & vertices, int & edges)
+{
+	RoadNetwork network = ReadRoadFile(input);
+	vertices = network.count;
+	edges = static_cast<int>(network.from.size());
+	if (vertices < 1)
+	{
+		throw Exception("Road file has no places");
+	}
+
+	suite.Run("ingest/ReadRoadFile", edges, [&]()
+	{
+		RoadNetwork loaded = ReadRoadFile(input);
+	});
+	suite.Run("graph/CompactGraph::Build edges", vertices, [&]()
+	{
+		CompactGraph<string, string> built;
+		BuildRoadGraph(network, built);
+	});
+	BuildRoadGraph(network, compact);
+	for (int i = 0; i < 16; i++)
+	{
+		sources.push_back(static_cast<int>(rng() % vertices));
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times a what-if copy of the graph that changes
+*		   one weight, which should share everything but the weights,
+*		   and the single source engines: both heaps, and delta stepping
+*		   on a doubling number of threads up to every hardware thread,
+*		   each compared with the radix heap, the fastest sequential
+*		   engine.
+*
+* Precondition:	sources holds indices of compact.
+*
+* Postcondition: The engines' counters over sources are added.
+************************************************************************/
+void BenchEngines(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	BenchCounters & counters)
+{
+	int delta = SuggestDelta(compact);
+	int next = 0;
+	vector<int> heap_dist, heap_pred, radix_dist, radix_pred, step_dist, step_pred;
+
+	suite.Run("graph/CompactGraph copy and SetWeight", 1, [&]()
+	{
+		CompactGraph<string, string> scenario(compact);
+		scenario.SetWeight(0, scenario.GetWeight(0) + 1);
+	});
+	suite.Run("query/ShortestPaths binary heap", 1, [&]()
+	{
+		ShortestPathsWith<BinaryHeap<int>>(compact, sources[next], heap_dist, heap_pred);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	suite.Run("query/ShortestPaths radix heap", 1, [&]()
+	{
+		ShortestPathsWith<RadixHeap<int>>(compact, sources[next], radix_dist, radix_pred);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	vector<int> thread_counts;	//1, 2, 4, ... and every hardware thread last
+	for (int threads = 1; threads < DefaultThreadCount(); threads *= 2)
+	{
+		thread_counts.push_back(threads);
+	}
+	thread_counts.push_back(DefaultThreadCount());
+	for (size_t i = 0; i < thread_counts.size(); i++)
+	{
+		string name = "query/DeltaStepping x" + to_string(thread_counts[i]);
+		suite.Run(name, 1, [&]()
+		{
+			DeltaStepping(compact, sources[next], delta, thread_counts[i], step_dist, step_pred);
+			next = (next + 1) % static_cast<int>(sources.size());
+		});
+		suite.Compare(name, "query/ShortestPaths radix heap");
+	}
+
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		ShortestPathsWith<BinaryHeap<int>>(compact, sources[i], heap_dist, heap_pred, &counters.heap);
+		ShortestPathsWith<RadixHeap<int>>(compact, sources[i], radix_dist, radix_pred, &counters.radix);
+		DeltaStepping(compact, sources[i], delta, 0, step_dist, step_pred, &counters.step);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times isochrones with a budget that reaches
+*		   about 1% of the graph, alone and as a parallel batch, then
+*		   connected components next to one bitmap reachability pass,
+*		   ParallelBreadthFirst, and the visitor traversal and search
+*		   with an empty visitor, to show what the hooks cost.
+*
+* Precondition:	sources holds indices of compact.
+*
+* Postcondition: ParallelBreadthFirst's counters are added.
+************************************************************************/
+void BenchReachability(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	BenchCounters & counters)
+{
+	vector<int> distance, pred;
+	ShortestPaths(compact, sources[0], distance, pred);
+	std::sort(distance.begin(), distance.end());
+	int budget = distance[distance.size() / 100];	//Reaches about 1% of the graph
+	vector<ReachedVertex> reached;
+	vector<vector<ReachedVertex> > batch;
+	SearchWorkspace workspace;
+	int next = 0;
+
+	suite.Run("query/ReachableWithin 1%", 1, [&]()
+	{
+		ReachableWithin(compact, compact.GetWeights(), sources[next], budget, workspace, reached);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	suite.Run("query/ReachableWithinBatch x" + to_string(DefaultThreadCount()), static_cast<long long>(sources.size()), [&]()
+	{
+		ReachableWithinBatch(compact, compact.GetWeights(), sources, budget, DefaultThreadCount(), batch);
+	});
+
+	vector<int> component;
+	Bitmap reachable;
+	suite.Run("analysis/ConnectedComponents x" + to_string(DefaultThreadCount()), compact.GetVertexCount(), [&]()
+	{
+		ConnectedComponents(compact, DefaultThreadCount(), component);
+	});
+	suite.Run("analysis/ReachableFrom", compact.GetVertexCount(), [&]()
+	{
+		ReachableFrom(compact, sources[0], reachable);
+	});
+
+	vector<int> hops, parents;
+	suite.Run("traverse/ParallelBreadthFirst x" + to_string(DefaultThreadCount()), compact.GetVertexCount(), [&]()
+	{
+		ParallelBreadthFirst(compact, sources[next], 0, hops, parents);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	suite.Run("traverse/VisitBreadthFirst", compact.GetVertexCount(), [&]()
+	{
+		VisitBreadthFirst(compact, sources[next], SearchVisitor());
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	suite.Run("query/VisitShortestPaths", 1, [&]()
+	{
+		VisitShortestPaths(compact, compact.GetWeights(), sources[next], workspace, SearchVisitor());
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	ParallelBreadthFirst(compact, sources[0], 0, hops, parents, &counters.bfs);
+}
+
+/**********************************************************************
+* Purpose: This function times making a scenario that closes ten roads,
+*		   which shows its memory is only its changes, and searching it
+*		   next to the same search over the plain graph.
+*
+* Precondition:	sources holds indices of compact.
+*
+* Postcondition: rng is advanced.
+************************************************************************/
+void BenchScenarios(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	mt19937 & rng)
+{
+	vector<int> closures;	//Ten roads, as from and to pairs
+	SearchWorkspace workspace;
+	int next = 0;
+
+	for (int i = 0; i < 10 && compact.GetEdgeCount() > 0; i++)
+	{
+		int from = static_cast<int>(rng() % compact.GetVertexCount());
+		while (compact.GetEdgeBegin(from) == compact.GetEdgeEnd(from))
+		{
+			from = (from + 1) % compact.GetVertexCount();
+		}
+		closures.push_back(from);
+		closures.push_back(compact.GetTarget(compact.GetEdgeBegin(from)));
+	}
+	ScenarioGraph<string, string> scenario(compact);
+	suite.Run("scenario/ScenarioGraph close 10 roads", 1, [&]()
+	{
+		ScenarioGraph<string, string> made(compact);
+		for (size_t i = 0; i < closures.size(); i += 2)
+		{
+			made.RemoveEdge(closures[i], closures[i + 1]);
+		}
+	});
+	for (size_t i = 0; i < closures.size(); i += 2)
+	{
+		scenario.RemoveEdge(closures[i], closures[i + 1]);
+	}
+	suite.Run("query/ShortestPathsOver base", 1, [&]()
+	{
+		ShortestPathsOver(compact, sources[next], workspace);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	suite.Run("query/ShortestPathsOver scenario", 1, [&]()
+	{
+		ShortestPathsOver(scenario, sources[next], workspace);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+}
+
+/**********************************************************************
+* Purpose: This function times four alternative routes between each pair
+*		   of consecutive sources, by Yen's algorithm and by the penalty
+*		   method.
+*
+* Precondition:	sources holds indices of compact.
+*
+* Postcondition: Both methods' counters are added.
+************************************************************************/
+void BenchAlternatives(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	BenchCounters & counters)
+{
+	vector<AlternativeRoute> routes;
+	SearchWorkspace workspace;
+	int next = 0;
+
+	suite.Run("query/KShortestRoutes k=4", 1, [&]()
+	{
+		KShortestRoutes(compact, compact.GetWeights(), sources[next], sources[(next + 1) % sources.size()], 4, workspace, routes);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	suite.Run("query/AlternativesByPenalty 4", 1, [&]()
+	{
+		AlternativesByPenalty(compact, compact.GetWeights(), sources[next], sources[(next + 1) % sources.size()], 4, 0.5, 1.5, workspace, routes);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		int target = sources[(i + 1) % sources.size()];
+		KShortestRoutes(compact, compact.GetWeights(), sources[i], target, 4, workspace, routes, &counters.yen);
+		AlternativesByPenalty(compact, compact.GetWeights(), sources[i], target, 4, 0.5, 1.5, workspace, routes, &counters.penalty);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times picking sixteen ALT landmarks both ways,
+*		   and the ALT route against a Dijkstra that stops at target.
+*
+* Precondition:	sources holds indices of compact.
+*
+* Postcondition: Both searches' counters are added.
+************************************************************************/
+void BenchLandmarks(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources,
+	BenchCounters & counters)
+{
+	LandmarkTable landmarks;
+	SearchWorkspace workspace;
+	vector<int> path;
+	int next = 0;
+
+	suite.Run("preprocess/LandmarkTable 16 farthest", compact.GetVertexCount(), [&]()
+	{
+		landmarks.Build(compact, 16, LANDMARKS_FARTHEST);
+	});
+	suite.Run("preprocess/LandmarkTable 16 avoid", compact.GetVertexCount(), [&]()
+	{
+		landmarks.Build(compact, 16, LANDMARKS_AVOID);
+	});
+	suite.Run("query/ShortestRouteOver to target", 1, [&]()
+	{
+		ShortestRouteOver(compact, sources[next], sources[(next + 1) % sources.size()], workspace, path);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	suite.Run("query/LandmarkTable::Route", 1, [&]()
+	{
+		landmarks.Route(compact, sources[next], sources[(next + 1) % sources.size()], workspace, path);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		int target = sources[(i + 1) % sources.size()];
+		ShortestRouteOver(compact, sources[i], target, workspace, path, &counters.p2p);
+		landmarks.Route(compact, sources[i], target, workspace, path, &counters.alt);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function runs the same queries on the road network in
+*		   each vertex order of Reordering.h. The network as loaded is
+*		   already numbered row by row, so it is also shuffled, the way
+*		   a file listing places in any order would number it, and each
+*		   order is computed from the shuffled copy. Every query settles
+*		   the whole network, so ns/op is per settled vertex, where the
+*		   cache misses an order saves show up. The generated network's
+*		   places sit on a square lattice in number order (lattice), and
+*		   that position stands in for coordinates in HilbertOrder();
+*		   a road file has none, so it gets no Hilbert row.
+*
+* Precondition:	roads.graph and roads.sources are set.
+*
+* Postcondition: N/A
+************************************************************************/
+void BenchReordering(BenchmarkSuite & suite, const BenchRoads & roads, bool lattice)
+{
+	const int SIZE = roads.graph.GetVertexCount();
+	int width = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(SIZE))));
+	vector<int> shuffle(SIZE);
+	unsigned long long state = 1;
+	int next = 0;
+	vector<int> distance, pred;
+
+	for (int i = 0; i < SIZE; i++)
+	{
+		shuffle[i] = i;
+	}
+	for (int i = SIZE - 1; i > 0; i--)
+	{
+		std::swap(shuffle[i], shuffle[NextRandom(state, static_cast<unsigned>(i + 1))]);
+	}
+	CompactGraph<string, string> shuffled(roads.graph);
+	shuffled.Reorder(shuffle);
+
+	vector<string> names;
+	vector<CompactGraph<string, string>> graphs;
+	names.push_back("as loaded");
+	graphs.push_back(roads.graph);
+	names.push_back("shuffled");
+	graphs.push_back(shuffled);
+	names.push_back("breadth first");
+	graphs.push_back(shuffled);
+	graphs.back().Reorder(BreadthFirstOrder(shuffled));
+	names.push_back("Cuthill-McKee");
+	graphs.push_back(shuffled);
+	graphs.back().Reorder(CuthillMcKeeOrder(shuffled));
+	if (lattice)
+	{
+		vector<double> x(SIZE), y(SIZE);
+		for (int i = 0; i < SIZE; i++)
+		{
+			x[i] = shuffle[i] % width;
+			y[i] = shuffle[i] / width;
+		}
+		names.push_back("Hilbert");
+		graphs.push_back(shuffled);
+		graphs.back().Reorder(HilbertOrder(x, y));
+	}
+
+	for (size_t g = 0; g < graphs.size(); g++)
+	{
+		vector<int> sources;	//The same places in every order
+		for (size_t i = 0; i < roads.sources.size(); i++)
+		{
+			sources.push_back(graphs[g].GetIndex(roads.graph.GetData(roads.sources[i])));
+		}
+		suite.Run("order/ShortestPaths " + names[g], SIZE, [&]()
+		{
+			ShortestPaths(graphs[g], sources[next], distance, pred);
+			next = (next + 1) % static_cast<int>(sources.size());
+		});
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times the multilevel partition of the road
+*		   network, its customization for miles and for driving time,
+*		   and the CellOverlay route next to a plain search to target.
+*
+* Precondition:	roads.graph and roads.sources are set.
+*
+* Postcondition: roads.graph is numbered cell by cell, roads.miles and
+*				 roads.seconds hold its weights, and the overlay's
+*				 counters are added.
+************************************************************************/
+void BenchOverlay(BenchmarkSuite & suite, BenchRoads & roads, BenchCounters & counters)
+{
+	const vector<int> CELL_SIZES = { 256, 4096, 65536 };
+	const vector<int> & sources = roads.sources;
+	MultilevelPartition partition;
+	CellOverlay overlay;
+	SearchWorkspace workspace, backward;
+	vector<int> path;
+	int next = 0;
+
+	suite.Run("preprocess/MultilevelPartition 256 4096 65536", roads.graph.GetVertexCount(), [&]()
+	{
+		partition.Build(roads.graph, CELL_SIZES);
+	});
+	vector<int> cell_order = partition.CellOrder();
+	roads.graph.Reorder(cell_order);
+	partition.Reorder(cell_order);
+	overlay.Build(roads.graph, partition);
+	roads.miles.assign(roads.graph.GetWeights(), roads.graph.GetWeights() + roads.graph.GetEdgeCount());
+	roads.seconds = TravelTimeModel().EdgeSeconds(roads.graph);
+
+	suite.Run("preprocess/CellOverlay::Customize miles", roads.graph.GetVertexCount(), [&]()
+	{
+		overlay.Customize(roads.graph, roads.miles.data(), 0);
+	});
+	suite.Run("preprocess/CellOverlay::Customize seconds", roads.graph.GetVertexCount(), [&]()
+	{
+		overlay.Customize(roads.graph, roads.seconds.data(), 0);
+	});
+	suite.Run("query/road ShortestRouteOver to target", 1, [&]()
+	{
+		ShortestRouteOver(roads.graph, sources[next], sources[(next + 1) % sources.size()], workspace, path);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	overlay.Customize(roads.graph, roads.miles.data(), 0);
+	suite.Run("query/CellOverlay::Route", 1, [&]()
+	{
+		overlay.Route(roads.graph, roads.miles.data(), sources[next], sources[(next + 1) % sources.size()], workspace, backward, path);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		overlay.Route(roads.graph, roads.miles.data(), sources[i], sources[(i + 1) % sources.size()], workspace, backward, path,
+			&counters.crp);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times the turn-aware route with no turns set,
+*		   then with a mile to change roads at a quarter of the
+*		   junctions, forbidden at every 64th vertex.
+*
+* Precondition:	BenchOverlay() has set roads.
+*
+* Postcondition: The turn route's counters are added.
+************************************************************************/
+void BenchTurns(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters)
+{
+	const CompactGraph<string, string> & graph = roads.graph;
+	const vector<int> & sources = roads.sources;
+	TurnTable turns;
+	SearchWorkspace workspace;
+	vector<int> path, edges;
+	int next = 0;
+
+	turns.Build(graph);
+	suite.Run("query/TurnTable::Route no turns", 1, [&]()
+	{
+		turns.Route(graph, roads.miles.data(), sources[next], sources[(next + 1) % sources.size()], workspace, path, edges);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	for (int v = 0; v < graph.GetVertexCount(); v += 4)
+	{
+		for (int in = graph.GetEdgeBegin(v); in != graph.GetEdgeEnd(v); ++in)
+		{
+			for (int out = graph.GetEdgeBegin(v); out != graph.GetEdgeEnd(v); ++out)
+			{
+				if (graph.GetEdgeData(in) != graph.GetEdgeData(out))
+				{
+					turns.SetTurn(graph, v, graph.GetEdgeData(in), graph.GetEdgeData(out), v % 64 == 0 ? TURN_FORBIDDEN : 1);
+				}
+			}
+		}
+	}
+	turns.Compile();
+	suite.Run("query/TurnTable::Route turns", 1, [&]()
+	{
+		turns.Route(graph, roads.miles.data(), sources[next], sources[(next + 1) % sources.size()], workspace, path, edges);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		turns.Route(graph, roads.miles.data(), sources[i], sources[(i + 1) % sources.size()], workspace, path, edges, &counters.turn);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times the Pareto front of miles against miles
+*		   off the interstates, and with driving time as a third
+*		   criterion.
+*
+* Precondition:	BenchOverlay() has set roads.
+*
+* Postcondition: The two criteria front's counters, sizes and whether
+*				 each was complete are added.
+************************************************************************/
+void BenchPareto(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters)
+{
+	const vector<int> & sources = roads.sources;
+	vector<int> off_interstates = MilesOffInterstates(roads.graph);
+	vector<const int *> two = { roads.miles.data(), off_interstates.data() };
+	vector<const int *> three = { roads.miles.data(), off_interstates.data(), roads.seconds.data() };
+	vector<ParetoRoute> front;
+	SearchWorkspace workspace;
+	int next = 0;
+
+	suite.Run("query/ParetoRoutes miles, off interstates", 1, [&]()
+	{
+		ParetoRoutes(roads.graph, two, sources[next], sources[(next + 1) % sources.size()], workspace, front);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	suite.Run("query/ParetoRoutes miles, off interstates, seconds", 1, [&]()
+	{
+		ParetoRoutes(roads.graph, three, sources[next], sources[(next + 1) % sources.size()], workspace, front);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		bool complete = ParetoRoutes(roads.graph, two, sources[i], sources[(i + 1) % sources.size()], workspace, front,
+			PARETO_LABEL_LIMIT, &counters.pareto);
+		counters.paretoQueries++;
+		counters.paretoRoutes += static_cast<int>(front.size());
+		counters.paretoLargest = std::max(counters.paretoLargest, static_cast<int>(front.size()));
+		counters.paretoIncomplete += complete ? 0 : 1;
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times compiling "no highways" to an edge mask,
+*		   the route that skips the masked edges, and "interstates only
+*		   where possible", which falls back to penalized edges.
+*
+* Precondition:	BenchOverlay() has set roads.
+*
+* Postcondition: The masked route's counters are added.
+************************************************************************/
+void BenchRoadRules(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters)
+{
+	const vector<int> & sources = roads.sources;
+	RoadRules<string> no_highways, interstates;
+	Bitmap highway_mask, interstate_mask;
+	SearchWorkspace workspace;
+	vector<int> path;
+	int next = 0;
+
+	no_highways.AvoidClass(ROAD_HIGHWAY);
+	interstates.OnlyClass(ROAD_INTERSTATE);
+	suite.Run("preprocess/RoadRules::Compile no highways", roads.graph.GetEdgeCount(), [&]()
+	{
+		no_highways.Compile(roads.graph, highway_mask);
+	});
+	interstates.Compile(roads.graph, interstate_mask);
+	MaskedGraph<string, string> highways_masked(roads.graph, highway_mask);
+	MaskedGraph<string, string> interstates_masked(roads.graph, interstate_mask);
+	suite.Run("query/MaskedGraph no highways", 1, [&]()
+	{
+		ShortestRouteOver(highways_masked, sources[next], sources[(next + 1) % sources.size()], workspace, path);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	suite.Run("query/MaskedGraph::RouteWherePossible interstates", 1, [&]()
+	{
+		interstates_masked.RouteWherePossible(sources[next], sources[(next + 1) % sources.size()], MASK_PENALTY,
+			workspace, path, nullptr, nullptr);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		ShortestRouteOver(highways_masked, sources[i], sources[(i + 1) % sources.size()], workspace, path, &counters.mask);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times building the car, truck and bus profiles,
+*		   and routing with the profile switched on every query, car
+*		   then truck.
+*
+* Precondition:	BenchOverlay() has set roads.
+*
+* Postcondition: The car route's counters are added.
+************************************************************************/
+void BenchProfiles(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters)
+{
+	const vector<int> & sources = roads.sources;
+	VehicleProfiles profiles;
+	SearchWorkspace workspace;
+	vector<int> path, edges;
+	int next = 0;
+
+	suite.Run("preprocess/VehicleProfiles miles car truck bus", roads.graph.GetEdgeCount(), [&]()
+	{
+		profiles = VehicleProfiles();
+		profiles.AddDefaultProfiles(roads.graph);
+	});
+	const int CAR = profiles.GetProfile("car");
+	const int TRUCK = profiles.GetProfile("truck");
+	suite.Run("query/VehicleProfiles::Route car, truck", 1, [&]()
+	{
+		profiles.Route(roads.graph, next % 2 == 0 ? CAR : TRUCK, sources[next], sources[(next + 1) % sources.size()],
+			workspace, path, edges);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		profiles.Route(roads.graph, CAR, sources[i], sources[(i + 1) % sources.size()], workspace, path, edges, &counters.profile);
+	}
+}
+
+/**********************************************************************
+* Purpose: This function times writing the road network as an
+*		   ExternalGraph file and searching it through its memory
+*		   mapping, with and without block prefetching. The file is
+*		   cached after writing, so this is the warm cost of the
+*		   mapping.
+*
+* Precondition:	BenchOverlay() has set roads.
+*
+* Postcondition: The prefetching route's counters are added and the file
+*				 is removed.
+************************************************************************/
+void BenchExternal(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters)
+{
+	const string EXTERNAL_FILE = "bench_external.graph";
+	ExternalGraph external;
+	vector<int> file_sources;
+	SearchWorkspace workspace;
+	vector<int> path;
+	int next = 0;
+
+	suite.Run("preprocess/ExternalGraph::Write", roads.graph.GetEdgeCount(), [&]()
+	{
+		ExternalGraph::Write(roads.graph, roads.miles.data(), vector<int>(), EXTERNAL_FILE);
+	});
+	external.Open(EXTERNAL_FILE);
+	for (size_t i = 0; i < roads.sources.size(); i++)
+	{
+		file_sources.push_back(external.GetFileIndex(roads.sources[i]));
+	}
+	suite.Run("query/ExternalGraph ShortestRouteOver", 1, [&]()
+	{
+		ShortestRouteOver(external, file_sources[next], file_sources[(next + 1) % file_sources.size()], workspace, path);
+		next = (next + 1) % static_cast<int>(file_sources.size());
+	});
+	suite.Run("query/ExternalGraph::Route prefetch", 1, [&]()
+	{
+		external.Route(file_sources[next], file_sources[(next + 1) % file_sources.size()], workspace, path);
+		next = (next + 1) % static_cast<int>(file_sources.size());
+	});
+	for (size_t i = 0; i < file_sources.size(); i++)
+	{
+		external.Route(file_sources[i], file_sources[(i + 1) % file_sources.size()], workspace, path, &counters.external);
+	}
+	external.Close();
+	std::remove(EXTERNAL_FILE.c_str());
+}
+
+/**********************************************************************
+* Purpose: This function times varint coding the road network's
+*		   adjacency into a CompressedGraph and searching it, and works
+*		   out its bytes per edge next to the CompactGraph's.
+*
+* Precondition:	BenchOverlay() has set roads.
+*
+* Postcondition: The compressed search's counters and both sizes are
+*				 set.
+************************************************************************/
+void BenchCompressed(BenchmarkSuite & suite, const BenchRoads & roads, BenchCounters & counters)
+{
+	const vector<int> & sources = roads.sources;
+	const double EDGES = roads.graph.GetEdgeCount();
+	CompressedGraph compressed;
+	SearchWorkspace workspace;
+	vector<int> path;
+	int next = 0;
+
+	suite.Run("preprocess/CompressedGraph::Build miles", roads.graph.GetEdgeCount(), [&]()
+	{
+		compressed.Build(roads.graph, roads.miles.data());
+	});
+	suite.Run("query/CompressedGraph ShortestRouteOver", 1, [&]()
+	{
+		ShortestRouteOver(compressed, sources[next], sources[(next + 1) % sources.size()], workspace, path);
+		next = (next + 1) % static_cast<int>(sources.size());
+	});
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		ShortestRouteOver(compressed, sources[i], sources[(i + 1) % sources.size()], workspace, path, &counters.compressed);
+	}
+	counters.compactBytes = (EDGES * 2 * sizeof(int) + (roads.graph.GetVertexCount() + 1) * sizeof(int)) / EDGES;
+	counters.compressedBytes = compressed.GetByteCount() / EDGES;
+}
+
+/**********************************************************************
+* Purpose: This function times the route serializers writing one route
+*		   a thousand times into a null stream.
+*
+* Precondition:	sources holds at least two indices of compact.
+*
+* Postcondition: N/A
+************************************************************************/
+void BenchOutput(BenchmarkSuite & suite, const CompactGraph<string, string> & compact, const vector<int> & sources)
+{
+	RouteResult<string> route = FindRoute(compact, compact.GetData(sources[0]), compact.GetData(sources[1]));
+	NullBuffer sink;
+	std::ostream out(&sink);
+
+	suite.Run("output/WriteRouteText", 1000, [&]()
+	{
+		for (int i = 0; i < 1000; i++)
+		{
+			WriteRouteText(out, route);
+		}
+	});
+	suite.Run("output/WriteRouteJson", 1000, [&]()
+	{
+		for (int i = 0; i < 1000; i++)
+		{
+			WriteRouteJson(out, route);
+		}
+	});
+	suite.Run("output/WriteRouteCsv", 1000, [&]()
+	{
+		for (int i = 0; i < 1000; i++)
+		{
+			WriteRouteCsv(out, route);
+		}
+	});
+	suite.Run("output/WriteRouteBinary", 1000, [&]()
+	{
+		for (int i = 0; i < 1000; i++)
+		{
+			WriteRouteBinary(out, route);
+		}
+	});
+}
+
+/**********************************************************************
+* Purpose: This function adds edges random edges between the vertices
+*		   v0 to v(vertices - 1) of graph, starting with a path through
+*		   all of them so the graph is connected. The same seed always
+*		   gives the same graph.
+*
+* Precondition:	graph holds the vertices v0 to v(vertices - 1).
+*
+* Postcondition: graph has edges more edges.
+************************************************************************/
+void GenerateGraph(Graph<string, string> & graph, int vertices, int edges, unsigned seed)
+{
+	const string roads[] = { "I-5", "Hwy 97", "Hwy 140", "Dead Indian Memorial Road" };
+	mt19937 rng(seed);	//mt19937 is the same everywhere, unlike the distributions
+
+	for (int i = 0; i < edges; i++)
+	{
+		int from = i < vertices - 1 ? i : static_cast<int>(rng() % vertices);
+		int to = i < vertices - 1 ? i + 1 : static_cast<int>(rng() % vertices);
+		graph.AddEdge("v" + to_string(from), "v" + to_string(to), roads[rng() % 4], 1 + static_cast<int>(rng() % 60));
+	}
+}
@@ -0,0 +1,127 @@
+/***********************************************************
+* Filename:				generate.cpp
+* Date Created:			10/19/26
+* Last Mod Date:		10/19/26
+*
+* Overview:
+*	Writes a synthetic road network for scale testing. The same
+*	options and seed always give the same file, so benchmark runs
+*	on different machines and commits use the same input.
+*
+* Input:
+*	--topology grid | planar | powerlaw (planar), --vertices N
+*	(1000), --links L for powerlaw (2), --seed S (42),
+*	--format text | binary | external (text) and --output file
+*	(roads.txt).
+*
+* Output:
+*	The network, as from,to,road,miles lines like new.txt, as a
+*	binary road file, or as an ExternalGraph file to search without
+*	loading it, and a one line summary of its size. The external
+*	file is built from the whole graph in memory, so it has to be
+*	written on a machine that can hold it.
+************************************************************/
+#include <iostream>
+#include <cstdlib>
+#include "RoadNetwork.h"
+#include "ExternalGraph.h"
+using std::cout;
+using std::endl;
+
+int main(int argc, char * argv[])
+{
+	string topology = "planar";
+	string format = "text";
+	string output = "roads.txt";
+	int vertices = 1000;
+	int links = 2;
+	unsigned seed = 42;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		string option = argv[i];
+		if (option == "--topology")
+		{
+			topology = argv[i + 1];
+		}
+		else if (option == "--vertices")
+		{
+			vertices = atoi(argv[i + 1]);
+		}
+		else if (option == "--links")
+		{
+			links = atoi(argv[i + 1]);
+		}
+		else if (option == "--seed")
+		{
+			seed = static_cast<unsigned>(strtoul(argv[i + 1], nullptr, 10));
+		}
+		else if (option == "--format")
+		{
+			format = argv[i + 1];
+		}
+		else if (option == "--output")
+		{
+			output = argv[i + 1];
+		}
+		else
+		{
+			cout << "Unknown option " << option << endl;
+			return 1;
+		}
+	}
+
+	try
+	{
+		RoadNetwork network;
+		if (vertices < 1 || links < 1)
+		{
+			throw Exception("--vertices and --links must be at least 1");
+		}
+
+		if (topology == "grid")
+		{
+			network = GenerateGridNetwork(vertices, seed);
+		}
+		else if (topology == "planar")
+		{
+			network = GeneratePlanarNetwork(vertices, seed);
+		}
+		else if (topology == "powerlaw")
+		{
+			network = GeneratePowerLawNetwork(vertices, links, seed);
+		}
+		else
+		{
+			throw Exception("--topology must be grid, planar or powerlaw");
+		}
+
+		if (format == "text")
+		{
+			WriteRoadText(network, output);
+		}
+		else if (format == "binary")
+		{
+			WriteRoadBinary(network, output);
+		}
+		else if (format == "external")
+		{
+			CompactGraph<uint32_t, RoadClass> graph;	//Place ids, the file keeps no names
+			BuildRoadGraph(network, graph);
+			ExternalGraph::Write(graph, graph.GetWeights(), vector<int>(), output);
+		}
+		else
+		{
+			throw Exception("--format must be text, binary or external");
+		}
+
+		cout << output << ": " << network.count << " places, " << network.from.size() << " segments, "
+			<< network.roads.size() << " roads" << endl;
+	}
+	catch (Exception & ex)
+	{
+		cout << ex << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -1,18 +1,35 @@
 /***********************************************************
 * Author:				Levi Pomeroy
 * Date Created:			03/08/17
-* Last Mod Date:		03/09/17
+* Last Mod Date:		10/19/26
 * Lab Number:			CST 211
 * Filename:				Lab 6 - Dijkstra
 *
 * Overview:
 *	This program reads a text file, populates the graph with the 
 *	data and then calculated the shortest distance between the 
-*	vertices.
+*	vertices. Plain routes and batch jobs search a graph of integer
+*	place ids, with the names kept in a NameTable; the other modes
+*	need road names (to avoid, or to turn between) and search the
+*	graph keyed by name.
 *
 * Input:
 *	The input will consist of the users choice of the starting 
-*	and ending vertices.
+*	and ending vertices. Run with --stats to also see how much
+*	work the search did. With --format json, csv, text or binary
+*	it runs as a batch job instead: every "start,end" line read
+*	from standard input is answered in that format. With --within
+*	minutes (or --within-miles miles) it asks only for a start
+*	vertex and lists every place reachable within that budget.
+*	With --alternatives k it prints up to k different routes.
+*	With --turns file the route pays for turns: each line of the
+*	file is "from road,via,to road,miles", or "no" for miles to
+*	forbid the turn. With --pareto it prints every route that no
+*	other route beats on both miles and miles off the interstates.
+*	With --avoid road (as often as needed) the route stays off those
+*	roads, and with --interstates it keeps to the interstates where
+*	it can. With --vehicle car, truck or bus it finds the fastest
+*	route for that vehicle, at its own speeds.
 *
 * Output:
 *	The output of this program will consist of the distance from
@@ -20,10 +37,39 @@
 *	there based on the distance and speed limits.
 ************************************************************/
 #include "methods.h"
+#include "Isochrone.h"
+#include "AlternativeRoutes.h"
+#include "Components.h"
+#include "TurnTable.h"
+#include "ParetoRoutes.h"
+#include "RoadRules.h"
+#include "MaskedGraph.h"
+#include "VehicleProfiles.h"
+#include <cstdlib>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
 
-int main()
+void RunBatch(Graph<uint32_t, RoadClass> & graph, const NameTable & names, const string & format, SearchStats & stats);	//Answers start,end lines from cin
+void PrintReachable(Graph<string, string> & graph, const string & start, int budget, bool by_time, SearchStats & stats);	//Places within budget of start
+void PrintAlternatives(Graph<string, string> & graph, const string & start, const string & end, int k, SearchStats & stats);	//k shortest routes
+void PrintTurnRoute(Graph<string, string> & graph, const string & start, const string & end, const string & turns, SearchStats & stats);	//Route that pays for turns
+void PrintParetoRoutes(Graph<string, string> & graph, const string & start, const string & end, SearchStats & stats);	//Miles against miles off interstates
+void PrintRuleRoute(Graph<string, string> & graph, const string & start, const string & end, const vector<string> & avoid,
+	bool interstates, SearchStats & stats);	//Route that avoids roads or keeps to interstates
+void PrintVehicleRoute(Graph<string, string> & graph, const string & start, const string & end, const string & vehicle,
+	SearchStats & stats);	//Fastest route for a car, truck or bus
+void OpenRoute(Graph<string, string> & graph, const string & start, const string & end, CompactGraph<string, string> & compact,
+	int & source, int & target, RouteResult<string> & result);	//Compact graph and both ends, throws if either is missing
+void FillRoute(const CompactGraph<string, string> & compact, int distance, const vector<int> & path, const vector<int> & edges,
+	RouteResult<string> & result);	//Distance, stops and minutes of a route found on compact
+
+int main(int argc, char * argv[])
 {
 	Graph<string, string> graph;	//Create graph
+	Graph<uint32_t, RoadClass> places;	//Same graph by place id
+	NameTable names;				//Name of each place id
 	string edgeInfo[47][4];			//Holds the files info
 
 	try
@@ -38,22 +84,538 @@ int main()
 	try
 	{
 		PopulateGraph(edgeInfo, graph);	//Populates the graph with the info from the file
+		PopulateGraph(edgeInfo, names, places);
 	}
 	catch (Exception & ex)
 	{
 		cout << ex << endl;
 	}
 
+	string start;
+	string end;
+	string format;
+	SearchStats stats;
+	bool show_stats = false;
+	int budget = -1;
+	bool by_time = true;
+	int alternatives = 0;
+	string turns;
+	bool pareto = false;
+	vector<string> avoid;
+	bool interstates = false;
+	string vehicle;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (string(argv[i]) == "--stats")
+		{
+			show_stats = true;
+		}
+		else if (string(argv[i]) == "--format" && i + 1 < argc)
+		{
+			format = argv[++i];
+		}
+		else if ((string(argv[i]) == "--within" || string(argv[i]) == "--within-miles") && i + 1 < argc)
+		{
+			by_time = string(argv[i]) == "--within";
+			budget = atoi(argv[++i]);
+		}
+		else if (string(argv[i]) == "--alternatives" && i + 1 < argc)
+		{
+			alternatives = atoi(argv[++i]);
+		}
+		else if (string(argv[i]) == "--turns" && i + 1 < argc)
+		{
+			turns = argv[++i];
+		}
+		else if (string(argv[i]) == "--pareto")
+		{
+			pareto = true;
+		}
+		else if (string(argv[i]) == "--avoid" && i + 1 < argc)
+		{
+			avoid.push_back(argv[++i]);
+		}
+		else if (string(argv[i]) == "--interstates")
+		{
+			interstates = true;
+		}
+		else if (string(argv[i]) == "--vehicle" && i + 1 < argc)
+		{
+			vehicle = argv[++i];
+		}
+	}
+
+	if (!format.empty())
+	{
+		try
+		{
+			RunBatch(places, names, format, stats);
+		}
+		catch (Exception & ex)
+		{
+			std::cerr << ex << endl;
+			return 1;
+		}
+		if (show_stats)
+		{
+			std::cerr << stats << endl;	//Stays out of the results
+		}
+		return 0;
+	}
+
+	cout << "Start vertex: ";	//Get starting vertex 
+	getline(cin, start);
+
+	if (budget >= 0)
+	{
+		try
+		{
+			PrintReachable(graph, start, budget, by_time, stats);
+			if (show_stats)
+			{
+				cout << stats << endl;
+			}
+		}
+		catch (Exception & ex)
+		{
+			cout << ex << endl;
+		}
+		return 0;
+	}
+
+	cout << "End vertex: ";		//Get end vertex
+	getline(cin, end);
+
 	try
 	{
-		Dijkstra(graph);	//Finds the shorest path from a starting vertex to an ending vertex
+		if (alternatives > 0)
+		{
+			PrintAlternatives(graph, start, end, alternatives, stats);
+		}
+		else if (pareto)
+		{
+			PrintParetoRoutes(graph, start, end, stats);
+		}
+		else if (!turns.empty())
+		{
+			PrintTurnRoute(graph, start, end, turns, stats);
+		}
+		else if (!vehicle.empty())
+		{
+			PrintVehicleRoute(graph, start, end, vehicle, stats);
+		}
+		else if (!avoid.empty() || interstates)
+		{
+			PrintRuleRoute(graph, start, end, avoid, interstates, stats);
+		}
+		else
+		{
+			Dijkstra(places, names, start, end, &stats);	//Finds the shorest path from a starting vertex to an ending vertex
+		}
+		if (show_stats)
+		{
+			cout << stats << endl;
+		}
 	}
 	catch (Exception & ex)
 	{
 		cout << ex << endl;
 	}
 
-	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF); //Memory leak check
+#ifdef _MSC_VER
+	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF); //Memory leak check, other platforms use the sanitizer build
+#endif
 	return 0;
 }
 
+
+/**********************************************************************
+* Purpose: This function answers a batch of route queries. Each line of
+*		   standard input is "start,end"; each result is written to
+*		   standard output in format (json, csv, text or binary). Output
+*		   is left to the stream buffer, and cin is untied from cout so
+*		   reading the next query doesn't flush it. Queries are searched
+*		   by place id; names are only looked up in names.
+*
+* Precondition:	graph and names are populated.
+*
+* Postcondition: Every query is answered, bad ones are reported on cerr.
+************************************************************************/
+void RunBatch(Graph<uint32_t, RoadClass> & graph, const NameTable & names, const string & format, SearchStats & stats)
+{
+	if (format != "json" && format != "csv" && format != "text" && format != "binary")
+	{
+		throw Exception("--format must be json, csv, text or binary");
+	}
+
+	CompactGraph<uint32_t, RoadClass> compact(graph);
+	string line;
+	long long number = 0;
+
+	LabelComponents(compact, DefaultThreadCount());	//Queries between disconnected places fail without a search
+
+	std::ios::sync_with_stdio(false);
+	cin.tie(nullptr);
+#ifdef _WIN32
+	if (format == "binary")
+	{
+		_setmode(_fileno(stdout), _O_BINARY);
+	}
+#endif
+	if (format == "csv")
+	{
+		WriteRouteCsvHeader(cout);
+	}
+
+	while (getline(cin, line))
+	{
+		number++;
+		size_t comma = line.find(',');
+		if (!line.empty() && line[line.size() - 1] == '\r')
+		{
+			line.erase(line.size() - 1);
+		}
+		if (comma == string::npos)
+		{
+			std::cerr << "Line " << number << ": expected start,end\n";
+			continue;
+		}
+
+		try
+		{
+			RouteResult<string> result = FindNamedRoute(compact, names, line.substr(0, comma), line.substr(comma + 1), &stats);
+			if (format == "json")
+			{
+				WriteRouteJson(cout, result);
+			}
+			else if (format == "csv")
+			{
+				WriteRouteCsv(cout, result);
+			}
+			else if (format == "binary")
+			{
+				WriteRouteBinary(cout, result);
+			}
+			else
+			{
+				WriteRouteText(cout, result);
+			}
+		}
+		catch (Exception & ex)
+		{
+			std::cerr << "Line " << number << ": " << ex << '\n';
+		}
+	}
+	cout.flush();
+}
+
+
+/**********************************************************************
+* Purpose: This function lists every place within budget of start,
+*		   nearest first. The budget is minutes of driving (by the
+*		   default TravelTimeModel) when by_time is set, miles if not.
+*
+* Precondition:	graph is populated.
+*
+* Postcondition: The places and their costs are printed; throws if start
+*				 is not in the graph.
+************************************************************************/
+void PrintReachable(Graph<string, string> & graph, const string & start, int budget, bool by_time, SearchStats & stats)
+{
+	CompactGraph<string, string> compact(graph);
+	TravelTimeModel model;
+	vector<int> seconds = model.EdgeSeconds(compact);
+	vector<ReachedVertex> reached;
+
+	int source = compact.FindIndex(start);
+	if (source == NO_VERTEX)
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	ReachableWithin(compact, by_time ? seconds.data() : compact.GetWeights(), source, by_time ? budget * 60 : budget, reached, &stats);
+
+	cout << "\nWithin " << budget << (by_time ? " minutes" : " miles") << " of " << start << ":\n";
+	for (size_t i = 0; i < reached.size(); i++)
+	{
+		cout << compact.GetData(reached[i].vertex) << ": ";
+		if (by_time)
+		{
+			cout << reached[i].cost / 60.0 << " minutes\n";
+		}
+		else
+		{
+			cout << reached[i].cost << " miles\n";
+		}
+	}
+	cout << endl;
+}
+
+
+/**********************************************************************
+* Purpose: This function prints up to k loopless routes from start to
+*		   end, shortest first, in the same report Dijkstra() prints.
+*
+* Precondition:	graph is populated.
+*
+* Postcondition: The routes are printed; throws if start or end is not
+*				 in the graph.
+************************************************************************/
+void PrintAlternatives(Graph<string, string> & graph, const string & start, const string & end, int k, SearchStats & stats)
+{
+	CompactGraph<string, string> compact;
+	SearchWorkspace workspace;
+	RouteResult<string> result;
+	vector<AlternativeRoute> routes;
+	int source = NO_VERTEX;
+	int target = NO_VERTEX;
+
+	OpenRoute(graph, start, end, compact, source, target, result);
+	KShortestRoutes(compact, compact.GetWeights(), source, target, k, workspace, routes, &stats);
+
+	if (routes.empty())
+	{
+		cout << "\nThere is no route from " << start << " to " << end << "\n" << endl;
+	}
+	for (size_t i = 0; i < routes.size(); i++)
+	{
+		FillRoute(compact, routes[i].cost, routes[i].vertices, routes[i].edges, result);
+		cout << "\nRoute " << i + 1 << ":";
+		WriteRouteText(cout, result);
+	}
+	cout.flush();
+}
+
+
+/**********************************************************************
+* Purpose: This function prints the cheapest route from start to end
+*		   when turns cost extra, in the same report Dijkstra() prints.
+*		   The distance includes the turn costs; the time is for the
+*		   roads alone.
+*
+* Precondition:	graph is populated.
+*
+* Postcondition: The route is printed; throws if start or end is not in
+*				 the graph or the turn file can't be read.
+************************************************************************/
+void PrintTurnRoute(Graph<string, string> & graph, const string & start, const string & end, const string & turns, SearchStats & stats)
+{
+	CompactGraph<string, string> compact;
+	SearchWorkspace workspace;
+	TurnTable table;
+	RouteResult<string> result;
+	vector<int> path, edges;
+	int source = NO_VERTEX;
+	int target = NO_VERTEX;
+
+	OpenRoute(graph, start, end, compact, source, target, result);
+	table.Build(compact);
+	table.Read(compact, turns);
+
+	int distance = table.Route(compact, compact.GetWeights(), source, target, workspace, path, edges, &stats);
+	FillRoute(compact, distance, path, edges, result);
+	WriteRouteText(cout, result);
+	cout.flush();
+}
+
+
+/**********************************************************************
+* Purpose: This function prints every route from start to end that no
+*		   other route beats on both miles and miles off the
+*		   interstates, shortest first, in the same report Dijkstra()
+*		   prints.
+*
+* Precondition:	graph is populated.
+*
+* Postcondition: The routes are printed; throws if start or end is not
+*				 in the graph.
+************************************************************************/
+void PrintParetoRoutes(Graph<string, string> & graph, const string & start, const string & end, SearchStats & stats)
+{
+	CompactGraph<string, string> compact;
+	SearchWorkspace workspace;
+	RouteResult<string> result;
+	vector<ParetoRoute> routes;
+	int source = NO_VERTEX;
+	int target = NO_VERTEX;
+
+	OpenRoute(graph, start, end, compact, source, target, result);
+	vector<int> off = MilesOffInterstates(compact);
+	vector<const int *> criteria = { compact.GetWeights(), off.data() };
+	ParetoRoutes(compact, criteria, source, target, workspace, routes, PARETO_LABEL_LIMIT, &stats);
+
+	if (routes.empty())
+	{
+		cout << "\nThere is no route from " << start << " to " << end << "\n" << endl;
+	}
+	for (size_t i = 0; i < routes.size(); i++)
+	{
+		FillRoute(compact, routes[i].cost[0], routes[i].vertices, routes[i].edges, result);
+		cout << "\nRoute " << i + 1 << ", " << routes[i].cost[1] << " miles off the interstates:";
+		WriteRouteText(cout, result);
+	}
+	cout.flush();
+}
+
+
+/**********************************************************************
+* Purpose: This function prints the shortest route from start to end
+*		   that stays off the roads in avoid, in the same report
+*		   Dijkstra() prints. With interstates set it keeps to the
+*		   interstates too, leaving them only where it has to.
+*
+* Precondition:	graph is populated.
+*
+* Postcondition: The route is printed; throws if start or end is not in
+*				 the graph.
+************************************************************************/
+void PrintRuleRoute(Graph<string, string> & graph, const string & start, const string & end, const vector<string> & avoid,
+	bool interstates, SearchStats & stats)
+{
+	CompactGraph<string, string> compact;
+	SearchWorkspace workspace;
+	RoadRules<string> rules;
+	Bitmap mask;
+	RouteResult<string> result;
+	vector<int> path, edges;
+	int source = NO_VERTEX;
+	int target = NO_VERTEX;
+	int distance = INFINITE_DISTANCE;
+	bool followed = true;
+
+	OpenRoute(graph, start, end, compact, source, target, result);
+	for (size_t i = 0; i < avoid.size(); i++)
+	{
+		rules.AvoidRoad(avoid[i]);
+	}
+	if (interstates)
+	{
+		rules.OnlyClass(ROAD_INTERSTATE);
+	}
+	rules.Compile(compact, mask);
+	MaskedGraph<string, string> masked(compact, mask);
+
+	if (interstates)
+	{
+		distance = masked.RouteWherePossible(source, target, MASK_PENALTY, workspace, path, &followed, &stats);
+		masked.SetPenalty(followed ? 0 : MASK_PENALTY);	//The view the route was found in, to look up its edges
+	}
+	else
+	{
+		distance = ShortestRouteOver(masked, source, target, workspace, path, &stats);
+	}
+	if (!path.empty())
+	{
+		masked.PathWeight(path, &edges, nullptr);
+	}
+	FillRoute(compact, distance, path, edges, result);
+	if (!followed)
+	{
+		cout << "\nThere is no route on the interstates alone; this one leaves them as little as it can.";
+	}
+	WriteRouteText(cout, result);
+	cout.flush();
+}
+
+
+/**********************************************************************
+* Purpose: This function prints the fastest route from start to end for
+*		   a vehicle ("car", "truck" or "bus", see
+*		   VehicleProfiles::AddDefaultProfiles()), in the same report
+*		   Dijkstra() prints, timed at the vehicle's speeds.
+*
+* Precondition:	graph is populated.
+*
+* Postcondition: The route is printed; throws if start, end or the
+*				 vehicle is unknown.
+************************************************************************/
+void PrintVehicleRoute(Graph<string, string> & graph, const string & start, const string & end, const string & vehicle,
+	SearchStats & stats)
+{
+	CompactGraph<string, string> compact;
+	VehicleProfiles profiles;
+	SearchWorkspace workspace;
+	RouteResult<string> result;
+	vector<int> path, edges;
+	int source = NO_VERTEX;
+	int target = NO_VERTEX;
+
+	OpenRoute(graph, start, end, compact, source, target, result);
+	profiles.AddDefaultProfiles(compact);
+	int profile = profiles.GetProfile(vehicle);
+
+	int seconds = profiles.Route(compact, profile, source, target, workspace, path, edges, &stats);
+	int miles = 0;
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		miles += compact.GetWeight(edges[i]);
+	}
+	FillRoute(compact, seconds == INFINITE_DISTANCE ? INFINITE_DISTANCE : miles, path, edges, result);
+	if (seconds != INFINITE_DISTANCE)
+	{
+		result.minutes = seconds / 60.0;	//At the vehicle's speeds, not the default model's
+	}
+	WriteRouteText(cout, result);
+	cout.flush();
+}
+
+
+/**********************************************************************
+* Purpose: This function sets up a query from start to end: it flattens
+*		   graph into compact, finds both ends in it and starts result
+*		   with their names.
+*
+* Precondition:	graph is populated.
+*
+* Postcondition: compact, source, target and result's start and end are
+*				 set; throws if start or end is not in the graph.
+************************************************************************/
+void OpenRoute(Graph<string, string> & graph, const string & start, const string & end, CompactGraph<string, string> & compact,
+	int & source, int & target, RouteResult<string> & result)
+{
+	compact.Build(graph);
+	source = compact.FindIndex(start);
+	target = compact.FindIndex(end);
+	if (source == NO_VERTEX)
+	{
+		throw Exception("Starting vertex is not in the graph!");
+	}
+	if (target == NO_VERTEX)
+	{
+		throw Exception("Ending vertex is not in the graph!");
+	}
+	result = RouteResult<string>();
+	result.start = start;
+	result.end = end;
+}
+
+
+/**********************************************************************
+* Purpose: This function fills result with a route found on compact: its
+*		   distance, its stops, and its time by the default
+*		   TravelTimeModel over the edges it takes.
+*
+* Precondition:	path and edges are the route's vertices and edge ids,
+*				both empty if there is none; result came from
+*				OpenRoute().
+*
+* Postcondition: result holds the route, replacing any route before it.
+************************************************************************/
+void FillRoute(const CompactGraph<string, string> & compact, int distance, const vector<int> & path, const vector<int> & edges,
+	RouteResult<string> & result)
+{
+	TravelTimeModel model;
+
+	result.distance = distance;
+	result.path = path;
+	result.stops.clear();
+	result.minutes = 0;
+	for (size_t i = 0; i < path.size(); i++)
+	{
+		result.stops.push_back(compact.GetData(path[i]));
+	}
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		result.minutes += model.GetMinutes(compact.GetEdgeData(edges[i]), compact.GetWeight(edges[i]));
+	}
+}
@@ -5,14 +5,29 @@
 * Modifications:	3/8/17  Fixed populate graph 
 *					3/8/17 - Added print funtions
 *					3/9/17 - Fixed, so works with mutiple.
+*					10/19/26 - Removed string sentinels, added integer id graph.
+*					10/19/26 - Builds outside of Visual Studio.
+*					10/19/26 - Dijkstra resets processed flags when done.
+*					10/19/26 - Dijkstra can count its work into a SearchStats.
+*					10/19/26 - DistanceAndPath builds a RouteResult, then prints it.
+*					10/19/26 - Time estimates come from a TravelTimeModel.
+*					10/19/26 - Dijkstra can route the id graph by name.
 **************************************************************/
 #include <iostream>
 #include <vector>
 #include <climits>
+#ifdef _MSC_VER
 #include <crtdbg.h>
+#endif
 #include "Graph.h"
+#include "VertexKey.h"
+#include "RoadClass.h"
+#include "NameTable.h"
+#include "SearchStats.h"
+#include "RouteResult.h"
 #include<fstream>
 #include <string>
+#include <cstdint>
 using std::cout;
 using std::endl;
 using std::cin;
@@ -27,8 +42,16 @@ void ReadLine(string edgeInfo[][4]);	//Reads text file
 template <typename V, typename E>
 void PopulateGraph(string edgeInfo[][4], Graph<V, E> & graph);	//Fill graph with data
 
+void PopulateGraph(string edgeInfo[][4], NameTable & names, Graph<uint32_t, RoadClass> & graph);	//Fill id graph, names go in the table
+
+template <typename V, typename E>
+void Dijkstra(Graph<V, E> & graph, V start, V end, SearchStats * stats = nullptr);	//Calculate the min distance
+
+void Dijkstra(Graph<uint32_t, RoadClass> & graph, const NameTable & names, const string & start, const string & end,
+	SearchStats * stats = nullptr);	//Same on the id graph, looked up and printed by name
+
 template <typename V, typename E>
-void Dijkstra(Graph<V, E> & graph);	//Calculate the min distance
+RouteResult<V> DijkstraRoute(Graph<V, E> & graph, V start, V end, SearchStats * stats = nullptr);	//The route Dijkstra prints
 
 template <typename V, typename E>
 int GetIndex(Graph<V, E> & graph, V data);	//Finds index of vertex to be used in array
@@ -43,7 +66,7 @@ template <typename V, typename E>
 bool Done(Graph<V, E> & graph);	//Returns whether or not the graph is done being processed
 
 template <typename V, typename E>
-void DistanceAndPath(Graph<V, E> & graph, Vertex<V, E> end, int dist[], V pred[]);	//Prints the distance, path and time from a to b
+RouteResult<V> DistanceAndPath(Graph<V, E> & graph, Vertex<V, E> end, int dist[], V pred[]);	//The distance, path and time from a to b
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -123,18 +146,79 @@ void PopulateGraph(string edgeInfo[][4], Graph<V, E> & graph)
 	}
 }
 
+/**********************************************************************
+* Purpose: This function populates the integer id graph with the 2d array
+*		   of info read in from the text file. Place names are given ids
+*		   in names, and road names are reduced to their class.
+*
+* Precondition:	Graph and names are empty.
+*
+* Postcondition: Graph is full of info from text file, names holds the
+*				 name of every id.
+************************************************************************/
+inline void PopulateGraph(string edgeInfo[][4], NameTable & names, Graph<uint32_t, RoadClass> & graph)
+{
+	for (int i = 0; i < 47; i++)
+	{
+		uint32_t from = names.Intern(edgeInfo[i][0]);
+		uint32_t to = names.Intern(edgeInfo[i][1]);
+
+		graph.InsertVertex(from);	//Add first vertex
+		graph.InsertVertex(to);		//Add second vertex
+		graph.AddEdge(from, to, ClassifyRoad(edgeInfo[i][2]), stoi(edgeInfo[i][3]));	//Add edge between them
+	}
+}
+
+/**********************************************************************
+* Purpose: This function prints the route from start to end that
+*		   DijkstraRoute() finds.
+*
+* Precondition:	N/A
+*
+* Postcondition: Distance, path and time is printed. One query is added
+*				 to stats if it is given.
+************************************************************************/
+template<typename V, typename E>
+void Dijkstra(Graph<V, E> & graph, V start, V end, SearchStats * stats)
+{
+	WriteRouteText(cout, DijkstraRoute(graph, start, end, stats));
+	cout.flush();
+}
+
+/**********************************************************************
+* Purpose: This function prints the route between two places on the
+*		   integer id graph. The names are only looked up in names, on
+*		   the way in and on the way out; the search sees ids alone.
+*
+* Precondition:	graph and names were filled by the same PopulateGraph().
+*
+* Postcondition: The route is printed with place names, exactly as the
+*				 string graph prints it. One query is added to stats if
+*				 it is given.
+************************************************************************/
+inline void Dijkstra(Graph<uint32_t, RoadClass> & graph, const NameTable & names, const string & start, const string & end,
+	SearchStats * stats)
+{
+	WriteRouteText(cout, NameRoute(DijkstraRoute(graph, names.Find(start), names.Find(end), stats), names));
+	cout.flush();
+}
+
 /**********************************************************************
 * Purpose: This function reads the graph and calculates the minimium 
 *		   distance from the starting vertex to every other vertex in
-*		   the graph.
+*		   the graph, then builds the route from start to end. There is
+*		   no queue, the next vertex is found by a scan, so a vertex
+*		   counts as pushed the first time it gets a distance and as
+*		   popped when the scan picks it.
 *
 * Precondition:	N/A
 *
 * Postcondition: Minimium distance from starting node to other nodes is
-*				 calculated.
+*				 calculated and the route is returned. One query is
+*				 added to stats if it is given.
 ************************************************************************/
 template<typename V, typename E>
-void Dijkstra(Graph<V, E> & graph)
+RouteResult<V> DijkstraRoute(Graph<V, E> & graph, V start, V end, SearchStats * stats)
 {
 	if (graph.GetCount() == 0)
 	{
@@ -144,27 +228,24 @@ void Dijkstra(Graph<V, E> & graph)
 	const int SIZE = graph.GetCount();	//Size of graph
 	int * distance = new int[SIZE];		//Arrays size of number of vetices in graph
 	V * pred = new V[SIZE];				//Holds the predessors of each vertex
-	string start;
-	string end;
 
-	for (int i = 0; i < SIZE; i++)	//Initialize everything to negative one
+	for (int i = 0; i < SIZE; i++)	//Initialize everything to negative one / no vertex
 	{
 		distance[i] = -1;
-		pred[i] = "-1";
+		pred[i] = KeyTraits<V>::None();
 	}
 
-	cout << "Start vertex: ";	//Get starting vertex 
-	getline(cin,start);
-
-	cout << "End vertex: ";		//Get end vertex
-	getline(cin, end);
 	if (start == end)
 	{
+		delete[] distance;
+		delete[] pred;
 		throw Exception("Distance: 0\nPath: You are literally already there\nTime: 0");
 	}
 	Vertex<V, E> * temp = nullptr;
 	Vertex<V, E> current;
 	Vertex<V, E> evert;
+	SearchStats counts;
+	counts.lookupSeconds -= StatsClock();	//Phase timers start negative and add the end time
 	
 	bool sfound = false;
 	bool efound = false;
@@ -172,7 +253,7 @@ void Dijkstra(Graph<V, E> & graph)
 	int sindex = 0;
 
 	//Checks if starting and ending vertices are in graph and finds index
-	for (list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); (sfound != true || efound != true) && viter != graph.GetVertices().end(); ++viter)
+	for (typename list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); (sfound != true || efound != true) && viter != graph.GetVertices().end(); ++viter)
 	{
 		temp = &(*viter);
 		if (temp->GetData() == start)
@@ -202,14 +283,20 @@ void Dijkstra(Graph<V, E> & graph)
 		throw Exception("Ending vertex is not in the graph!");
 	}
 	distance[sindex] = 0; //Distance from the starting point is always 0
+	counts.lookupSeconds += StatsClock();
+	counts.searchSeconds -= StatsClock();
+	STATS_ADD(counts.pushes, 1);
 
 	//Main loop to calculate distances
 	while (!Done(graph))
 	{
 		Edge<V, E> * etemp;
 		int index = -1;
+		STATS_ADD(counts.pops, 1);
+		STATS_ADD(counts.settled, 1);
+		STATS_ADD(counts.relaxed, current.GetEdges().size());
 
-		for (list<Edge<V, E>>::iterator eiter = current.GetEdges().begin(); eiter != current.GetEdges().end(); eiter++)
+		for (typename list<Edge<V, E>>::iterator eiter = current.GetEdges().begin(); eiter != current.GetEdges().end(); eiter++)
 		{
 			etemp = &(*eiter);
 			if (etemp->GetDestination()->GetProcessed() != true)
@@ -217,6 +304,8 @@ void Dijkstra(Graph<V, E> & graph)
 				index = GetIndex(graph, etemp->GetDestination()->GetData());
 				if (distance[index] == -1 || distance[index] > etemp->GetWeight() + distance[sindex])	//if -1 or smaller
 				{
+					STATS_ADD(counts.pushes, 1);
+					STATS_ADD(counts.decreaseKeys, distance[index] == -1 ? 0 : 1);
 					pred[index] = current.GetData();
 					distance[index] = etemp->GetWeight() + distance[sindex];
 				}
@@ -226,10 +315,23 @@ void Dijkstra(Graph<V, E> & graph)
 		FindNext(distance, graph, current);	//Finds the next eligible vertex
 		sindex = GetIndex(graph, current.GetData());
 	}
+	graph.Reset();	//Reset processed flags so the graph can be queried again
+	counts.searchSeconds += StatsClock();
+	counts.reconstructSeconds -= StatsClock();
 
-	DistanceAndPath(graph, evert, distance, pred);	//Prints distance and path and time from point a to b
+	RouteResult<V> result = DistanceAndPath(graph, evert, distance, pred);	//Distance and path and time from point a to b
 	delete[] distance;
 	delete[] pred;
+
+#if ROUTING_STATS
+	if (stats != nullptr)
+	{
+		counts.queries = 1;
+		counts.reconstructSeconds += StatsClock();
+		stats->Add(counts);
+	}
+#endif
+	return result;
 }
 
 /**********************************************************************
@@ -248,7 +350,7 @@ int GetIndex(Graph<V, E> & graph, V data)
 	bool found = false;
 	Vertex<V, E> * temp = nullptr;
 
-	for (list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); !found && viter != graph.GetVertices().end(); ++viter)
+	for (typename list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); !found && viter != graph.GetVertices().end(); ++viter)
 	{
 		temp = &(*viter);
 		if (temp->GetData() == data)
@@ -284,7 +386,7 @@ void FindNext(int distance[], Graph<V, E>& graph, Vertex<V, E> & cur)
 
 	Vertex<V, E> * temp = nullptr;
 
-	for (list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); viter != graph.GetVertices().end(); ++viter)
+	for (typename list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); viter != graph.GetVertices().end(); ++viter)
 	{
 		temp = &(*viter);
 		if (temp->GetProcessed() == false)	//Unprocessed
@@ -315,7 +417,7 @@ inline void SetProcessed(Graph<V, E> & graph, Vertex<V, E> cur)
 	Vertex<V, E> * temp = nullptr;
 	bool found = false;
 
-	for (list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); !found && viter != graph.GetVertices().end(); ++viter)
+	for (typename list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); !found && viter != graph.GetVertices().end(); ++viter)
 	{
 		temp = &(*viter);
 		if (cur.GetData() == temp->GetData())
@@ -340,7 +442,7 @@ inline bool Done(Graph<V, E>& graph)
 	bool done = true;
 	Vertex<V, E> * temp = nullptr;
 
-	for (list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); viter != graph.GetVertices().end(); ++viter)
+	for (typename list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); viter != graph.GetVertices().end(); ++viter)
 	{
 		temp = &(*viter);
 		if (temp->GetProcessed() == false)
@@ -352,92 +454,58 @@ inline bool Done(Graph<V, E>& graph)
 }
 
 /**********************************************************************
-* Purpose: This function prints the distance from the starting vertex
-*		   to the ending vertex, the path to get there, and the estimated 
-*		   time to do so.
+* Purpose: This function builds the route from the starting vertex to
+*		   the ending vertex out of the distance and predecessor arrays:
+*		   the distance, the path to get there, and the estimated time
+*		   to do so.
 *
 * Precondition:	N/A
 *
-* Postcondition: Distance, path and time is printed.
+* Postcondition: Distance, path and time are returned.
 ************************************************************************/
 template<typename V, typename E>
-inline void DistanceAndPath(Graph<V, E>& graph, Vertex<V, E> end, int dist[], V pred[])
+inline RouteResult<V> DistanceAndPath(Graph<V, E>& graph, Vertex<V, E> end, int dist[], V pred[])
 {
-	vector<V> path;
-	double time = 0;
+	RouteResult<V> result;
+	TravelTimeModel model;	//65 mph on interstates, 55 mph elsewhere
 	int index = GetIndex(graph, end.GetData());
-	V stop_condition = "-1";
-	cout << "\nDistance: " << dist[index] << endl;	//Prints total distance
+	V stop_condition = KeyTraits<V>::None();
+
+	result.end = end.GetData();
+	result.distance = dist[index] == -1 ? INFINITE_DISTANCE : dist[index];
 
 	//************************** Calculate path **********************************
-	cout << "Path: " << endl;
-	path.push_back(end.GetData());
+	result.stops.push_back(end.GetData());
+	result.path.push_back(index);
 	while (pred[index] != stop_condition)
 	{
-		Vertex<V, E> * temp = nullptr;
-
-		//Finds path
-		for (list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); viter != graph.GetVertices().end(); ++viter)
-		{
-			temp = &(*viter);
-			if (temp->GetData() == pred[index])
-			{
-				path.push_back(pred[index]);
-				index = GetIndex(graph, temp->GetData());
-			}
-		}
+		result.stops.push_back(pred[index]);
+		index = GetIndex(graph, pred[index]);
+		result.path.push_back(index);
 	}
-
-	//Prints path
-	for (int i = path.size()-1; i >= 0; i--)
-	{
-		if (i > 0)
-		{
-			cout << path[i] << " to " << endl;
-		}
-		else
-		{
-			cout << path[i] << endl;
-		}
-	}
-	cout << endl;
+	std::reverse(result.stops.begin(), result.stops.end());
+	std::reverse(result.path.begin(), result.path.end());
+	result.start = result.stops.front();
 
 	//************************** Calculate time **********************************
-	bool found = false;
-	Vertex<V, E> * temp = nullptr;
-	Vertex<V, E> current;
-	Edge<V, E> * etemp = nullptr;
-	for (int i = path.size() - 1; i >= 0; i--)
+	for (size_t i = 0; result.IsReachable() && i + 1 < result.stops.size(); i++)
 	{
-		found = false;
-		for (list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); i>0 && !found && viter != graph.GetVertices().end(); ++viter)
+		Edge<V, E> * best = nullptr;	//Shortest edge to the next stop, the one the route uses
+		for (typename list<Vertex<V, E>>::iterator viter = graph.GetVertices().begin(); best == nullptr && viter != graph.GetVertices().end(); ++viter)
 		{
-			temp = &(*viter);
-			if (temp->GetData() == path[i])
+			if (viter->GetData() == result.stops[i])
 			{
-				found = true;
-				current = *temp;
-
-				for (list<Edge<V, E>>::iterator eiter = current.GetEdges().begin(); eiter != current.GetEdges().end(); ++eiter)
+				for (typename list<Edge<V, E>>::iterator eiter = viter->GetEdges().begin(); eiter != viter->GetEdges().end(); ++eiter)
 				{
-					etemp = &(*eiter);
-					if (etemp->GetDestination()->GetData() == path[i - 1])
+					if (eiter->GetDestination()->GetData() == result.stops[i + 1] && (best == nullptr || eiter->GetWeight() < best->GetWeight()))
 					{
-						if (etemp->GetData() == "I-5")
-						{
-							time += ((double)etemp->GetWeight() / (double)65);
-						}
-						else	//Any other road
-						{
-							time += ((double)etemp->GetWeight() / (double)55);
-						}
+						best = &(*eiter);
 					}
 				}
 			}
 		}
+		result.minutes += model.GetMinutes(best->GetData(), best->GetWeight());
 	}
-	time *= 60;	//Convert to minutes
-	cout << "Estimated time: " << time << " minutes" << endl;
-	cout << "or about " << time / 60 << " hours" << "\n\n";
+	return result;
 }
 
@@ -0,0 +1,1689 @@
+/***********************************************************
+* Filename:				tests.cpp
+* Date Created:			10/19/26
+* Last Mod Date:		10/19/26
+*
+* Overview:
+*	Checks every engine against brute force on small random
+*	road networks from a fixed seed. The networks have zero
+*	mile segments, parallel segments and loops from a place back
+*	to itself, the cases the engines break on first. Distances
+*	are checked against Bellman-Ford, predecessors and paths
+*	against the edges they claim to follow.
+*
+* Input:
+*	new.txt in the working directory, for the place id and graph
+*	copy checks.
+*
+* Output:
+*	One line per group of checks, and an exit code of 1 if any
+*	of them failed.
+************************************************************/
+#include <cstdio>
+#include <iostream>
+#include <algorithm>
+#include "ShortestPaths.h"
+#include "DeltaStepping.h"
+#include "RoadNetwork.h"
+#include "RouteResult.h"
+#include "Isochrone.h"
+#include "AlternativeRoutes.h"
+#include "Components.h"
+#include "ParallelBfs.h"
+#include "Visitor.h"
+#include "ScenarioGraph.h"
+#include "Landmarks.h"
+#include "CellOverlay.h"
+#include "TurnTable.h"
+#include "ParetoRoutes.h"
+#include "RoadRules.h"
+#include "MaskedGraph.h"
+#include "VehicleProfiles.h"
+#include "ExternalGraph.h"
+#include "CompressedGraph.h"
+#include "Reordering.h"
+#include "RelaxKernel.h"
+#include "methods.h"
+using std::cout;
+using std::endl;
+
+typedef CompactGraph<string, string> TestGraph;
+
+const int TEST_NETWORKS = 200;	//Random networks per group of checks
+const int TEST_PLACES = 9;		//Most places in a network
+
+RoadNetwork RandomNetwork(unsigned long long & state, int places);	//Up to places places, zero miles, parallels and loops
+vector<int> BruteDistances(const TestGraph & graph, const int * weights, int source);	//Bellman-Ford
+int PathWeight(const TestGraph & graph, const int * weights, const vector<int> & path);	//Lightest edges along path
+bool IsPathTree(const TestGraph & graph, const int * weights, int source, const int * distance, const int * pred);	//pred follows shortest edges back to source
+int BruteTurnCost(const TestGraph & graph, const TurnTable & turns, int source, int target);	//Bellman-Ford over edges
+int TurnRouteCost(const TestGraph & graph, const TurnTable & turns, int source, const vector<int> & edges);	//Weights and turns along edges
+void BruteParetoFront(const TestGraph & graph, const vector<const int *> & criteria, int vertex, int target,
+	vector<int> & cost, vector<char> & visited, vector<vector<int>> & front);	//Every simple path to target
+void BruteRouteCosts(const TestGraph & graph, int vertex, int target, int cost, vector<char> & visited,
+	vector<int> & costs);	//Cost of every simple path to target, one per choice of edges
+bool Report(const string & name, bool passed);	//Prints the result of a group
+
+bool TestEngines();
+bool TestZeroWeightTies();
+bool TestVisitors();
+#ifdef RELAX_X86
+bool TestRelaxKernels();
+#endif
+bool TestParallel();
+bool TestIsochrones();
+bool TestComponents();
+bool TestAlternatives();
+bool TestLandmarks();
+bool TestScenarios();
+bool TestOverlay();
+bool TestTurns();
+bool TestPareto();
+bool TestRoadRules();
+bool TestProfiles();
+bool TestExternal();
+bool TestCompressed();
+bool TestReordering();
+bool TestRoadFiles();
+bool TestPlaceIds();
+bool TestGraphCopies();
+
+int main()
+{
+	bool passed = true;
+
+	try
+	{
+		passed = Report("engines", TestEngines()) && passed;
+		passed = Report("zero weight ties", TestZeroWeightTies()) && passed;
+		passed = Report("visitors", TestVisitors()) && passed;
+#ifdef RELAX_X86
+		if (CpuHasAvx2())
+		{
+			passed = Report("relax kernels", TestRelaxKernels()) && passed;
+		}
+		else
+		{
+			cout << "relax kernels: skipped, no AVX2" << endl;
+		}
+#endif
+		passed = Report("parallel engines", TestParallel()) && passed;
+		passed = Report("isochrones", TestIsochrones()) && passed;
+		passed = Report("components", TestComponents()) && passed;
+		passed = Report("alternatives", TestAlternatives()) && passed;
+		passed = Report("landmarks", TestLandmarks()) && passed;
+		passed = Report("scenarios", TestScenarios()) && passed;
+		passed = Report("cell overlay", TestOverlay()) && passed;
+		passed = Report("turns", TestTurns()) && passed;
+		passed = Report("pareto", TestPareto()) && passed;
+		passed = Report("road rules", TestRoadRules()) && passed;
+		passed = Report("vehicle profiles", TestProfiles()) && passed;
+		passed = Report("external graph", TestExternal()) && passed;
+		passed = Report("compressed graph", TestCompressed()) && passed;
+		passed = Report("reordering", TestReordering()) && passed;
+		passed = Report("road files", TestRoadFiles()) && passed;
+		passed = Report("place ids", TestPlaceIds()) && passed;
+		passed = Report("graph copies", TestGraphCopies()) && passed;
+	}
+	catch (Exception & ex)
+	{
+		cout << ex << endl;
+		passed = false;
+	}
+
+	cout << (passed ? "All tests passed" : "Some tests FAILED") << endl;
+	return passed ? 0 : 1;
+}
+
+/**********************************************************************
+* Purpose: This function makes a random network of 1 to places places.
+*		   Segments are 0 to 4 miles on four roads of every class, and
+*		   the same places can be joined twice or a place to itself.
+*
+* Precondition:	places is 1 or more.
+*
+* Postcondition: state is advanced and the network is returned.
+************************************************************************/
+RoadNetwork RandomNetwork(unsigned long long & state, int places)
+{
+	RoadNetwork network;
+	network.roads = { "I-5", "Hwy 97", "Hwy 140", "Dead Indian Memorial Road" };
+	network.count = 1 + static_cast<int>(NextRandom(state, places));
+
+	int segments = static_cast<int>(NextRandom(state, 2 * places));
+	for (int i = 0; i < segments; i++)
+	{
+		network.from.push_back(static_cast<int>(NextRandom(state, network.count)));
+		network.to.push_back(static_cast<int>(NextRandom(state, network.count)));
+		network.road.push_back(static_cast<int>(NextRandom(state, 4)));
+		network.miles.push_back(static_cast<int>(NextRandom(state, 5)));
+	}
+	return network;
+}
+
+/**********************************************************************
+* Purpose: This function finds the distance from source to every vertex
+*		   by relaxing every edge until nothing changes.
+*
+* Precondition:	weights holds a weight of 0 or more per edge id.
+*
+* Postcondition: The distances are returned, INFINITE_DISTANCE where
+*				 source can't reach.
+************************************************************************/
+vector<int> BruteDistances(const TestGraph & graph, const int * weights, int source)
+{
+	vector<int> distance(graph.GetVertexCount(), INFINITE_DISTANCE);
+	bool changed = true;
+
+	distance[source] = 0;
+	while (changed)
+	{
+		changed = false;
+		for (int from = 0; from < graph.GetVertexCount(); from++)
+		{
+			for (int edge = graph.GetEdgeBegin(from); edge != graph.GetEdgeEnd(from) && distance[from] != INFINITE_DISTANCE; ++edge)
+			{
+				if (distance[from] + weights[edge] < distance[graph.GetTarget(edge)])
+				{
+					distance[graph.GetTarget(edge)] = distance[from] + weights[edge];
+					changed = true;
+				}
+			}
+		}
+	}
+	return distance;
+}
+
+/**********************************************************************
+* Purpose: This function returns the weight of a path, taking the
+*		   lightest edge between each pair of stops.
+*
+* Precondition:	N/A
+*
+* Postcondition: The weight is returned, INFINITE_DISTANCE if two stops
+*				 are not joined.
+************************************************************************/
+int PathWeight(const TestGraph & graph, const int * weights, const vector<int> & path)
+{
+	int total = 0;
+
+	for (size_t i = 1; i < path.size() && total != INFINITE_DISTANCE; i++)
+	{
+		int lightest = INFINITE_DISTANCE;
+		for (int edge = graph.GetEdgeBegin(path[i - 1]); edge != graph.GetEdgeEnd(path[i - 1]); ++edge)
+		{
+			if (graph.GetTarget(edge) == path[i] && weights[edge] < lightest)
+			{
+				lightest = weights[edge];
+			}
+		}
+		total = lightest == INFINITE_DISTANCE ? INFINITE_DISTANCE : total + lightest;
+	}
+	return total;
+}
+
+/**********************************************************************
+* Purpose: This function checks that pred is a shortest path tree for
+*		   distance: every reached vertex but source has an edge from its
+*		   predecessor that lies on a shortest path, and following
+*		   predecessors always ends at source.
+*
+* Precondition:	distance holds final distances from source.
+*
+* Postcondition: true is returned if the tree holds.
+************************************************************************/
+bool IsPathTree(const TestGraph & graph, const int * weights, int source, const int * distance, const int * pred)
+{
+	bool valid = pred[source] == NO_VERTEX;
+
+	for (int v = 0; v < graph.GetVertexCount() && valid; v++)
+	{
+		if (v != source && distance[v] != INFINITE_DISTANCE)
+		{
+			int from = pred[v];
+			valid = false;
+			for (int edge = from == NO_VERTEX ? 0 : graph.GetEdgeBegin(from); from != NO_VERTEX && edge != graph.GetEdgeEnd(from); ++edge)
+			{
+				valid = valid || (graph.GetTarget(edge) == v && distance[from] + weights[edge] == distance[v]);
+			}
+			int steps = 0;
+			for (int at = v; at != NO_VERTEX && valid; at = pred[at])
+			{
+				valid = ++steps <= graph.GetVertexCount() && (pred[at] != NO_VERTEX || at == source);
+			}
+		}
+	}
+	return valid;
+}
+
+/**********************************************************************
+* Purpose: This function finds the cheapest cost from source to target
+*		   with turns by Bellman-Ford over edges: the cost of an edge is
+*		   the cheapest way to arrive along it, so every turn is priced
+*		   from the edge it comes in on.
+*
+* Precondition:	turns was built and compiled for graph.
+*
+* Postcondition: The cost is returned, INFINITE_DISTANCE if there is no
+*				 route.
+************************************************************************/
+int BruteTurnCost(const TestGraph & graph, const TurnTable & turns, int source, int target)
+{
+	vector<int> arrive(graph.GetEdgeCount(), INFINITE_DISTANCE);
+	int best = source == target ? 0 : INFINITE_DISTANCE;
+
+	for (int out = graph.GetEdgeBegin(source); out != graph.GetEdgeEnd(source); ++out)
+	{
+		arrive[out] = graph.GetWeight(out);
+	}
+	for (bool changed = true; changed; )
+	{
+		changed = false;
+		for (int in = 0; in < graph.GetEdgeCount(); in++)
+		{
+			int via = graph.GetTarget(in);
+			for (int out = graph.GetEdgeBegin(via); arrive[in] != INFINITE_DISTANCE && out != graph.GetEdgeEnd(via); ++out)
+			{
+				int turn = turns.GetTurnCost(via, in, out);
+				if (turn != TURN_FORBIDDEN && arrive[in] + turn + graph.GetWeight(out) < arrive[out])
+				{
+					arrive[out] = arrive[in] + turn + graph.GetWeight(out);
+					changed = true;
+				}
+			}
+		}
+	}
+	for (int edge = 0; edge < graph.GetEdgeCount(); edge++)
+	{
+		if (graph.GetTarget(edge) == target && arrive[edge] < best)
+		{
+			best = arrive[edge];
+		}
+	}
+	return best;
+}
+
+/**********************************************************************
+* Purpose: This function returns what a route costs with turns: the
+*		   weight of each edge plus each turn between them.
+*
+* Precondition:	turns was built and compiled for graph.
+*
+* Postcondition: The cost is returned, INFINITE_DISTANCE if the edges do
+*				 not join up from source or take a forbidden turn.
+************************************************************************/
+int TurnRouteCost(const TestGraph & graph, const TurnTable & turns, int source, const vector<int> & edges)
+{
+	int total = 0;
+
+	for (size_t i = 0; i < edges.size() && total != INFINITE_DISTANCE; i++)
+	{
+		int via = i == 0 ? source : graph.GetTarget(edges[i - 1]);
+		int turn = i == 0 ? 0 : turns.GetTurnCost(via, edges[i - 1], edges[i]);
+		bool leaves = edges[i] >= graph.GetEdgeBegin(via) && edges[i] < graph.GetEdgeEnd(via);
+		total = leaves && turn != TURN_FORBIDDEN ? total + turn + graph.GetWeight(edges[i]) : INFINITE_DISTANCE;
+	}
+	return total;
+}
+
+/**********************************************************************
+* Purpose: This function walks every simple path from vertex to target
+*		   and keeps the costs no other path beats or ties on all of
+*		   criteria. A route with a loop is never needed, since leaving
+*		   the loop out costs no more on any criterion.
+*
+* Precondition:	cost holds the cost so far on each criterion, visited
+*				marks the vertices on the path so far.
+*
+* Postcondition: front holds the costs of the Pareto front found so far;
+*				 cost and visited are as they were.
+************************************************************************/
+void BruteParetoFront(const TestGraph & graph, const vector<const int *> & criteria, int vertex, int target,
+	vector<int> & cost, vector<char> & visited, vector<vector<int>> & front)
+{
+	const int COUNT = static_cast<int>(criteria.size());
+
+	if (vertex == target)
+	{
+		bool dominated = false;
+		for (size_t i = 0; i < front.size() && !dominated; i++)
+		{
+			dominated = Dominates(front[i].data(), cost.data(), COUNT);
+		}
+		if (!dominated)
+		{
+			for (size_t i = front.size(); i-- > 0; )
+			{
+				if (Dominates(cost.data(), front[i].data(), COUNT))
+				{
+					front.erase(front.begin() + i);
+				}
+			}
+			front.push_back(cost);
+		}
+		return;
+	}
+	visited[vertex] = 1;
+	for (int edge = graph.GetEdgeBegin(vertex); edge != graph.GetEdgeEnd(vertex); ++edge)
+	{
+		int to = graph.GetTarget(edge);
+		if (!visited[to])
+		{
+			for (int c = 0; c < COUNT; c++)
+			{
+				cost[c] += criteria[c][edge];
+			}
+			BruteParetoFront(graph, criteria, to, target, cost, visited, front);
+			for (int c = 0; c < COUNT; c++)
+			{
+				cost[c] -= criteria[c][edge];
+			}
+		}
+	}
+	visited[vertex] = 0;
+}
+
+/**********************************************************************
+* Purpose: This function walks every simple path from vertex to target
+*		   and keeps the cost of each. Paths through the same places on
+*		   different parallel roads are different paths.
+*
+* Precondition:	cost is the cost so far, visited marks the vertices on
+*				the path so far.
+*
+* Postcondition: costs holds one more cost per path found; visited is as
+*				 it was.
+************************************************************************/
+void BruteRouteCosts(const TestGraph & graph, int vertex, int target, int cost, vector<char> & visited, vector<int> & costs)
+{
+	if (vertex == target)
+	{
+		costs.push_back(cost);
+		return;
+	}
+	visited[vertex] = 1;
+	for (int edge = graph.GetEdgeBegin(vertex); edge != graph.GetEdgeEnd(vertex); ++edge)
+	{
+		if (!visited[graph.GetTarget(edge)])
+		{
+			BruteRouteCosts(graph, graph.GetTarget(edge), target, cost + graph.GetWeight(edge), visited, costs);
+		}
+	}
+	visited[vertex] = 0;
+}
+
+/**********************************************************************
+* Purpose: This function prints whether a group of checks passed.
+*
+* Precondition:	N/A
+*
+* Postcondition: passed is returned.
+************************************************************************/
+bool Report(const string & name, bool passed)
+{
+	cout << name << ": " << (passed ? "ok" : "FAILED") << endl;
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks the single source engines, the searches
+*		   over ForEachEdge and the point to point queries against
+*		   brute force from every source.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestEngines()
+{
+	unsigned long long state = 26;
+	bool passed = true;
+	SearchWorkspace workspace;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		const int * weights = graph.GetWeights();
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(graph, weights, source);
+			vector<int> distance, pred, path;
+
+			ShortestPathsWith<BinaryHeap<int>>(graph, source, distance, pred);
+			passed = distance == expected && IsPathTree(graph, weights, source, distance.data(), pred.data());
+			ShortestPathsWith<RadixHeap<int>>(graph, source, distance, pred);
+			passed = passed && distance == expected && IsPathTree(graph, weights, source, distance.data(), pred.data());
+			DeltaStepping(graph, source, 1 + NextRandom(state, 4), 1 + NextRandom(state, 4), distance, pred);
+			passed = passed && distance == expected && IsPathTree(graph, weights, source, distance.data(), pred.data());
+
+			ShortestPathsOver(graph, source, workspace);
+			passed = passed && std::equal(expected.begin(), expected.end(), workspace.GetDistances())
+				&& IsPathTree(graph, weights, source, workspace.GetDistances(), workspace.GetPreds());
+			VisitShortestPaths(graph, weights, source, workspace, SearchVisitor());
+			passed = passed && std::equal(expected.begin(), expected.end(), workspace.GetDistances());
+
+			for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+			{
+				int cost = ShortestRoute(graph, graph.GetData(source), graph.GetData(target), path);
+				passed = cost == expected[target] && (cost == INFINITE_DISTANCE ? path.empty()
+					: path.front() == source && path.back() == target && PathWeight(graph, weights, path) == cost);
+				cost = ShortestRouteOver(graph, source, target, workspace, path);
+				passed = passed && cost == expected[target] && (cost == INFINITE_DISTANCE || PathWeight(graph, weights, path) == cost);
+				passed = passed && FindRoute(graph, graph.GetData(source), graph.GetData(target)).distance == expected[target];
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks the case that once lost the source from
+*		   the path: b's only shortest path ends in a zero weight edge
+*		   from c, a higher index, and c is joined to a, b and d by
+*		   zero weight edges so every engine meets ties both ways.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if every engine gives a route from a
+*				 to b of 5 miles.
+************************************************************************/
+bool TestZeroWeightTies()
+{
+	TestGraph graph;
+	vector<int> distance, pred, path;
+
+	graph.Build({ "a", "b", "c", "d" }, { 2, 0, 2, 3 }, { 1, 2, 3, 1 }, { "x", "y", "z", "w" }, { 0, 5, 0, 0 });
+
+	bool passed = ShortestRoute(graph, string("a"), string("b"), path) == 5 && path.size() >= 3 && path.front() == 0
+		&& path.back() == 1 && PathWeight(graph, graph.GetWeights(), path) == 5;
+	RouteResult<string> route = FindRoute(graph, string("a"), string("b"));
+	passed = passed && route.distance == 5 && !route.stops.empty() && route.stops.front() == "a" && route.stops.back() == "b";
+	ShortestPathsWith<BinaryHeap<int>>(graph, 0, distance, pred);
+	passed = passed && pred[1] != NO_VERTEX && IsPathTree(graph, graph.GetWeights(), 0, distance.data(), pred.data());
+	ShortestPathsWith<RadixHeap<int>>(graph, 0, distance, pred);
+	passed = passed && pred[1] != NO_VERTEX && IsPathTree(graph, graph.GetWeights(), 0, distance.data(), pred.data());
+	for (int threads = 1; threads <= 4; threads++)
+	{
+		DeltaStepping(graph, 0, 1, threads, distance, pred);
+		passed = passed && pred[1] != NO_VERTEX && IsPathTree(graph, graph.GetWeights(), 0, distance.data(), pred.data());
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks the visitor hooks from every source. A
+*		   lambda visitor whose Finish stops at target must have settled
+*		   it at ShortestRouteOver's distance and finished nothing after
+*		   it; an ExamineEdge that skips random edges must give the
+*		   distances of a MaskedGraph over the same edges. Breadth first
+*		   must discover each vertex once at its brute force hop count,
+*		   in order of hops, and finish in that order; depth first must
+*		   discover each vertex once at the depth of the walk so far,
+*		   finish the vertex it last discovered first, and reach the
+*		   same vertices, none at fewer hops than breadth first.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestVisitors()
+{
+	unsigned long long state = 40;
+	bool passed = true;
+	SearchWorkspace workspace, other;
+	vector<int> path;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		const int * weights = graph.GetWeights();
+		const int SIZE = graph.GetVertexCount();
+		vector<int> unit(graph.GetEdgeCount(), 1);
+		Bitmap mask(graph.GetEdgeCount());
+		for (int edge = 0; edge < graph.GetEdgeCount(); edge++)
+		{
+			if (NextRandom(state, 3) == 0)
+			{
+				mask.Set(edge);
+			}
+		}
+		MaskedGraph<string, string> masked(graph, mask);
+
+		for (int source = 0; source < SIZE && passed; source++)
+		{
+			//************************** Stop at target **********************************
+			for (int target = 0; target < SIZE && passed; target++)
+			{
+				int settled = INFINITE_DISTANCE;
+				bool stopped = false;
+				VisitShortestPaths(graph, weights, source, workspace, MakeVisitor(IgnoreEvent(), IgnoreEvent(), IgnoreEvent(),
+					[&](int vertex, int cost)
+				{
+					passed = passed && !stopped;
+					stopped = vertex == target;
+					settled = stopped ? cost : settled;
+					return !stopped;
+				}));
+				passed = passed && settled == ShortestRouteOver(graph, source, target, other, path);
+			}
+
+			//************************** Skip edges **********************************
+			VisitShortestPaths(graph, weights, source, workspace, MakeVisitor(IgnoreEvent(),
+				[&](int, int edge) { return !mask.Test(edge); }, IgnoreEvent(), IgnoreEvent()));
+			vector<int> skipped(workspace.GetDistances(), workspace.GetDistances() + SIZE);
+			for (int target = 0; target < SIZE && passed; target++)
+			{
+				passed = skipped[target] == ShortestRouteOver(masked, source, target, other, path);
+			}
+
+			//************************** Breadth and depth first **********************************
+			vector<int> hops = BruteDistances(graph, unit.data(), source);
+			vector<int> order, finished, stack;
+			vector<int> depth(SIZE, INFINITE_DISTANCE), walked(SIZE, INFINITE_DISTANCE);
+			auto IsTreeEdge = [&](int from, int edge, int to, int cost, const vector<int> & at)
+			{
+				return edge >= graph.GetEdgeBegin(from) && edge < graph.GetEdgeEnd(from) && graph.GetTarget(edge) == to
+					&& at[to] == INFINITE_DISTANCE && cost == at[from] + 1;
+			};
+			VisitBreadthFirst(graph, source, MakeVisitor(
+				[&](int vertex, int cost)
+			{
+				passed = passed && depth[vertex] == INFINITE_DISTANCE && (order.empty() || cost >= depth[order.back()]);
+				depth[vertex] = cost;
+				order.push_back(vertex);
+			},
+				IgnoreEvent(),
+				[&](int from, int edge, int to, int cost) { passed = passed && IsTreeEdge(from, edge, to, cost, depth); },
+				[&](int vertex, int cost)
+			{
+				passed = passed && cost == depth[vertex];
+				finished.push_back(vertex);
+			}));
+			passed = passed && depth == hops && finished == order && order.front() == source;
+
+			VisitDepthFirst(graph, source, MakeVisitor(
+				[&](int vertex, int cost)
+			{
+				passed = passed && walked[vertex] == INFINITE_DISTANCE && cost == static_cast<int>(stack.size());
+				walked[vertex] = cost;
+				stack.push_back(vertex);
+			},
+				IgnoreEvent(),
+				[&](int from, int edge, int to, int cost)
+			{
+				passed = passed && !stack.empty() && stack.back() == from && IsTreeEdge(from, edge, to, cost, walked);
+			},
+				[&](int vertex, int cost)
+			{
+				passed = passed && !stack.empty() && stack.back() == vertex && cost == walked[vertex];
+				stack.pop_back();
+			}));
+			passed = passed && stack.empty();
+			for (int v = 0; v < SIZE && passed; v++)
+			{
+				passed = (walked[v] == INFINITE_DISTANCE) == (hops[v] == INFINITE_DISTANCE) && walked[v] >= hops[v];
+			}
+		}
+	}
+	return passed;
+}
+
+#ifdef RELAX_X86
+/**********************************************************************
+* Purpose: This function checks RelaxEdgesAvx2 against RelaxEdgesScalar
+*		   on hubs of 8 to 40 edges, starting anywhere in the edge
+*		   arrays so groups of 8 fall unaligned and leave a tail. The
+*		   edges go to only a few targets, so one group of 8 often
+*		   holds the same target more than once, and some targets
+*		   start at INFINITE_DISTANCE.
+*
+* Precondition:	CpuHasAvx2()
+*
+* Postcondition: true is returned if both give the same improved list
+*				 and distances.
+************************************************************************/
+bool TestRelaxKernels()
+{
+	const int TARGETS = 12;
+	const int EDGES = 64;
+	unsigned long long state = 30;
+	bool passed = true;
+
+	for (int n = 0; n < TEST_NETWORKS * 10 && passed; n++)
+	{
+		vector<int> targets(EDGES), weights(EDGES);
+		vector<int> scalarDistance(TARGETS), avxDistance;
+		vector<int> scalarImproved(EDGES), avxImproved(EDGES);
+		for (int edge = 0; edge < EDGES; edge++)
+		{
+			targets[edge] = static_cast<int>(NextRandom(state, n % 2 == 0 ? 3 : TARGETS));
+			weights[edge] = static_cast<int>(NextRandom(state, 20));
+		}
+		for (int v = 0; v < TARGETS; v++)
+		{
+			scalarDistance[v] = NextRandom(state, 3) == 0 ? INFINITE_DISTANCE : static_cast<int>(NextRandom(state, 40));
+		}
+		avxDistance = scalarDistance;
+		int begin = static_cast<int>(NextRandom(state, EDGES - 40 + 1));
+		int end = begin + 8 + static_cast<int>(NextRandom(state, 33));
+		int base = static_cast<int>(NextRandom(state, 30));
+
+		int scalarCount = RelaxEdgesScalar(targets.data(), weights.data(), begin, end, base, scalarDistance.data(),
+			scalarImproved.data());
+		int avxCount = RelaxEdgesAvx2(targets.data(), weights.data(), begin, end, base, avxDistance.data(), avxImproved.data());
+		passed = scalarCount == avxCount && scalarDistance == avxDistance
+			&& std::equal(scalarImproved.begin(), scalarImproved.begin() + scalarCount, avxImproved.begin());
+	}
+	return passed;
+}
+#endif
+
+/**********************************************************************
+* Purpose: This function checks the parallel engines on road networks
+*		   big enough that their phases are split across threads, which
+*		   the small random networks never are: every index of a
+*		   WorkerPool loop runs once, on a worker the pool has, delta
+*		   stepping matches ShortestPaths, and the parallel BFS gives
+*		   the same hops at every thread count.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestParallel()
+{
+	const int SIZE = 3000;
+	bool passed = true;
+
+	for (int threads = 1; threads <= 4 && passed; threads++)
+	{
+		WorkerPool pool(threads);
+		for (int round = 0; round < 50 && passed; round++)
+		{
+			int count = round * round * 7;
+			vector<atomic<int>> calls(count);
+			atomic<int> badWorker(0);
+			for (int i = 0; i < count; i++)
+			{
+				calls[i].store(0);
+			}
+			pool.For(0, count, [&](int worker, int i)
+			{
+				calls[i]++;
+				if (worker < 0 || worker >= threads)
+				{
+					badWorker++;
+				}
+			});
+			passed = badWorker.load() == 0;
+			for (int i = 0; i < count && passed; i++)
+			{
+				passed = calls[i].load() == 1;
+			}
+		}
+	}
+
+	for (unsigned seed = 1; seed <= 2 && passed; seed++)
+	{
+		TestGraph graph;
+		vector<int> expected, expectedPred, expectedHops, distance, pred, hops, parents;
+		BuildRoadGraph(seed == 1 ? GeneratePlanarNetwork(SIZE, seed) : GenerateGridNetwork(SIZE, seed), graph);
+		ShortestPaths(graph, 0, expected, expectedPred);
+		ParallelBreadthFirst(graph, 0, 1, expectedHops, parents);
+
+		for (int threads = 1; threads <= 4 && passed; threads++)
+		{
+			DeltaStepping(graph, 0, SuggestDelta(graph), threads, distance, pred);
+			passed = distance == expected && IsPathTree(graph, graph.GetWeights(), 0, distance.data(), pred.data());
+			ParallelBreadthFirst(graph, 0, threads, hops, parents);
+			passed = passed && hops == expectedHops;
+			for (int v = 0; v < graph.GetVertexCount() && passed; v++)
+			{
+				passed = parents[v] == NO_VERTEX ? v == 0 || hops[v] == INFINITE_DISTANCE : hops[parents[v]] + 1 == hops[v];
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks isochrones, alone and as a batch,
+*		   against the brute force distances within a budget.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestIsochrones()
+{
+	unsigned long long state = 36;
+	bool passed = true;
+	SearchWorkspace workspace;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		int budget = static_cast<int>(NextRandom(state, 8));
+		vector<int> sources;
+		vector<vector<ReachedVertex>> batch;
+
+		for (int source = 0; source < graph.GetVertexCount(); source++)
+		{
+			sources.push_back(source);
+		}
+		ReachableWithinBatch(graph, graph.GetWeights(), sources, budget, 3, batch);
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(graph, graph.GetWeights(), source);
+			vector<ReachedVertex> reached;
+			long long inside = 0;
+
+			ReachableWithin(graph, graph.GetWeights(), source, budget, workspace, reached);
+			for (size_t i = 0; i < expected.size(); i++)
+			{
+				inside += expected[i] <= budget ? 1 : 0;
+			}
+			passed = static_cast<long long>(reached.size()) == inside && batch[source].size() == reached.size();
+			for (size_t i = 0; i < reached.size() && passed; i++)
+			{
+				passed = expected[reached[i].vertex] == reached[i].cost && batch[source][i].vertex == reached[i].vertex
+					&& batch[source][i].cost == reached[i].cost && (i == 0 || reached[i - 1].cost <= reached[i].cost);
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks connected components, bitmap
+*		   reachability and the parallel breadth first search against
+*		   brute force.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestComponents()
+{
+	unsigned long long state = 38;
+	bool passed = true;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		vector<int> component, hops, parents;
+		vector<int> ones(graph.GetEdgeCount(), 1);
+		Bitmap reachable;
+		int components = ConnectedComponents(graph, 1 + NextRandom(state, 4), component);
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(graph, graph.GetWeights(), source);
+			vector<int> expectedHops = BruteDistances(graph, ones.data(), source);
+
+			ReachableFrom(graph, source, reachable);
+			ParallelBreadthFirst(graph, source, 1 + NextRandom(state, 4), hops, parents);
+			passed = hops == expectedHops;
+			for (int v = 0; v < graph.GetVertexCount() && passed; v++)
+			{
+				bool reached = expected[v] != INFINITE_DISTANCE;
+				passed = reachable.Test(v) == reached && (component[v] == component[source]) == reached && component[v] < components
+					&& (parents[v] == NO_VERTEX ? v == source || !reached : hops[parents[v]] + 1 == hops[v]);
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks that Yen's k shortest routes and the
+*		   penalty method start with the shortest route, and that every
+*		   route they give is loopless and costs what its edges do.
+*		   Yen's routes must also be different edges and cost the same
+*		   as the cheapest k simple paths brute force finds, counting
+*		   parallel roads as different paths.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all hold.
+************************************************************************/
+bool TestAlternatives()
+{
+	unsigned long long state = 37;
+	bool passed = true;
+	SearchWorkspace workspace;
+	vector<AlternativeRoute> routes;
+
+	//Each route is loopless, follows its edges and costs what they weigh
+	auto Valid = [](const TestGraph & graph, const AlternativeRoute & route)
+	{
+		vector<int> stops(route.vertices);
+		std::sort(stops.begin(), stops.end());
+		bool valid = std::unique(stops.begin(), stops.end()) == stops.end() && route.edges.size() + 1 == route.vertices.size();
+		int cost = 0;
+		for (size_t i = 0; i < route.edges.size() && valid; i++)
+		{
+			valid = graph.GetTarget(route.edges[i]) == route.vertices[i + 1] && route.edges[i] >= graph.GetEdgeBegin(route.vertices[i])
+				&& route.edges[i] < graph.GetEdgeEnd(route.vertices[i]);
+			cost += graph.GetWeight(route.edges[i]);
+		}
+		return valid && cost == route.cost;
+	};
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(graph, graph.GetWeights(), source);
+			for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+			{
+				vector<int> cheapest;
+				vector<char> visited(graph.GetVertexCount(), 0);
+				BruteRouteCosts(graph, source, target, 0, visited, cheapest);
+				std::sort(cheapest.begin(), cheapest.end());
+				cheapest.resize(std::min<size_t>(cheapest.size(), 4));
+
+				KShortestRoutes(graph, graph.GetWeights(), source, target, 4, workspace, routes);
+				passed = routes.empty() ? expected[target] == INFINITE_DISTANCE : routes[0].cost == expected[target];
+				passed = passed && routes.size() == cheapest.size();
+				for (size_t r = 0; r < routes.size() && passed; r++)
+				{
+					passed = Valid(graph, routes[r]) && routes[r].cost == cheapest[r];
+					for (size_t other = 0; other < r && passed; other++)
+					{
+						passed = routes[other].edges != routes[r].edges;
+					}
+				}
+
+				AlternativesByPenalty(graph, graph.GetWeights(), source, target, 4, 0.5, 1.5, workspace, routes);
+				passed = passed && (routes.empty() ? expected[target] == INFINITE_DISTANCE : routes[0].cost == expected[target]);
+				for (size_t r = 0; r < routes.size() && passed; r++)
+				{
+					passed = Valid(graph, routes[r]);
+				}
+			}
+		}
+	}
+
+	//Two free roads from a to b: the penalty must move off the first one
+	TestGraph free;
+	free.Build({ "a", "b" }, { 0, 0 }, { 1, 1 }, { "x", "y" }, { 0, 0 });
+	AlternativesByPenalty(free, free.GetWeights(), 0, 1, 2, 0.5, 1.5, workspace, routes);
+	passed = passed && routes.size() == 2 && routes[0].cost == 0 && routes[1].cost == 0;
+
+	//A place with no roads at all
+	RoadNetwork empty;
+	empty.count = 1;
+	TestGraph lone;
+	BuildRoadGraph(empty, lone);
+	KShortestRoutes(lone, lone.GetWeights(), 0, 0, 2, workspace, routes);
+	passed = passed && routes.size() == 1 && routes[0].cost == 0;
+	AlternativesByPenalty(lone, lone.GetWeights(), 0, 0, 2, 0.5, 1.5, workspace, routes);
+	passed = passed && routes.size() == 1 && routes[0].cost == 0;
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks ALT routes with landmarks picked both
+*		   ways against brute force.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestLandmarks()
+{
+	unsigned long long state = 43;
+	bool passed = true;
+	SearchWorkspace workspace;
+	LandmarkTable landmarks;
+	vector<int> path;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		landmarks.Build(graph, 1 + NextRandom(state, 3), n % 2 == 0 ? LANDMARKS_FARTHEST : LANDMARKS_AVOID, n);
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(graph, graph.GetWeights(), source);
+			for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+			{
+				int cost = landmarks.Route(graph, source, target, workspace, path);
+				passed = cost == expected[target] && (cost == INFINITE_DISTANCE || PathWeight(graph, graph.GetWeights(), path) == cost);
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks a scenario against brute force on a
+*		   network built with the same changes, after each of them: one
+*		   road closed, two roads added, one pair of places given a new
+*		   weight (which opens them again if that road was closed), a
+*		   road shortened or lengthened with AdjustRoad (shortening
+*		   stops at 0) and the first added road taken out again.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestScenarios()
+{
+	unsigned long long state = 42;
+	bool passed = true;
+	SearchWorkspace workspace;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		RoadNetwork network = RandomNetwork(state, TEST_PLACES);
+		vector<char> open(network.from.size(), 1);	//Segments of network the scenario still has
+		TestGraph graph;
+		BuildRoadGraph(network, graph);
+		ScenarioGraph<string, string> scenario(graph);
+
+		//Whether the scenario gives every source the distances of network built with the open segments
+		auto Agrees = [&]()
+		{
+			RoadNetwork changed(network);
+			TestGraph expected;
+			bool same = true;
+			changed.from.clear();
+			changed.to.clear();
+			changed.road.clear();
+			changed.miles.clear();
+			for (size_t i = 0; i < network.from.size(); i++)
+			{
+				if (open[i])
+				{
+					changed.from.push_back(network.from[i]);
+					changed.to.push_back(network.to[i]);
+					changed.road.push_back(network.road[i]);
+					changed.miles.push_back(network.miles[i]);
+				}
+			}
+			BuildRoadGraph(changed, expected);
+			for (int source = 0; source < graph.GetVertexCount() && same; source++)
+			{
+				vector<int> distance = BruteDistances(expected, expected.GetWeights(), source);
+				ShortestPathsOver(scenario, source, workspace);
+				same = std::equal(distance.begin(), distance.end(), workspace.GetDistances());
+			}
+			return same;
+		};
+		//Gives every segment between a and b, either way, miles and opens it, or closes it
+		auto ChangeBetween = [&](int a, int b, int miles, bool keep)
+		{
+			for (size_t i = 0; i < network.from.size(); i++)
+			{
+				if ((network.from[i] == a && network.to[i] == b) || (network.from[i] == b && network.to[i] == a))
+				{
+					network.miles[i] = keep ? miles : network.miles[i];
+					open[i] = keep ? 1 : 0;
+				}
+			}
+		};
+
+		int road = static_cast<int>(NextRandom(state, 4));
+		scenario.RemoveRoad(network.roads[road]);
+		for (size_t i = 0; i < network.from.size(); i++)
+		{
+			open[i] = network.road[i] != road;
+		}
+		passed = Agrees();
+
+		size_t firstAdded = network.from.size();
+		for (int added = 0; added < 2 && passed; added++)
+		{
+			network.from.push_back(static_cast<int>(NextRandom(state, network.count)));
+			network.to.push_back(static_cast<int>(NextRandom(state, network.count)));
+			network.road.push_back(static_cast<int>(NextRandom(state, 4)));
+			network.miles.push_back(static_cast<int>(NextRandom(state, 5)));
+			open.push_back(1);
+			scenario.AddEdge(network.from.back(), network.to.back(), network.roads[network.road.back()], network.miles.back());
+			passed = Agrees();
+		}
+
+		size_t reweighed = NextRandom(state, network.from.size());
+		int miles = static_cast<int>(NextRandom(state, 5));
+		scenario.SetWeight(network.from[reweighed], network.to[reweighed], miles);
+		ChangeBetween(network.from[reweighed], network.to[reweighed], miles, true);
+		passed = passed && Agrees();
+
+		int adjusted = static_cast<int>(NextRandom(state, 4));
+		int change = static_cast<int>(NextRandom(state, 8)) - 5;	//-5 to 2, so 0 to 4 miles often goes below 0
+		scenario.AdjustRoad(network.roads[adjusted], change);
+		for (size_t i = 0; i < network.from.size(); i++)
+		{
+			if (open[i] && network.road[i] == adjusted)
+			{
+				network.miles[i] = std::max(0, network.miles[i] + change);
+			}
+		}
+		passed = passed && Agrees();
+
+		scenario.RemoveEdge(network.from[firstAdded], network.to[firstAdded]);
+		ChangeBetween(network.from[firstAdded], network.to[firstAdded], 0, false);
+		passed = passed && Agrees();
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks CellOverlay routes on a two level
+*		   partition against brute force.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestOverlay()
+{
+	unsigned long long state = 44;
+	bool passed = true;
+	SearchWorkspace forward, backward;
+	vector<int> path;
+
+	for (int n = 0; n < TEST_NETWORKS / 4 && passed; n++)
+	{
+		TestGraph graph;
+		MultilevelPartition partition;
+		CellOverlay overlay;
+		BuildRoadGraph(RandomNetwork(state, 4 * TEST_PLACES), graph);
+		partition.Build(graph, { 4, 16 });
+		overlay.Build(graph, partition);
+		overlay.Customize(graph, graph.GetWeights(), 2);
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(graph, graph.GetWeights(), source);
+			for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+			{
+				int cost = overlay.Route(graph, graph.GetWeights(), source, target, forward, backward, path);
+				passed = cost == expected[target] && (cost == INFINITE_DISTANCE || PathWeight(graph, graph.GetWeights(), path) == cost);
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks the turn-aware route: with no turns set
+*		   it is the shortest route, and with turns and U-turn rules set
+*		   it costs what a search over edges finds and its edges add up
+*		   to that cost.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all hold.
+************************************************************************/
+bool TestTurns()
+{
+	unsigned long long state = 45;
+	bool passed = true;
+	SearchWorkspace workspace;
+	vector<int> path, edges;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		TurnTable plain, turns;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		plain.Build(graph);
+		turns.Build(graph);
+		turns.SetUTurnCost(n % 3 == 0 ? TURN_FORBIDDEN : n % 3);	//Every U-turn rule, so every vertex can have states per edge
+		for (int v = 0; v < graph.GetVertexCount(); v++)
+		{
+			for (int in = graph.GetEdgeBegin(v); in != graph.GetEdgeEnd(v); ++in)
+			{
+				for (int out = graph.GetEdgeBegin(v); out != graph.GetEdgeEnd(v); ++out)
+				{
+					if (graph.GetEdgeData(in) != graph.GetEdgeData(out))
+					{
+						turns.SetTurn(graph, v, graph.GetEdgeData(in), graph.GetEdgeData(out), NextRandom(state, 4) == 0 ? TURN_FORBIDDEN : 1);
+					}
+				}
+			}
+		}
+		turns.Compile();
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(graph, graph.GetWeights(), source);
+			for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+			{
+				passed = plain.Route(graph, graph.GetWeights(), source, target, workspace, path, edges) == expected[target];
+
+				int cost = turns.Route(graph, graph.GetWeights(), source, target, workspace, path, edges);
+				passed = passed && cost == BruteTurnCost(graph, turns, source, target)
+					&& (cost == INFINITE_DISTANCE ? edges.empty() : TurnRouteCost(graph, turns, source, edges) == cost
+						&& path.back() == target);
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks the Pareto front against every simple
+*		   path. Besides miles and miles off the interstates, one
+*		   criterion gives each edge its own random cost, so a road
+*		   costs something different each way, and every other network
+*		   weighs all three.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestPareto()
+{
+	unsigned long long state = 46;
+	bool passed = true;
+	SearchWorkspace workspace;
+	vector<ParetoRoute> front;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		vector<int> off = MilesOffInterstates(graph);
+		vector<int> oneWay(graph.GetEdgeCount());
+		for (int edge = 0; edge < graph.GetEdgeCount(); edge++)
+		{
+			oneWay[edge] = static_cast<int>(NextRandom(state, 5));
+		}
+		vector<const int *> criteria = { graph.GetWeights(), oneWay.data() };
+		if (n % 2 == 1)
+		{
+			criteria.push_back(off.data());
+		}
+		const int COUNT = static_cast<int>(criteria.size());
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+			{
+				vector<vector<int>> expected;
+				vector<int> cost(COUNT, 0);
+				vector<char> visited(graph.GetVertexCount(), 0);
+				BruteParetoFront(graph, criteria, source, target, cost, visited, expected);
+				std::sort(expected.begin(), expected.end());
+
+				ParetoRoutes(graph, criteria, source, target, workspace, front);
+				passed = front.size() == expected.size();
+				for (size_t r = 0; r < front.size() && passed; r++)
+				{
+					passed = front[r].vertices.front() == source && front[r].vertices.back() == target
+						&& front[r].edges.size() + 1 == front[r].vertices.size();
+					for (int c = 0; c < COUNT && passed; c++)
+					{
+						int total = 0;
+						for (size_t i = 0; i < front[r].edges.size() && passed; i++)
+						{
+							int edge = front[r].edges[i];
+							passed = edge >= graph.GetEdgeBegin(front[r].vertices[i]) && edge < graph.GetEdgeEnd(front[r].vertices[i])
+								&& graph.GetTarget(edge) == front[r].vertices[i + 1];
+							total += criteria[c][edge];
+						}
+						passed = passed && total == front[r].cost[c] && total == expected[r][c];
+					}
+				}
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks routes over a road rule mask against
+*		   brute force on the network built without the roads the rules
+*		   block, for rules by class, by a single class and by name.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestRoadRules()
+{
+	unsigned long long state = 47;
+	bool passed = true;
+	SearchWorkspace workspace;
+	vector<int> path;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		RoadNetwork network = RandomNetwork(state, TEST_PLACES);
+		RoadNetwork open(network);
+		TestGraph graph, without;
+		RoadRules<string> rules;
+		Bitmap mask;
+		int pick = static_cast<int>(NextRandom(state, 4));
+
+		if (n % 3 == 0)
+		{
+			rules.AvoidClass(static_cast<RoadClass>(pick % ROAD_CLASS_COUNT));
+		}
+		else if (n % 3 == 1)
+		{
+			rules.OnlyClass(static_cast<RoadClass>(pick % ROAD_CLASS_COUNT));
+		}
+		else
+		{
+			rules.AvoidRoad(network.roads[pick]);
+		}
+		open.from.clear();
+		open.to.clear();
+		open.road.clear();
+		open.miles.clear();
+		for (size_t i = 0; i < network.from.size(); i++)
+		{
+			if (!rules.IsBlocked(network.roads[network.road[i]]))
+			{
+				open.from.push_back(network.from[i]);
+				open.to.push_back(network.to[i]);
+				open.road.push_back(network.road[i]);
+				open.miles.push_back(network.miles[i]);
+			}
+		}
+		BuildRoadGraph(network, graph);
+		BuildRoadGraph(open, without);
+		rules.Compile(graph, mask);
+		MaskedGraph<string, string> masked(graph, mask);
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(without, without.GetWeights(), source);
+			for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+			{
+				int cost = ShortestRouteOver(masked, source, target, workspace, path);
+				passed = cost == expected[target] && (cost == INFINITE_DISTANCE || masked.PathWeight(path, nullptr, nullptr) == cost);
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks routes by vehicle profile against brute
+*		   force on each profile's weights.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestProfiles()
+{
+	unsigned long long state = 48;
+	bool passed = true;
+	SearchWorkspace workspace;
+	vector<int> path, edges;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		VehicleProfiles profiles;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		profiles.AddDefaultProfiles(graph);
+
+		for (int profile = 0; profile < profiles.GetProfileCount() && passed; profile++)
+		{
+			const int * weights = profiles.GetWeights(profile);
+			for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+			{
+				vector<int> expected = BruteDistances(graph, weights, source);
+				for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+				{
+					int cost = profiles.Route(graph, profile, source, target, workspace, path, edges);
+					passed = cost == expected[target] && (cost == INFINITE_DISTANCE || PathWeight(graph, weights, path) == cost);
+				}
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks routes read from an ExternalGraph file
+*		   against brute force.
+*
+* Precondition:	The working directory can be written to.
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestExternal()
+{
+	const string FILE_NAME = "tests_external.graph";
+	unsigned long long state = 49;
+	bool passed = true;
+	SearchWorkspace workspace;
+	vector<int> path;
+
+	for (int n = 0; n < TEST_NETWORKS / 4 && passed; n++)
+	{
+		TestGraph graph;
+		ExternalGraph external;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		ExternalGraph::Write(graph, graph.GetWeights(), vector<int>(), FILE_NAME);
+		external.Open(FILE_NAME);
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(graph, graph.GetWeights(), source);
+			for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+			{
+				int cost = external.Route(external.GetFileIndex(source), external.GetFileIndex(target), workspace, path);
+				passed = cost == expected[target];
+			}
+		}
+		external.Close();
+	}
+	std::remove(FILE_NAME.c_str());
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks routes over a CompressedGraph with exact
+*		   weights against brute force.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestCompressed()
+{
+	unsigned long long state = 50;
+	bool passed = true;
+	SearchWorkspace workspace;
+	vector<int> path;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		TestGraph graph;
+		CompressedGraph compressed;
+		BuildRoadGraph(RandomNetwork(state, TEST_PLACES), graph);
+		compressed.Build(graph, graph.GetWeights());
+
+		for (int source = 0; source < graph.GetVertexCount() && passed; source++)
+		{
+			vector<int> expected = BruteDistances(graph, graph.GetWeights(), source);
+			for (int target = 0; target < graph.GetVertexCount() && passed; target++)
+			{
+				int cost = ShortestRouteOver(compressed, source, target, workspace, path);
+				passed = cost == expected[target] && (cost == INFINITE_DISTANCE || PathWeight(graph, graph.GetWeights(), path) == cost);
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks that renumbering a graph with each order
+*		   of Reordering.h (and a random one) keeps every distance, and
+*		   that an order saved with SaveOrder() loads back the same,
+*		   for graphs keyed by name and by place id.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestReordering()
+{
+	const string FILE_NAME = "tests_order.txt";
+	unsigned long long state = 51;
+	bool passed = true;
+
+	for (int n = 0; n < TEST_NETWORKS && passed; n++)
+	{
+		RoadNetwork network = RandomNetwork(state, TEST_PLACES);
+		TestGraph graph;
+		CompactGraph<uint32_t, RoadClass> places;
+		BuildRoadGraph(network, graph);
+		BuildRoadGraph(network, places);
+		const int SIZE = graph.GetVertexCount();
+
+		vector<double> x(SIZE), y(SIZE);
+		vector<int> shuffle(SIZE);
+		for (int i = 0; i < SIZE; i++)
+		{
+			x[i] = NextUnit(state);
+			y[i] = NextUnit(state);
+			shuffle[i] = i;
+		}
+		for (int i = SIZE - 1; i > 0; i--)
+		{
+			std::swap(shuffle[i], shuffle[NextRandom(state, static_cast<unsigned>(i + 1))]);
+		}
+		vector<vector<int>> orders = { BreadthFirstOrder(graph), CuthillMcKeeOrder(graph), HilbertOrder(x, y), shuffle };
+
+		for (size_t o = 0; o < orders.size() && passed; o++)
+		{
+			const vector<int> & order = orders[o];
+			TestGraph reordered(graph);
+			vector<int> position(SIZE);
+			vector<int> distance, pred;
+			reordered.Reorder(order);
+			for (int i = 0; i < SIZE; i++)
+			{
+				position[order[i]] = i;
+				passed = passed && reordered.GetData(i) == graph.GetData(order[i]);
+			}
+
+			for (int source = 0; source < SIZE && passed; source++)
+			{
+				vector<int> expected = BruteDistances(graph, graph.GetWeights(), source);
+				ShortestPaths(reordered, position[source], distance, pred);
+				for (int v = 0; v < SIZE && passed; v++)
+				{
+					passed = distance[position[v]] == expected[v];
+				}
+			}
+
+			SaveOrder(reordered, FILE_NAME);
+			passed = passed && LoadOrder(graph, FILE_NAME) == order;
+			CompactGraph<uint32_t, RoadClass> reorderedPlaces(places);
+			reorderedPlaces.Reorder(order);
+			SaveOrder(reorderedPlaces, FILE_NAME);
+			passed = passed && LoadOrder(places, FILE_NAME) == order;
+		}
+	}
+	std::remove(FILE_NAME.c_str());
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks that a text road file keeps zero mile
+*		   segments, and that bad or negative miles are an Exception
+*		   naming the line instead of a standard library one.
+*
+* Precondition:	N/A
+*
+* Postcondition: true is returned if every file reads as expected.
+************************************************************************/
+bool TestRoadFiles()
+{
+	const string FILE_NAME = "tests_roads.txt";
+	const string BAD[] = { "x", "", "3 miles", "-3", "99999999999", "1.5" };
+	bool passed = true;
+
+	{
+		ofstream out(FILE_NAME.c_str());
+		out << "a,b,I-5,0\nb,c,Hwy 97,7\n";
+	}
+	RoadNetwork network = ReadRoadFile(FILE_NAME);
+	passed = network.count == 3 && network.miles == vector<int>({ 0, 7 });
+
+	for (size_t i = 0; i < sizeof(BAD) / sizeof(BAD[0]) && passed; i++)
+	{
+		{
+			ofstream out(FILE_NAME.c_str());
+			out << "a,b,I-5,4\na,c,I-5," << BAD[i] << "\n";
+		}
+		passed = false;
+		try
+		{
+			ReadRoadFile(FILE_NAME);
+		}
+		catch (Exception & ex)
+		{
+			passed = string(ex.GetMessage()).compare(0, 8, "Line 2: ") == 0;
+		}
+	}
+	std::remove(FILE_NAME.c_str());
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks that new.txt routed on the integer id
+*		   graph, with names only in a NameTable, gives every pair of
+*		   places the same route as the graph keyed by name: through
+*		   Dijkstra() and through FindRoute() on a CompactGraph.
+*
+* Precondition:	new.txt is in the working directory.
+*
+* Postcondition: true is returned if every route matches.
+************************************************************************/
+bool TestPlaceIds()
+{
+	Graph<string, string> graph;
+	Graph<uint32_t, RoadClass> places;
+	NameTable names;
+	string edgeInfo[47][4];
+	bool passed = true;
+
+	ReadLine(edgeInfo);
+	PopulateGraph(edgeInfo, graph);
+	PopulateGraph(edgeInfo, names, places);
+	CompactGraph<string, string> compact(graph);
+	CompactGraph<uint32_t, RoadClass> compactPlaces(places);
+	passed = names.GetCount() == graph.GetCount() && places.GetCount() == graph.GetCount();
+
+	for (int from = 0; from < names.GetCount() && passed; from++)
+	{
+		for (int to = 0; to < names.GetCount() && passed; to++)
+		{
+			const string & start = names.GetName(from);
+			const string & end = names.GetName(to);
+			RouteResult<string> expected = FindRoute(compact, start, end);
+			RouteResult<string> found = FindNamedRoute(compactPlaces, names, start, end);
+			passed = found.distance == expected.distance && found.stops == expected.stops && found.path == expected.path
+				&& found.minutes == expected.minutes;
+
+			if (from != to && passed)
+			{
+				expected = DijkstraRoute(graph, start, end);
+				found = NameRoute(DijkstraRoute(places, names.GetId(start), names.GetId(end)), names);
+				passed = found.distance == expected.distance && found.stops == expected.stops && found.minutes == expected.minutes
+					&& found.distance == FindRoute(compact, start, end).distance;
+			}
+		}
+	}
+	return passed;
+}
+
+/**********************************************************************
+* Purpose: This function checks the Graph copy constructor, operator=
+*		   over a graph that already has vertices, and both moves on
+*		   the roads in new.txt. Every copy must hold the same
+*		   vertices in the same order with the same edges, pointing at
+*		   its own vertices, and give the same Dijkstra route between
+*		   every pair of places; an edge added to a copy must not show
+*		   up in the original, and a graph moved from must be empty.
+*
+* Precondition:	new.txt is in the working directory.
+*
+* Postcondition: true is returned if they all agree.
+************************************************************************/
+bool TestGraphCopies()
+{
+	Graph<string, string> graph;
+	string edgeInfo[47][4];
+	vector<string> places;
+	vector<RouteResult<string>> routes;		//Dijkstra's route between each pair of places, from graph
+
+	ReadLine(edgeInfo);
+	PopulateGraph(edgeInfo, graph);
+	for (list<Vertex<string, string>>::iterator viter = graph.GetVertices().begin(); viter != graph.GetVertices().end(); ++viter)
+	{
+		places.push_back(viter->GetData());
+	}
+	for (size_t from = 0; from < places.size(); from++)
+	{
+		for (size_t to = 0; to < places.size(); to++)
+		{
+			routes.push_back(from == to ? RouteResult<string>() : DijkstraRoute(graph, places[from], places[to]));
+		}
+	}
+
+	//Whether copy matches graph vertex by vertex and edge by edge, and routes the same
+	auto Matches = [&](Graph<string, string> & copy)
+	{
+		list<Vertex<string, string>> & mine = copy.GetVertices();
+		list<Vertex<string, string>> & theirs = graph.GetVertices();
+		vector<const Vertex<string, string> *> owned;
+		bool same = copy.GetCount() == graph.GetCount() && mine.size() == theirs.size();
+		for (list<Vertex<string, string>>::iterator viter = mine.begin(); viter != mine.end(); ++viter)
+		{
+			owned.push_back(&(*viter));
+		}
+
+		list<Vertex<string, string>>::iterator other = theirs.begin();
+		for (list<Vertex<string, string>>::iterator viter = mine.begin(); viter != mine.end() && same; ++viter, ++other)
+		{
+			same = viter->GetData() == other->GetData() && viter->GetEdges().size() == other->GetEdges().size();
+			list<Edge<string, string>>::const_iterator theirEdge = other->GetEdges().begin();
+			for (list<Edge<string, string>>::const_iterator edge = viter->GetEdges().begin();
+				edge != viter->GetEdges().end() && same; ++edge, ++theirEdge)
+			{
+				same = edge->GetData() == theirEdge->GetData() && edge->GetWeight() == theirEdge->GetWeight()
+					&& edge->GetDestination()->GetData() == theirEdge->GetDestination()->GetData()
+					&& std::find(owned.begin(), owned.end(), edge->GetDestination()) != owned.end();
+			}
+		}
+		for (size_t from = 0; from < places.size() && same; from++)
+		{
+			for (size_t to = 0; to < places.size() && same; to++)
+			{
+				if (from != to)
+				{
+					RouteResult<string> route = DijkstraRoute(copy, places[from], places[to]);
+					const RouteResult<string> & expected = routes[from * places.size() + to];
+					same = route.distance == expected.distance && route.stops == expected.stops && route.minutes == expected.minutes;
+				}
+			}
+		}
+		return same;
+	};
+
+	Graph<string, string> copied(graph);
+	bool passed = Matches(copied);
+	Graph<string, string> assigned;
+	assigned.InsertVertex("Nowhere");
+	assigned.InsertVertex("Elsewhere");
+	assigned.AddEdge("Nowhere", "Elsewhere", "Dirt Road", 7);
+	assigned = graph;
+	passed = passed && Matches(assigned);
+
+	size_t edges = graph.GetVertices().front().GetEdges().size();
+	copied.AddEdge(places[0], places[1], "Shortcut", 1);
+	passed = passed && graph.GetVertices().front().GetEdges().size() == edges
+		&& copied.GetVertices().front().GetEdges().size() == edges + 1;
+
+	Graph<string, string> moved(std::move(assigned));
+	passed = passed && assigned.IsEmpty() && assigned.GetCount() == 0 && Matches(moved);
+	Graph<string, string> moveAssigned;
+	moveAssigned.InsertVertex("Nowhere");
+	moveAssigned = std::move(moved);
+	passed = passed && moved.IsEmpty() && moved.GetCount() == 0 && Matches(moveAssigned);
+	return passed;
+}